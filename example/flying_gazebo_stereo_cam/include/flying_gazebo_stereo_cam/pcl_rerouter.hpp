@@ -15,13 +15,23 @@
  * on <http://www.gnu.org/licenses/>.
 */
 
+#include <mutex>
+#include <condition_variable>
 #include <ros/ros.h>
 #include <sensor_msgs/PointCloud2.h>
+#include <boost/function.hpp>
+
+#include "ig_active_reconstruction_ros/pointcloud_shm_ring.hpp"
 
 namespace ros_tools
 {
   /*! Class that listens on a pcl topic and reroutes what it receives to another pcl topic or to a service.
    * Current implementation forwards single packages on demand.
+   * 
+   * Instead of copying the pointcloud into the service request, it can be handed over without copies to a sink in the same
+   * process, or written to a shared memory ring buffer whose sequence number is then sent to the "<out_name>_shm" service.
+   * 
+   * The pointclouds are either processed by the waiting reroute call itself or, if an async spinner runs, by its threads.
    */
   class PclRerouter
   {
@@ -46,6 +56,18 @@ namespace ros_tools
      */
     bool rerouteOneToSrv();
     
+    /*! Sets a function within the same process to which rerouteOneToSrv hands the pointclouds directly, instead of calling
+     * the service. It returns whether the pointcloud was processed successfully.
+     */
+    void setSink( boost::function<bool(const sensor_msgs::PointCloud2ConstPtr&)> sink );
+    
+    /*! Lets rerouteOneToSrv write the pointclouds to a shared memory ring buffer and only send their sequence number to the
+     * "<out_name>_shm" service. Pointclouds that don't fit into the ring buffer are sent through the service as before.
+     * @param config Configuration of the ring buffer.
+     * @throws boost::interprocess::interprocess_exception if the shared memory segment can't be created.
+     */
+    void useSharedMemory( ros_tools::PointCloudShmRing::Config config );
+    
   protected:
     /*! Called for incoming pointclouds.
      */
@@ -57,11 +79,18 @@ namespace ros_tools
     ros::Publisher pcl_publisher_;
     ros::ServiceClient pcl_service_caller_;
     
+    std::mutex mutex_; //! Guards the rerouting state below, which is shared with the callback threads.
+    std::condition_variable rerouted_; //! Signals that a pointcloud has been rerouted.
+    
     bool forward_one_;
     bool has_published_one_;
     
     bool one_to_srv_;
     bool service_response_;
+    
+    boost::function<bool(const sensor_msgs::PointCloud2ConstPtr&)> sink_; //! In-process pointcloud sink, if set.
+    boost::shared_ptr<PointCloudShmRing> shm_ring_; //! Shared memory ring buffer, if used.
+    ros::ServiceClient pcl_shm_service_caller_;
   };
   
 }
\ No newline at end of file
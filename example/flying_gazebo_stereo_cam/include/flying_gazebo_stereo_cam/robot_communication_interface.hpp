@@ -68,6 +68,16 @@ namespace flying_gazebo_stereo_cam
     */
     virtual bool moveTo( View& target_view );
     
+    /*! Hands retrieved pointclouds directly to a sink within the same process (e.g. the world representation) instead
+     * of sending them through the output service.
+     */
+    void setPointcloudSink( boost::function<bool(const sensor_msgs::PointCloud2ConstPtr&)> sink );
+    
+    /*! Sends retrieved pointclouds through a shared memory ring buffer to a process on the same machine.
+     * @param config Configuration of the ring buffer.
+     */
+    void useSharedMemoryTransport( ros_tools::PointCloudShmRing::Config config );
+    
   private:
     std::shared_ptr<Controller> cam_controller_; //! For movements etc.
     ros_tools::PclRerouter pcl_rerouter_; //! Since the gazebo stereo camera outputs a continuous stream of data but we are only interested in on dataset at a particular time, data retrieval consists in rerouting one data packet to the correct output where it is processed further.
@@ -17,6 +17,10 @@
 
 #include "flying_gazebo_stereo_cam/pcl_rerouter.hpp"
 #include "ig_active_reconstruction_msgs/PclInput.h"
+#include "ig_active_reconstruction_msgs/PclShmInput.h"
+
+#include <boost/make_shared.hpp>
+#include <chrono>
 
 namespace ros_tools
 {
@@ -26,26 +30,32 @@ namespace ros_tools
   , forward_one_(false)
   , has_published_one_(false)
   , one_to_srv_(false)
+  , service_response_(false)
   {
     pcl_subscriber_ = nh_.subscribe( in_name,1, &PclRerouter::pclCallback, this );
     pcl_publisher_ = nh_.advertise<sensor_msgs::PointCloud2>(out_name, 1);
     pcl_service_caller_ = nh_.serviceClient<ig_active_reconstruction_msgs::PclInput>(out_name);
+    pcl_shm_service_caller_ = nh_.serviceClient<ig_active_reconstruction_msgs::PclShmInput>(out_name+"_shm");
   }
   
   bool PclRerouter::rerouteOneToTopic(ros::Duration max_wait_time)
   {
+    std::unique_lock<std::mutex> lock(mutex_);
     has_published_one_ = false;
     forward_one_ = true;
-    ros::spinOnce();
     
     ros::Time time_limit = ros::Time::now() + max_wait_time;
-    ros::Duration sleep_time;
-    sleep_time.fromNSec(max_wait_time.toNSec()/10);
+    std::chrono::nanoseconds wait_time( max_wait_time.toNSec()/10 );
     
     while(!has_published_one_ && ros::Time::now()<time_limit)
     {
+      // the callback may run within spinOnce
+      lock.unlock();
       ros::spinOnce();
-      sleep_time.sleep();
+      lock.lock();
+      
+      if( !has_published_one_ )
+	rerouted_.wait_for( lock, wait_time );
     }
     forward_one_ = false;
     
@@ -54,33 +64,78 @@ namespace ros_tools
   
   bool PclRerouter::rerouteOneToSrv()
   {
+    std::unique_lock<std::mutex> lock(mutex_);
     has_published_one_ = false;
     one_to_srv_ = true;
-    ros::spinOnce();
     
     while( one_to_srv_ && nh_.ok() )
     {
+      // the callback may run within spinOnce
+      lock.unlock();
       ros::spinOnce();
-      ros::Duration(0.01).sleep();
+      lock.lock();
+      
+      if( one_to_srv_ )
+	rerouted_.wait_for( lock, std::chrono::milliseconds(10) );
     }
     return service_response_;
   }
   
+  void PclRerouter::setSink( boost::function<bool(const sensor_msgs::PointCloud2ConstPtr&)> sink )
+  {
+    sink_ = sink;
+  }
+  
+  void PclRerouter::useSharedMemory( PointCloudShmRing::Config config )
+  {
+    shm_ring_ = boost::make_shared<PointCloudShmRing>(config,PointCloudShmRing::Role::WRITER);
+  }
+  
   void PclRerouter::pclCallback( const sensor_msgs::PointCloud2ConstPtr& msg )
   {
-    if(forward_one_)
+    bool forward_one, one_to_srv;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      forward_one = forward_one_;
+      one_to_srv = one_to_srv_;
+    }
+    
+    // callbacks of the subscription aren't called concurrently, thus the pointcloud can be rerouted without the lock
+    if(forward_one)
     {
       pcl_publisher_.publish(msg);
+      
+      std::lock_guard<std::mutex> lock(mutex_);
       has_published_one_ = true;
       forward_one_ = false;
+      rerouted_.notify_all();
     }
-    else if(one_to_srv_)
+    else if(one_to_srv)
     {
-      ig_active_reconstruction_msgs::PclInput call;
-      call.request.pointcloud = *msg;
-      pcl_service_caller_.call(call);
-      service_response_ = call.response.success;
+      ig_active_reconstruction_msgs::PclShmInput shm_call;
+      bool service_response;
+      
+      if( sink_ )
+      {
+	service_response = sink_(msg);
+      }
+      else if( shm_ring_ && shm_ring_->write(*msg,shm_call.request.sequence) )
+      {
+	shm_call.request.segment_name = shm_ring_->segmentName();
+	service_response = pcl_shm_service_caller_.call(shm_call) && shm_call.response.success;
+      }
+      else
+      {
+	ig_active_reconstruction_msgs::PclInput call;
+	call.request.pointcloud = *msg;
+	pcl_service_caller_.call(call);
+	service_response = call.response.success;
+      }
+      
+      std::lock_guard<std::mutex> lock(mutex_);
+      service_response_ = service_response;
       one_to_srv_ = false;
+      rerouted_.notify_all();
     }
     
     return;
@@ -57,6 +57,16 @@ namespace flying_gazebo_stereo_cam
     return ReceptionInfo::FAILED;
   }
   
+  void CommunicationInterface::setPointcloudSink( boost::function<bool(const sensor_msgs::PointCloud2ConstPtr&)> sink )
+  {
+    pcl_rerouter_.setSink(sink);
+  }
+  
+  void CommunicationInterface::useSharedMemoryTransport( ros_tools::PointCloudShmRing::Config config )
+  {
+    pcl_rerouter_.useSharedMemory(config);
+  }
+  
   CommunicationInterface::MovementCost CommunicationInterface::movementCost( View& target_view )
   {
     MovementCost cost;
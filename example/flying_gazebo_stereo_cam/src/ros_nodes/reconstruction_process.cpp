@@ -0,0 +1,99 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <ros/ros.h>
+
+#include <ig_active_reconstruction/views_simple_view_space_module.hpp>
+#include <ig_active_reconstruction_octomap/octomap_ros_world.hpp>
+
+#include <ig_active_reconstruction_ros/param_loader.hpp>
+#include <ig_active_reconstruction_ros/robot_ros_server_ci.hpp>
+#include <ig_active_reconstruction_ros/views_ros_server_ci.hpp>
+#include <ig_active_reconstruction_ros/basic_view_planner_setup.hpp>
+
+#include "flying_gazebo_stereo_cam/robot_communication_interface.hpp"
+
+
+/*! Implements the complete reconstruction procedure for the flying gazebo stereo camera in a single process: The octomap
+ * world representation, the viewspace module, the robot interface and the view planner are instantiated here and the view
+ * planner calls them directly, instead of going through ROS services. The modules are still exposed to ROS as in the
+ * separate nodes, such that external tools keep working. Retrieved pointclouds are handed to the world representation
+ * directly as well, without being copied into a service request.
+ * 
+ * Parameters are loaded from the private namespaces "~world", "~views", "~robot" and "~planner", which take the parameters
+ * of the respective separate nodes.
+ */
+int main(int argc, char **argv)
+{
+  ros::init(argc, argv, "reconstruction_process");
+  ros::NodeHandle nh;
+  
+  namespace iar = ig_active_reconstruction;
+  using namespace flying_gazebo_stereo_cam;
+  
+  // World representation
+  //------------------------------------------------------------------
+  iar::world_representation::octomap::IgTreeRosWorld world(nh,ros::NodeHandle("~world"));
+  boost::shared_ptr<iar::world_representation::CommunicationInterface> world_comm = world.igCalculator();
+  
+  // Viewspace module
+  //------------------------------------------------------------------
+  ros::NodeHandle views_nh("~views");
+  std::string viewspace_file_path;
+  ros_tools::getExpParam(viewspace_file_path,"viewspace_file_path",views_nh);
+  
+  boost::shared_ptr<iar::views::CommunicationInterface> views_comm = boost::make_shared<iar::views::SimpleViewSpaceModule>(viewspace_file_path);
+  iar::views::RosServerCI views_server(nh,views_comm);
+  
+  iar::views::ViewSpace viewspace = views_comm->getViewSpace();
+  world.recordViewSpace(viewspace); // if the session is recorded
+  
+  // Robot interface
+  //------------------------------------------------------------------
+  ros::NodeHandle robot_nh("~robot");
+  std::string model_name, camera_frame_name, world_frame_name, sensor_in_topic, sensor_out_name;
+  ros_tools::getExpParam(model_name,"model_name",robot_nh);
+  ros_tools::getExpParam(camera_frame_name,"camera_frame_name",robot_nh);
+  ros_tools::getExpParam(world_frame_name,"world_frame_name",robot_nh);
+  ros_tools::getExpParam(sensor_in_topic,"sensor_in_topic",robot_nh);
+  ros_tools::getExpParam(sensor_out_name,"sensor_out_name",robot_nh);
+  
+  std::shared_ptr<Controller> controller = std::make_shared<Controller>(model_name);
+  controller->startTfPublisher(camera_frame_name,world_frame_name);
+  
+  boost::shared_ptr<CommunicationInterface> robot_comm = boost::make_shared<CommunicationInterface>(nh,controller,sensor_in_topic,sensor_out_name);
+  robot_comm->setPointcloudSink( world.pointcloudSink() );
+  iar::robot::RosServerCI robot_server(nh,robot_comm);
+  
+  // View planner, directly connected to the modules above
+  //------------------------------------------------------------------
+  boost::shared_ptr<iar::BasicViewPlanner> view_planner = iar::loadBasicViewPlanner(robot_comm,views_comm,world_comm,ros::NodeHandle("~planner"));
+  
+  // The pointcloud input of the world and the ROS interfaces are served in the background
+  ros::AsyncSpinner spinner(0);
+  spinner.start();
+  
+  ROS_INFO("Reconstruction process is setup.");
+  
+  // Simple command line user interface.
+  //------------------------------------------------------------------
+  iar::runBasicViewPlannerUi(*view_planner);
+  
+  spinner.stop();
+  return 0;
+}
@@ -40,6 +40,16 @@ int main(int argc, char **argv)
   ros_tools::getExpParam(sensor_in_topic,"sensor_in_topic");
   ros_tools::getExpParam(sensor_out_name,"sensor_out_name");
   
+  std::string pcl_transport;
+  ros_tools::getParam<std::string>(pcl_transport,"pcl_transport","service");
+  
+  ros_tools::PointCloudShmRing::Config shm_config;
+  double slot_size_mb;
+  ros_tools::getParam<std::string>(shm_config.segment_name,"shm/segment_name",shm_config.segment_name);
+  ros_tools::getParam<unsigned int,int>(shm_config.number_of_slots,"shm/number_of_slots",shm_config.number_of_slots);
+  ros_tools::getParam<double>(slot_size_mb,"shm/slot_size_mb",double(shm_config.slot_size_bytes)/(1024*1024));
+  shm_config.slot_size_bytes = static_cast<size_t>(slot_size_mb*1024*1024);
+  
   using namespace flying_gazebo_stereo_cam;
   
   // Controller
@@ -51,6 +61,15 @@ int main(int argc, char **argv)
   // Iar communication interface
   //------------------------------------------------------------------
   boost::shared_ptr<CommunicationInterface> robot_interface = boost::make_shared<CommunicationInterface>(nh,controller,sensor_in_topic,sensor_out_name);
+  if( pcl_transport=="shared_memory" )
+  {
+    // pointclouds are written to a shared memory ring, only the slot is announced through the "<sensor_out_name>_shm" service
+    robot_interface->useSharedMemoryTransport(shm_config);
+  }
+  else if( pcl_transport!="service" )
+  {
+    ROS_WARN_STREAM("Unknown pointcloud transport '"<<pcl_transport<<"', using 'service'.");
+  }
   
   // Expose communication interface to ROS
   //------------------------------------------------------------------
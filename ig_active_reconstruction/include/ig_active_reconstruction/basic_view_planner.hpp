@@ -19,6 +19,11 @@
 
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <fstream>
+#include <string>
 
 #include "ig_active_reconstruction/robot_communication_interface.hpp"
 #include "ig_active_reconstruction/views_communication_interface.hpp"
@@ -41,6 +46,17 @@ namespace ig_active_reconstruction
    * - Choose next best view with highest utility function result.
    * - Check if termination criterion is fulfilled.
    * - Move to next best view
+   * 
+   * In pipelined mode, the candidates of the next iteration are speculatively scored on the current world state while the
+   * robot moves. Once the new data was received, only views close to the position it was recorded from are re-scored.
+   * This is a distance heuristic: Far views whose rays cross the newly observed region keep their speculative, possibly
+   * outdated score for one iteration.
+   * 
+   * Failed data retrievals and moves are retried with exponentially increasing waiting times. Pausing, resuming and
+   * stopping wake the procedure up immediately, also while it waits for a retry.
+   * 
+   * The wall-clock duration of each phase is measured in every iteration. The results can be received through a callback
+   * and written to a CSV or JSON trace file.
    */
   class BasicViewPlanner
   {
@@ -66,8 +82,39 @@ namespace ig_active_reconstruction
     public:
       bool discard_visited; //! Whether views should be discarded once visited. Default: false.
       int max_visits; //! Maximal number a view can be visited before it is discarded, -1 = infinite. Default: -1.
+      bool pipelined; //! Whether the next iteration's candidates are scored while the robot moves. Default: false.
+      double rescore_radius; //! [m] In pipelined mode, views within this distance of the last view are re-scored once new data was received from it (distance heuristic, farther views aren't checked for overlap with the new data). Default: 1.0.
+      double nbv_time_budget_s; //! [s] Wall-clock time budget for each nbv selection, passed to the utility calculator if >0. Default: 0 (unlimited).
+      double min_retry_backoff_s; //! [s] Waiting time before the first retry of a failed request, doubled for each further failure. Default: 0.01.
+      double max_retry_backoff_s; //! [s] Upper limit for the waiting time between retries. Default: 1.0.
+      std::string telemetry_trace_file; //! If not empty, iteration telemetry is written to this file, one JSON object per line if it ends with ".json", CSV otherwise. Default: "".
+    };
+    
+    /*! Timing and selection data of a single iteration.
+     */
+    struct IterationTelemetry
+    {
+    public:
+      /*! Constructor sets default values.
+       */
+      IterationTelemetry();
+      
+    public:
+      unsigned int iteration; //! Iteration number, starting at 1.
+      double viewspace_time_s; //! [s] Time spent retrieving the viewspace, only non-zero in the first iteration.
+      double data_retrieval_time_s; //! [s] Time spent retrieving data, including retries.
+      double cost_retrieval_time_s; //! [s] Time spent retrieving movement costs, as reported by the utility calculator.
+      double ig_retrieval_time_s; //! [s] Time spent retrieving information gains, as reported by the utility calculator.
+      double nbv_selection_time_s; //! [s] Time of the complete nbv selection, including cost and ig retrieval.
+      double motion_time_s; //! [s] Time spent moving to the chosen view, including retries. 0 if the procedure terminated instead.
+      unsigned int number_of_candidates; //! Number of candidate views.
+      unsigned int number_of_evaluated; //! Number of views whose utility was fully evaluated.
+      views::View::IdType nbv; //! Chosen view.
+      double utility; //! Utility of the chosen view.
     };
     
+    typedef std::function<void(const IterationTelemetry&)> TelemetryCallback;
+    
   public:
     /*! Constructor.
      */
@@ -101,6 +148,11 @@ namespace ig_active_reconstruction
      */
     virtual void setGoalEvaluationModule( boost::shared_ptr<GoalEvaluationModule> goal_evaluation_module );
     
+    /*! Sets a function that is called with the telemetry of each completed iteration, from the procedure's thread.
+     * Can't be set if running.
+     */
+    virtual void setTelemetryCallback( TelemetryCallback callback );
+    
     /*! Starts the procedure in its own thread if it was stopped, continues the procedure if it was paused.
      * @return True if the procedure started successfully, false if not (e.g. because no all necessary parameters are set, like the communication units)
      */
@@ -116,6 +168,17 @@ namespace ig_active_reconstruction
      */
     virtual void stop();
     
+    /*! Blocks until the procedure has reached an exit point, either because it was stopped or because the goal
+     * evaluation module ended it. Returns immediately if it isn't running.
+     */
+    virtual void wait();
+    
+    /*! Blocks until the procedure has reached an exit point or the timeout elapsed.
+     * @param timeout_s Maximal time to wait [s].
+     * @return True if the procedure isn't running anymore.
+     */
+    virtual bool waitFor( double timeout_s );
+    
     /*! Returns the current procedure status.
      */
     virtual Status status();
@@ -129,10 +192,31 @@ namespace ig_active_reconstruction
      */
     void main();
     
-    /*! Pausing if set. TODO: use condition variable
+    /*! Sets the procedure idle and wakes up threads that wait for it, called at every exit point of main().
+     */
+    void exitProcedure();
+    
+    /*! Blocks while the procedure is paused, returns immediately if it is stopped.
      */
     void pausePoint();
     
+    /*! Waits before the next retry of a failed request, returns early if the procedure is paused or stopped.
+     * @param failed_attempts Number of consecutive failures so far.
+     */
+    void retryBackoff( unsigned int failed_attempts );
+    
+    /*! Passes the telemetry of an iteration to the callback and the trace file, if set.
+     */
+    void reportTelemetry( const IterationTelemetry& telemetry );
+    
+    /*! Starts speculative scoring of the given candidates in a separate thread.
+     */
+    void startSpeculation( views::ViewSpace::IdSet candidates );
+    
+    /*! Aborts running speculative scoring and waits for it to return.
+     */
+    void stopSpeculation();
+    
   protected:
     Config config_; //! View planner configuration.
     
@@ -143,14 +227,23 @@ namespace ig_active_reconstruction
     boost::shared_ptr<UtilityCalculator> utility_calculator_; //! Utility calculator for evaluating different views. It also defines which information gains are used.
     boost::shared_ptr<GoalEvaluationModule> goal_evaluation_module_; //! Goal evaluation module which determines if the view planner shall continue or not.
     
-    Status status_; //! Current status.
+    std::atomic<Status> status_; //! Current status.
     std::thread running_procedure_; //! Thread for the procedure.
-    std::mutex mutex_; //! Data guard.
-    bool runProcedure_; //! True as long as the procedure is running or paused.
-    bool pauseProcedure_; //! True if the procedure should pause.
+    std::mutex mutex_; //! Data guard, used with control_cv_.
+    std::condition_variable control_cv_; //! Notified whenever the procedure is paused, resumed, stopped or exits.
+    std::atomic<bool> runProcedure_; //! True as long as the procedure is running or paused.
+    std::atomic<bool> pauseProcedure_; //! True if the procedure should pause.
+    std::atomic<bool> procedureActive_; //! True from run() until the procedure has reached an exit point.
     
     boost::shared_ptr<views::ViewSpace> viewspace_; //! Current viewspace.
     
+    std::thread speculation_thread_; //! Thread for speculative scoring in pipelined mode.
+    std::atomic<bool> abort_speculation_; //! Set to abort speculative scoring.
+    
+    TelemetryCallback telemetry_callback_; //! Called with the telemetry of each iteration.
+    std::ofstream telemetry_trace_; //! Telemetry trace file.
+    bool telemetry_trace_json_; //! Whether the trace is written as JSON instead of CSV.
+    
   };
   
 }
\ No newline at end of file
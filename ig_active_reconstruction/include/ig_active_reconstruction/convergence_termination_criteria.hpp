@@ -0,0 +1,110 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <deque>
+#include <string>
+#include <boost/shared_ptr.hpp>
+
+#include "ig_active_reconstruction/goal_evaluation_module.hpp"
+#include "ig_active_reconstruction/world_representation_communication_interface.hpp"
+
+namespace ig_active_reconstruction
+{
+  
+  /*! Termination criteria that returns true once the reconstruction has converged. It tracks the total map entropy, the
+   * unknown volume and the information gain of the best view over the iterations and is done as soon as the marginal
+   * gain over a sliding window of iterations falls below the configured thresholds for all of them.
+   * 
+   * The map metrics are retrieved through the world representation communication interface once per call to isDone(),
+   * which is meant to be used with map metrics that are answered in constant time, e.g. from incrementally maintained
+   * counters. Metrics that are not available are ignored, the best view information gain is taken from the selection
+   * reports passed to update().
+   */
+  class ConvergenceTerminationCriteria: public GoalEvaluationModule
+  {
+  public:
+    struct Config
+    {
+    public:
+      Config();
+      
+    public:
+      std::string entropy_metric_name; //! Name of the map metric returning the total map entropy, empty to not use it. Default: "TotalEntropy".
+      std::string unknown_metric_name; //! Name of the map metric returning the unknown volume, empty to not use it. Default: "UnknownVoxelCount".
+      unsigned int window_size; //! Number of iterations over which the marginal gain is evaluated. Default: 3.
+      double min_entropy_decrease; //! Entropy decrease over the window, relative to the entropy at its start, below which the entropy is considered converged. Default: 0.01.
+      double min_unknown_decrease; //! Unknown volume decrease over the window, relative to the volume at its start, below which it is considered converged. Default: 0.01.
+      double min_best_view_ig; //! Largest best view information gain within the window, relative to the largest one since the last reset, below which it is considered converged. Default: 0.05.
+      unsigned int max_calls; //! Returns true after this number of calls to isDone() even if not converged, 0 for no limit. Default: 0.
+    };
+    
+  public:
+    /*! Constructor.
+     * @param world_comm Interface to the world representation from which the map metrics are retrieved.
+     * @param config Configuration.
+     */
+    ConvergenceTerminationCriteria( boost::shared_ptr<world_representation::CommunicationInterface> world_comm, Config config = Config() );
+    
+    /*! Resets the goal evaluation module.
+     */
+    virtual void reset();
+    
+    /*! Records the information gain of the selected view.
+     */
+    virtual void update( const UtilityCalculator::SelectionReport& report );
+    
+    /*! Samples the map metrics and returns true if the reconstruction has converged.
+     */
+    virtual bool isDone();
+    
+  protected:
+    /*! Metrics recorded in one iteration.
+     */
+    struct Sample
+    {
+    public:
+      Sample();
+      
+    public:
+      double entropy;
+      double unknown;
+      double best_view_ig;
+      bool has_entropy;
+      bool has_unknown;
+    };
+    
+    /*! Retrieves the configured map metrics.
+     */
+    void retrieveMapMetrics( Sample& sample );
+    
+    /*! Returns the decrease from start to end, relative to start.
+     */
+    static double relativeDecrease( double start, double end );
+    
+  private:
+    boost::shared_ptr<world_representation::CommunicationInterface> world_comm_;
+    Config config_;
+    
+    std::deque<Sample> window_; //! The samples of the last window_size iterations, plus the one preceding them.
+    double best_view_ig_; //! Information gain of the last selected view.
+    double max_best_view_ig_; //! Largest best view information gain since the last reset.
+    unsigned int call_count_;
+  };
+  
+}
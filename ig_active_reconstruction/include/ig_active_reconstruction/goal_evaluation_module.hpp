@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include "ig_active_reconstruction/utility_calculator.hpp"
+
 namespace ig_active_reconstruction
 {
   
@@ -31,6 +33,12 @@ namespace ig_active_reconstruction
      */
     virtual void reset()=0;
     
+    /*! Called by the view planner with the report on each next best view selection, before isDone() is called. Modules
+     * that base their decision on the selection can overwrite it, the default implementation does nothing.
+     * @param report Report on the selection.
+     */
+    virtual void update( const UtilityCalculator::SelectionReport& report ){};
+    
     /*! Returns true if the goal was reached.
      */
     virtual bool isDone()=0;
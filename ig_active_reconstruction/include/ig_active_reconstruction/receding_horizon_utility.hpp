@@ -0,0 +1,100 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "ig_active_reconstruction/weighted_ig_utility.hpp"
+
+namespace ig_active_reconstruction
+{
+  /*! Receding horizon utility: Instead of choosing the next view greedily, short tours through the viewspace are planned
+   * with a beam search and only the first view of the best tour is returned. A tour starts at the current robot view and
+   * is scored by its information gain minus the weighted sum of the movement costs between consecutive views. This avoids
+   * moving back and forth between distant views if several good views lie close to each other.
+   * 
+   * The information gain of a tour is either the discounted sum of the (weighted) information gains of its single views,
+   * which counts voxels seen from several views once for each of them, or, if path ig is used, the information gain of
+   * all its poses combined as computed by the world representation, which counts each voxel once. Path information gains
+   * don't depend on the order of the views and are memoised by view set, tours of the beam that visit the same views
+   * share a single retrieval. Movement costs are requested in batches from each view that is the end of a tour in the
+   * beam, a robot::CostCacheCI can be used to keep them across calls.
+   * 
+   * Information gains are unnormalized, the cost weight thus relates cost to information gain units directly.
+   */
+  class RecedingHorizonUtility: public WeightedIgUtility
+  {
+  public:
+    /*! Configuration.
+     */
+    struct Config
+    {
+    public:
+      /*! Constructor sets default values.
+       */
+      Config();
+      
+    public:
+      unsigned int horizon; //! Number of views in a planned tour. Default: 3.
+      unsigned int beam_width; //! Number of tours that are kept after each planning step. Default: 5.
+      double discount; //! Factor by which the information gain of each further view in a tour is discounted, unless path ig is used. Default: 0.8.
+      double cost_weight; //! Weight of the movement cost of a tour. Default: 1.0.
+      bool use_path_ig; //! Whether tours are scored with the combined information gain of all their poses. Default: false.
+    };
+    
+  public:
+    /*! Constructor
+     * @param config Configuration.
+     * @param number_of_threads Number of threads used for parallel ig retrieval. If 0, the number of hardware threads is used.
+     */
+    RecedingHorizonUtility( Config config = Config(), unsigned int number_of_threads = 0 );
+    
+    /*! Returns the first view of the best tour through the given subset of the viewspace.
+     * @param id_set Id-subset of views that shall be considered.
+     * @param viewspace The complete viewspace object
+     */
+    virtual views::View::IdType getNbv( views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace );
+    
+    /*! Returns the first view of the best tour through the given subset of the viewspace and reports on the selection.
+     * The ranking holds distinct first views, each with the score of the best tour starting with it.
+     * @param id_set Id-subset of views that shall be considered.
+     * @param viewspace The complete viewspace object
+     * @param report (output) Summary of the selection.
+     */
+    virtual views::View::IdType getNbv( views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace, SelectionReport& report );
+    
+  protected:
+    /*! A planned tour.
+     */
+    struct Tour
+    {
+    public:
+      /*! Constructor sets default values.
+       */
+      Tour();
+      
+    public:
+      std::vector<size_t> views; //! Indices of the views in the order in which they are visited.
+      double ig; //! Information gain of the tour.
+      double cost; //! Total movement cost of the tour.
+      double score; //! Utility of the tour.
+    };
+    
+  protected:
+    Config config_; //! Configuration.
+  };
+  
+}
@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include <vector>
+#include <Eigen/StdVector>
+
 #include "ig_active_reconstruction/view_space.hpp"
 #include "ig_active_reconstruction/view.hpp"
 #include "ig_active_reconstruction/robot_movement_cost.hpp"
@@ -67,6 +70,16 @@ public:
    */
   virtual MovementCost movementCost( views::View& start_view, views::View& target_view, bool fill_additional_information  )=0;
   
+  /*! Returns the costs to move from start view to each of the target views. Allows implementations to answer a
+   * whole candidate set with a single request instead of one per view.
+   * The default implementation calls movementCost(start_view,target_view,fill_additional_information) for each target view.
+   * @param start_view the start view
+   * @param target_views the target views
+   * @param costs (output) costs for the movements, in the same order as the target views
+   * @param fill_additional_information if true then the different parts of the cost will be included in the additional fields as well
+   */
+  virtual void movementCosts( views::View& start_view, std::vector<views::View, Eigen::aligned_allocator<views::View> >& target_views, std::vector<MovementCost>& costs, bool fill_additional_information );
+  
   /*! Tells the robot to get the camera to a new view
    * @param target_view where to move to
    * @return false if the operation failed
@@ -0,0 +1,177 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+#include "ig_active_reconstruction/robot_communication_interface.hpp"
+
+namespace ig_active_reconstruction
+{
+  
+namespace robot
+{
+  
+  /*! Robot communication interface that caches movement costs between viewspace views. All calls are forwarded to a linked
+   * interface, costs between views that are part of the viewspace are stored in a lazily filled (start,target) table keyed
+   * by view ids, such that they are requested only once.
+   * 
+   * The cache tracks the view the robot was last successfully moved to via moveTo(): As long as it is known, getCurrentView()
+   * returns it instead of asking the robot, which makes costs from the current position cacheable as well.
+   * 
+   * Views that aren't part of the viewspace, such as the current pose reported by a robot, must be marked with nonViewSpace(),
+   * since their ids may collide with viewspace ids.
+   * 
+   * Only definite results are cached, that is costs with exception NONE, INFINITE_COST or one of the INVALID_* states.
+   * All methods are thread safe, given that the linked interface is.
+   */
+  class CostCacheCI: public CommunicationInterface
+  {
+  public:
+    struct Config
+    {
+    public:
+      /*! Constructor sets default values.
+       */
+      Config();
+      
+    public:
+      bool symmetric; //! If true, the cost from a to b is assumed to equal the one from b to a and stored only once. Default: false.
+      size_t max_entries; //! Maximal number of cached costs, the least recently used ones are dropped first. 0 = unbounded. Default: 0.
+    };
+    
+  public:
+    /*! Constructor
+     * @param linked_interface Interface to which all requests are forwarded.
+     * @param config Configuration.
+     */
+    CostCacheCI( boost::shared_ptr<CommunicationInterface> linked_interface = nullptr, Config config = Config() );
+    
+    /*! Set a new linked interface to which the class forwards all requests. Clears the cache.
+     * @param linked_interface Interface pointer.
+     */
+    void setLinkedInterface( boost::shared_ptr<CommunicationInterface> linked_interface );
+    
+    /*! Returns the view the robot was last moved to if it is known, otherwise forwards the request. */
+    virtual views::View getCurrentView();
+    
+    /*! Commands robot to retrieve new data.
+     * @return information about what happened (data received, receival failed )
+     */
+    virtual ReceptionInfo retrieveData();
+    
+    /*! Returns the cost to move from the current view to the indicated view. Cached if the current view is known.
+     * @param target_view the next view
+     * @return cost to move to that view
+     */
+    virtual MovementCost movementCost( views::View& target_view );
+    
+    /*! returns the cost to move from start view to target view
+     * @param start_view the start view
+     * @param target_view the target view
+     * @param fill_additional_information if true then the different parts of the cost will be included in the additional fields as well
+     * @return cost for the movement
+     */
+    virtual MovementCost movementCost( views::View& start_view, views::View& target_view, bool fill_additional_information  );
+    
+    /*! Returns the costs to move from start view to each of the target views. Only costs that aren't cached yet are
+     * requested from the linked interface, in a single batch.
+     * @param start_view the start view
+     * @param target_views the target views
+     * @param costs (output) costs for the movements, in the same order as the target views
+     * @param fill_additional_information if true then the different parts of the cost will be included in the additional fields as well
+     */
+    virtual void movementCosts( views::View& start_view, std::vector<views::View, Eigen::aligned_allocator<views::View> >& target_views, std::vector<MovementCost>& costs, bool fill_additional_information );
+    
+    /*! Tells the robot to get the camera to a new view
+     * @param target_view where to move to
+     * @return false if the operation failed
+     */
+    virtual bool moveTo( views::View& target_view );
+    
+    /*! Clears all cached costs and forgets the current view.
+     */
+    void invalidate();
+    
+    /*! Removes all cached costs from or to the given view, e.g. because it was removed from the viewspace or changed.
+     * @param view_id Id of the view.
+     */
+    void invalidate( views::View::IdType view_id );
+    
+    /*! Returns the number of cached costs.
+     */
+    size_t size();
+    
+    /*! Returns the number of requests that were answered from the cache so far.
+     */
+    size_t hits();
+    
+    /*! Returns the number of requests that had to be forwarded so far.
+     */
+    size_t misses();
+    
+  protected:
+    typedef std::pair<views::View::IdType,views::View::IdType> Key;
+    
+    struct KeyHash
+    {
+      size_t operator()( const Key& key ) const;
+    };
+    
+    struct Entry
+    {
+      MovementCost cost;
+      bool has_additional_information;
+      std::list<Key>::iterator lru_position;
+    };
+    
+    /*! Returns true and builds the key if the cost between the two views can be cached.
+     */
+    bool makeKey( views::View& start_view, views::View& target_view, Key& key );
+    
+    /*! Looks up a cost, marks it as recently used if found. Not locking.
+     */
+    bool lookup( const Key& key, bool fill_additional_information, MovementCost& cost );
+    
+    /*! Stores a cost if it is a definite result, drops the least recently used entries if necessary. Not locking.
+     */
+    void store( const Key& key, const MovementCost& cost, bool has_additional_information );
+    
+    /*! Throws if no interface is linked.
+     */
+    void checkLink();
+    
+  protected:
+    Config config_;
+    boost::shared_ptr<CommunicationInterface> linked_interface_; //! Linked interface.
+    
+    std::mutex mutex_; //! Protects all members below.
+    std::unordered_map<Key,Entry,KeyHash> cost_table_; //! Cached costs.
+    std::list<Key> lru_list_; //! Keys in order of usage, most recent first.
+    bool current_view_known_; //! Whether current_view_ is valid.
+    views::View current_view_; //! View the robot was last moved to.
+    size_t hits_;
+    size_t misses_;
+  };
+  
+}
+
+}
@@ -0,0 +1,74 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+
+namespace ig_active_reconstruction
+{
+  
+  /*! Persistent pool of worker threads. Threads are spawned once on construction and live until the pool is destroyed,
+   * such that repeated parallel stages (e.g. information gain retrieval in every planning iteration) don't pay for thread
+   * creation each time.
+   * 
+   * parallelFor() distributes work dynamically: all participating threads pull the next index from a shared atomic
+   * counter, thus slow items (e.g. views with a lot of ray casting) don't stall a statically assigned batch. The calling
+   * thread takes part in the work as well, which makes it safe to call parallelFor() from within a pool task.
+   * 
+   * The interface doesn't depend on c++11, the pool can thus be used from packages built with c++03 as well.
+   */
+  class ThreadPool
+  {
+  public:
+    /*! Constructor.
+     * @param number_of_threads Number of worker threads. If 0, std::thread::hardware_concurrency() is used (or 1 if not available).
+     */
+    ThreadPool( unsigned int number_of_threads = 0 );
+    
+    /*! Waits for all queued tasks to finish, then joins all threads.
+     */
+    virtual ~ThreadPool();
+    
+    /*! Returns the number of worker threads.
+     */
+    unsigned int size() const;
+    
+    /*! Queues a task for asynchronous execution by one of the worker threads.
+     */
+    void push( boost::function<void()> task );
+    
+    /*! Calls body(i) for every i in [0,count), distributed over the worker threads and the calling thread. Returns
+     * when all calls have finished.
+     * @param count Number of indices.
+     * @param body Function to call, must be safe to be called concurrently for different indices.
+     */
+    void parallelFor( size_t count, boost::function<void(size_t)> body );
+    
+  private:
+    ThreadPool( const ThreadPool& );
+    ThreadPool& operator=( const ThreadPool& );
+    
+  private:
+    class Impl;
+    boost::shared_ptr<Impl> impl_; //! Implementation, keeps threading headers out of the interface.
+  };
+  
+}
@@ -17,6 +17,8 @@
 
 #pragma once
 
+#include <atomic>
+
 #include "ig_active_reconstruction/view_space.hpp"
 
 namespace ig_active_reconstruction
@@ -26,6 +28,45 @@ namespace ig_active_reconstruction
    */
   class UtilityCalculator
   {    
+  public:
+    /*! Score of a single view, broken down into its components.
+     */
+    struct ViewScore
+    {
+    public:
+      /*! Constructor sets default values.
+       */
+      ViewScore();
+      
+    public:
+      views::View::IdType id; //! Id of the view.
+      double utility; //! Utility of the view.
+      double information_gain; //! Combined information gain of the view as used in the utility.
+      double cost; //! Movement cost to reach the view.
+      std::vector<double> metric_igs; //! Information gains of the single metrics, in the order in which they are used by the calculator.
+      bool reused; //! Whether the information gains were reused from an earlier iteration instead of being recomputed.
+    };
+    
+    /*! Summary of an nbv selection.
+     */
+    struct SelectionReport
+    {
+    public:
+      /*! Constructor sets default values.
+       */
+      SelectionReport();
+      
+    public:
+      views::View::IdType nbv; //! Chosen view.
+      double utility; //! Utility of the chosen view. Its utility without information gain if none of the views could be evaluated.
+      unsigned int number_of_candidates; //! Number of views that were considered.
+      unsigned int number_of_evaluated; //! Number of views whose utility was fully evaluated.
+      bool budget_exceeded; //! Whether the selection was cut short by the time budget.
+      double cost_retrieval_time_s; //! [s] Wall-clock time spent retrieving movement costs, if measured.
+      double ig_retrieval_time_s; //! [s] Wall-clock time spent retrieving information gains, if measured.
+      std::vector<ViewScore> ranking; //! Best views in order of decreasing utility, see setRankingSize().
+    };
+    
   public:
     virtual ~UtilityCalculator(){};
     
@@ -33,7 +74,42 @@ namespace ig_active_reconstruction
      * @param id_set Id-subset of views that shall be considered.
      * @param viewspace The complete viewspace object
      */
-    virtual views::View::IdType getNbv( views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace )=0;    
+    virtual views::View::IdType getNbv( views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace )=0;
+    
+    /*! Returns the view id of the best view within the given subset of the viewspace and reports on the selection.
+     * The default implementation calls getNbv(id_set,viewspace) and reports all views as evaluated.
+     * @param id_set Id-subset of views that shall be considered.
+     * @param viewspace The complete viewspace object
+     * @param report (output) Summary of the selection.
+     */
+    virtual views::View::IdType getNbv( views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace, SelectionReport& report );
+    
+    /*! Sets a wall-clock time budget for getNbv calls: Calculators that support it return the best view found so far once it
+     * is used up. The default implementation ignores the budget.
+     * @param time_budget_s Time budget in seconds, <=0 means unlimited.
+     */
+    virtual void setTimeBudget( double time_budget_s ){};
+    
+    /*! Sets the number of best views that are reported in SelectionReport::ranking. The default implementation ignores it
+     * and only reports the chosen view.
+     * @param k Number of views in the ranking.
+     */
+    virtual void setRankingSize( unsigned int k ){};
+    
+    /*! Speculatively scores the given views on the current world state, e.g. while the robot is moving. Calculators that
+     * support it keep the results and reuse them in the next getNbv call for all views that weren't invalidated in between.
+     * The default implementation does nothing.
+     * @param id_set Id-subset of views that shall be scored.
+     * @param viewspace The complete viewspace object
+     * @param abort If set to true by another thread, the call returns as soon as possible.
+     */
+    virtual void precompute( views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace, const std::atomic<bool>& abort ){};
+    
+    /*! Marks precomputed scores of the given views as outdated, e.g. because new data was received that affects them.
+     * The default implementation does nothing.
+     * @param id_set Views whose scores are outdated.
+     */
+    virtual void invalidate( views::ViewSpace::IdSet& id_set ){};
   };
   
 }
\ No newline at end of file
@@ -31,6 +31,11 @@ namespace views
 {
 
 /*! Container class for possible camera orientations (views).
+ * 
+ * The viewspace is versioned: Each modification through its interface (adding, deleting or re-flagging views) increases
+ * its version, such that the views changed or removed since an earlier version can be retrieved to synchronize copies held
+ * elsewhere. Modifications of views through the iterators aren't tracked unless markChanged is called. Together with the
+ * version, the instance identifies the change history a version belongs to. Copies share the instance of the original.
  * 
  * TODO: Change internal implementation details to speed up insertions and deletions.
  */
@@ -43,6 +48,7 @@ public:
   class ConstIterator; // forward declaration for bidirectional iterator type to const View
   
   typedef std::vector<View::IdType> IdSet;
+  typedef uint64_t VersionType;
   
 public:
   
@@ -146,14 +152,47 @@ public:
    */
   bool empty() const;
   
+  /*! Returns the instance id of the viewspace, which is unique per constructed viewspace (and never zero).
+   */
+  VersionType instance() const;
+  
+  /*! Returns the current version of the viewspace, which is increased by each modification.
+   */
+  VersionType version() const;
+  
+  /*! Marks a view as changed, to be used if it was modified through an iterator.
+   * @param index Index of the view.
+   */
+  void markChanged( View::IdType index );
+  
+  /*! Returns all views that were added or changed and the ids of all views that were removed after the given version.
+   * @param version The version since which changes are requested.
+   * @param changed_views (Output) Views added or changed since the version, in their current state.
+   * @param removed_ids (Output) Ids of the views removed since the version.
+   */
+  void changesSince( VersionType version, std::vector<View, Eigen::aligned_allocator<View> >& changed_views, IdSet& removed_ids ) const;
+  
 protected:
   /*! Recalculates the internal index map.
    */
   void recalculateIndexMap();
   
+  /*! Increases the version and records it as the one in which the view was last added or changed.
+   */
+  void recordChange( View::IdType index );
+  
+  /*! Increases the version and records it as the one in which the view was removed.
+   */
+  void recordRemoval( View::IdType index );
+  
 private:
   std::vector<View, Eigen::aligned_allocator<View> > view_space_; //! Actual storage, used for iterations.
   std::map<View::IdType, View > views_index_map_; //! For access by index.
+  
+  VersionType instance_; //! Identifies the change history of the viewspace.
+  VersionType version_; //! Current version.
+  std::map<View::IdType, VersionType> change_versions_; //! Version in which each view was last added or changed.
+  std::map<View::IdType, VersionType> removal_versions_; //! Version in which each removed view was removed.
 };
 
 /*! Bidirectional iterator
@@ -0,0 +1,105 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include "ig_active_reconstruction/utility_calculator.hpp"
+#include "ig_active_reconstruction/world_representation_communication_interface.hpp"
+#include "ig_active_reconstruction/robot_communication_interface.hpp"
+#include "ig_active_reconstruction/thread_pool.hpp"
+
+namespace ig_active_reconstruction
+{
+  /*! Common base of utility calculators that score views with a weighted sum of information gains retrieved from a
+   * world representation: Holds the communication interfaces, the used information gains with their weights and the
+   * thread pool for parallel retrieval.
+   */
+  class WeightedIgUtility: public UtilityCalculator
+  {
+  public:
+    /*! Constructor
+     * @param number_of_threads Number of threads used for parallel ig retrieval. If 0, the number of hardware threads is used.
+     */
+    WeightedIgUtility( unsigned int number_of_threads = 0 );
+    
+    /*! Adds a new information gain that should be used for calculation.
+     * @param name Name of the information gain to add.
+     * @param weight Corresponding weight. (default=1.0)
+     */
+    virtual void useInformationGain( std::string name, double weight=1.0 );
+    
+    /*! Sets information gain retrieval configuration.
+     */
+    virtual void setIgRetrievalConfig( world_representation::CommunicationInterface::IgRetrievalConfig& config );
+    
+    /*! Sets the world representation communication interface with which the utility function corresponds.
+     */
+    virtual void setWorldCommUnit( boost::shared_ptr<world_representation::CommunicationInterface> world_comm_unit );
+    
+    /*! Sets the robot communication interface with which the utility function corresponds.
+     */
+    virtual void setRobotCommUnit( boost::shared_ptr<robot::CommunicationInterface> robot_comm_unit );
+    
+    /*! Sets the thread pool used for parallel ig retrieval, e.g. to share it with other stages.
+     */
+    virtual void setThreadPool( boost::shared_ptr<ThreadPool> thread_pool );
+    
+    /*! Sets the number of best views that are reported in SelectionReport::ranking.
+     * @param k Number of views in the ranking. Default: 1.
+     */
+    virtual void setRankingSize( unsigned int k );
+    
+  protected:
+    /*! Helper function for multithreaded ig retrieval: Retrieves the weighted information gain of a single view.
+     * @param command Prebuilt command structure, only lacking the path entry
+     * @param view View for which the information gain is retrieved.
+     * @param metric_igs (output) Information gains of the single metrics, 0 for those that failed.
+     * @return Weighted sum of all successfully retrieved information gains.
+     */
+    double getIg( world_representation::CommunicationInterface::IgRetrievalCommand command, views::View& view, std::vector<double>& metric_igs );
+    
+    /*! Retrieves the weighted information gain of a path through several views, as evaluated by the world representation.
+     * @param command Prebuilt command structure, only lacking the path entry
+     * @param views Views whose poses form the path.
+     * @param metric_igs (output) Information gains of the single metrics, 0 for those that failed.
+     * @return Weighted sum of all successfully retrieved information gains.
+     */
+    double getIg( world_representation::CommunicationInterface::IgRetrievalCommand command, std::vector<views::View, Eigen::aligned_allocator<views::View> >& views, std::vector<double>& metric_igs );
+    
+    /*! Computes the weighted information gain of a single view from the results of its metrics.
+     * @param information_gains Results, ordered like the used information gains.
+     * @param metric_igs (output) Information gains of the single metrics, 0 for those that failed.
+     * @return Weighted sum of all successfully retrieved information gains.
+     */
+    double weightedIg( world_representation::CommunicationInterface::ViewIgResult& information_gains, std::vector<double>& metric_igs );
+    
+  protected:
+    boost::shared_ptr<world_representation::CommunicationInterface> world_comm_unit_; //! Interface to world representation.
+    boost::shared_ptr<robot::CommunicationInterface> robot_comm_unit_; //! Interface to robot.
+    
+    world_representation::CommunicationInterface::IgRetrievalConfig ig_retrieval_config_; //! Will be used for ig retrieval.
+    
+    std::vector< std::string > information_gains_; //! Name of the information gains to use.
+    std::vector<double> ig_weights_; //! Weight of the information gains.
+    
+    unsigned int ranking_size_; //! Number of views in the reported ranking.
+    
+    boost::shared_ptr<ThreadPool> thread_pool_; //! Worker threads for ig retrieval.
+  };
+  
+}
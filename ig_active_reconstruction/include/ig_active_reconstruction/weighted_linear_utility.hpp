@@ -17,75 +17,174 @@
 
 #pragma once
 
-#include "ig_active_reconstruction/utility_calculator.hpp"
-#include "ig_active_reconstruction/world_representation_communication_interface.hpp"
-#include "ig_active_reconstruction/robot_communication_interface.hpp"
+#include <map>
+#include <mutex>
+#include <chrono>
+#include <random>
+
+#include "ig_active_reconstruction/weighted_ig_utility.hpp"
 
 namespace ig_active_reconstruction
 {
   /*! Retrieves ig and cost for given view set, then calculates
    * a linear, but weighted combination, each normalized over the total ig and cost for all views respectively.
+   * Alternatively, information gains can be normalized with a fixed reference scale.
+   * 
+   * In cost bounded selection mode, all (cheap) costs are retrieved first. Information gains are then retrieved in order of
+   * decreasing optimistic utility, which is computed with an upper bound on the information gain of a single view. As soon as
+   * no remaining view can beat the best one found so far, the remaining views are skipped. This requires the fixed
+   * reference scale since the total information gain over all views isn't known then.
+   * 
+   * If a time budget is set, information gains are retrieved in the configured evaluation order until it is used up. The
+   * best view among those evaluated is returned then.
    * 
-   * IG retrieval is in this implementation not multithreaded and thus takes some time.
+   * IG retrieval is distributed over a persistent thread pool, each worker pulling the next view from a shared counter.
+   * Information gains computed by precompute() are reused by the next getNbv call unless invalidated. If score reuse is
+   * enabled, information gains retrieved by getNbv are kept as well and reused for up to a maximal number of iterations,
+   * except for the top ranked views of the last call and views close to the last chosen view: New data mostly changes the
+   * information gain of views close to where it was observed, and the contenders for the next choice need exact values.
    */
-  class WeightedLinearUtility: public UtilityCalculator
+  class WeightedLinearUtility: public WeightedIgUtility
   {    
+  public:
+    enum struct SelectionMode
+    {
+      EXHAUSTIVE, // Retrieve the information gain of all views.
+      COST_BOUNDED // Retrieve information gains in order of decreasing optimistic utility until no remaining view can beat the best one.
+    };
+    
+    enum struct EvaluationOrder
+    {
+      TIERED, // One tier of views with the highest optimistic utility, then one of views closest to the previously chosen view, then all others in random order. Tiers hold as many views as there are worker threads.
+      OPTIMISTIC_UTILITY, // Views with the highest optimistic utility first (cheapest first if no ig bound is set).
+      LAST_BEST_NEIGHBOURHOOD, // Views closest to the previously chosen view first.
+      RANDOM // Random order.
+    };
+    
   public:
     /*! Constructor
      * @param cost_weight Overall cost weight in the equation compared to information gains.
+     * @param number_of_threads Number of threads used for parallel ig retrieval. If 0, the number of hardware threads is used.
      */
-    WeightedLinearUtility( double cost_weight = 1.0 );
-    
-    /*! Adds a new information gain that should be used for calculation.
-     * @param name Name of the information gain to add.
-     * @param weight Corresponding weight. (default=1.0)
-     */
-    virtual void useInformationGain( std::string name, double weight=1.0 );
+    WeightedLinearUtility( double cost_weight = 1.0, unsigned int number_of_threads = 0 );
     
     /*! Sets the overall cost weight.
      */
     virtual void setCostWeight( double weight );
     
-    /*! Sets information gain retrieval configuratoin.
+    /*! Sets the selection mode. Default: SelectionMode::EXHAUSTIVE.
      */
-    virtual void setIgRetrievalConfig( world_representation::CommunicationInterface::IgRetrievalConfig& config );
+    virtual void setSelectionMode( SelectionMode mode );
     
-    /*! Sets the world representation communication interface with which the utility function corresponds.
+    /*! Sets a fixed scale by which the (weighted) information gains are normalized instead of the total information gain over all views.
+     * @param scale Reference scale, e.g. the typical information gain of a good view. Values <=0 restore normalization by the total. Default: 0.
      */
-    virtual void setWorldCommUnit( boost::shared_ptr<world_representation::CommunicationInterface> world_comm_unit );
+    virtual void setIgReferenceScale( double scale );
     
-    /*! Sets the robot communication interface with which the utility function corresponds.
+    /*! Sets the upper bound on the weighted information gain of a single view, used for cost bounded selection.
+     * @param bound Upper bound, e.g. the gain of a view whose rays all traverse unknown space up to the maximal ray depth. Default: 0 (unknown).
      */
-    virtual void setRobotCommUnit( boost::shared_ptr<robot::CommunicationInterface> robot_comm_unit );
+    virtual void setIgUpperBound( double bound );
+    
+    /*! Sets the order in which information gains are retrieved, relevant if the time budget is limited. Default: EvaluationOrder::TIERED.
+     */
+    virtual void setEvaluationOrder( EvaluationOrder order );
+    
+    /*! Sets a wall-clock time budget for getNbv calls, starting with cost retrieval.
+     * @param time_budget_s Time budget in seconds, <=0 means unlimited. Default: 0.
+     */
+    virtual void setTimeBudget( double time_budget_s );
+    
+    /*! Configures the reuse of information gains across getNbv calls. The views reported in SelectionReport::ranking are
+     * always re-evaluated in the next call.
+     * @param max_staleness Maximal number of getNbv calls for which retrieved information gains are reused, 0 disables reuse. Default: 0.
+     * @param radius Information gains of views within this distance of the last chosen view are never reused. Default: 0.
+     */
+    virtual void setScoreReuse( unsigned int max_staleness, double radius );
+    
+    /*! Configures batched information gain retrieval: Instead of one computeViewIg call per view, the views are sent to
+     * the world representation in batches through computeViewspaceIg, with batches being retrieved in parallel.
+     * @param batch_size Maximal number of views per batch, 0 retrieves the information gain of each view separately. Default: 0.
+     */
+    virtual void setIgBatchSize( unsigned int batch_size );
     
     /*! Returns the view id of the best view within the given subset of the viewspace.
      * @param id_set Id-subset of views that shall be considered.
      * @param viewspace The complete viewspace object
      */
-    virtual views::View::IdType getNbv( views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace );  
+    virtual views::View::IdType getNbv( views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace );
     
-  protected:
-    /*! Helper function for multithreaded ig retrieval.
-     * @param ig_vector (output) Vector in which the ig values will be set, must already have correct size
-     * @param total_ig (output) total information gain calculated within this function
-     * @param command Prebuilt command structure, only lacking the path entry
-     * @param id_set Set of views for which getNbv was called.
-     * @param viewspace Corresponding viewspace
-     * @param base_index Which entry within the batch is processed by this function [0-(batch_size-1)]. All id's are separated into batches of size batch_size. This function will process every base_index-th of it. E.g. batch_size = 3, base_index=2: The function will process the 2th, 5th, 8th, 11th, etc entry...
-     * @param batch_size Size of the batch, matches the number of spawned threads.
+    /*! Returns the view id of the best view within the given subset of the viewspace and reports on the selection.
+     * @param id_set Id-subset of views that shall be considered.
+     * @param viewspace The complete viewspace object
+     * @param report (output) Summary of the selection.
+     */
+    virtual views::View::IdType getNbv( views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace, SelectionReport& report );
+    
+    /*! Speculatively retrieves the information gains of the given views on the current world state, to be reused in the
+     * next getNbv call. Views whose information gain the last getNbv call retrieved are taken over from it instead of
+     * being retrieved again, since the world state hasn't changed in between.
+     * @param id_set Id-subset of views that shall be scored.
+     * @param viewspace The complete viewspace object
+     * @param abort If set to true by another thread, the call returns as soon as possible.
      */
-    void getIg(std::vector<double>& ig_vector, double& total_ig, world_representation::CommunicationInterface::IgRetrievalCommand command, views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace, unsigned int base_index, unsigned int batch_size );
+    virtual void precompute( views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace, const std::atomic<bool>& abort );
+    
+    /*! Discards precomputed or reused information gains of the given views.
+     * @param id_set Views whose scores are outdated.
+     */
+    virtual void invalidate( views::ViewSpace::IdSet& id_set );
     
   protected:
-    boost::shared_ptr<world_representation::CommunicationInterface> world_comm_unit_; //! Interface to world representation.
-    boost::shared_ptr<robot::CommunicationInterface> robot_comm_unit_; //! Interface to robot.
+    /*! Retrieves the information gains of the views with the given indices in parallel, skipping those that are already known.
+     * @param indices Indices of the views for which the information gain is retrieved.
+     * @param views All views.
+     * @param ig_vector (output) Information gains, indexed like views.
+     * @param metric_igs (output) Information gains of the single metrics, indexed like views.
+     * @param has_ig (output) Flags indicating whether the information gain of a view is known, indexed like views.
+     * @param deadline No new retrievals are started after this point in time.
+     * @return Number of views whose information gain was retrieved.
+     */
+    size_t retrieveIgs( std::vector<size_t>& indices, std::vector<views::View, Eigen::aligned_allocator<views::View> >& views, std::vector<double>& ig_vector, std::vector< std::vector<double> >& metric_igs, std::vector<bool>& has_ig, std::chrono::steady_clock::time_point deadline );
     
-    world_representation::CommunicationInterface::IgRetrievalConfig ig_retrieval_config_; //! Will be used for ig retrieval.
+    /*! Retrieves the information gains of the views with the given indices in batches, skipping those that are already known.
+     * Same parameters as retrieveIgs().
+     */
+    size_t retrieveIgBatches( std::vector<size_t>& indices, std::vector<views::View, Eigen::aligned_allocator<views::View> >& views, std::vector<double>& ig_vector, std::vector< std::vector<double> >& metric_igs, std::vector<bool>& has_ig, std::chrono::steady_clock::time_point deadline );
     
-    std::vector< std::string > information_gains_; //! Name of the information gains to use.
-    std::vector<double> ig_weights_; //! Weight of the information gains.
+  protected:
+    /*! Information gains of a view retrieved in an earlier iteration.
+     */
+    struct CachedScore
+    {
+      double ig; //! Weighted information gain.
+      std::vector<double> metric_igs; //! Information gains of the single metrics.
+      unsigned int iteration; //! Iteration (getNbv call) for which it was retrieved.
+    };
+    
+  protected:
     double cost_weight_;
     
+    SelectionMode selection_mode_; //! How views are selected.
+    double ig_reference_scale_; //! Fixed normalization scale of information gains, total ig is used if <=0.
+    double ig_upper_bound_; //! Upper bound on the weighted information gain of a single view, unknown if <=0.
+    EvaluationOrder evaluation_order_; //! Order in which information gains are retrieved.
+    double time_budget_s_; //! Time budget for getNbv calls [s], unlimited if <=0.
+    unsigned int ig_batch_size_; //! Maximal number of views per batched ig retrieval, 0 if not batched.
+    std::mt19937 random_generator_; //! For random evaluation order, default seeded for reproducibility.
+    
+    unsigned int max_staleness_; //! Maximal number of iterations for which information gains are reused.
+    double reuse_radius_; //! Information gains of views closer than this to the last chosen view aren't reused.
+    unsigned int iteration_; //! Number of completed getNbv calls.
+    std::vector<views::View::IdType> last_ranking_; //! Top ranked views of the last getNbv call.
+    
+    bool has_last_nbv_; //! Whether a view was chosen before.
+    Eigen::Vector3d last_nbv_position_; //! Position of the previously chosen view.
+    
+    std::mutex ig_cache_mutex_; //! Guards the ig cache.
+    std::map<views::View::IdType,CachedScore> ig_cache_; //! Precomputed or reusable information gains by view id.
+    std::map<views::View::IdType,CachedScore> last_retrieved_; //! Information gains retrieved by the last getNbv call, taken over by precompute().
+    
   };
   
 }
\ No newline at end of file
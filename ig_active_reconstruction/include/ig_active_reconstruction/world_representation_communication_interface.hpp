@@ -103,7 +103,23 @@ namespace world_representation
       IgRetrievalCommand();
       
     public:      
-      movements::PoseVector path; //! Describes the path for which the information gain shall be calculated. Note that in the current octomap-based implementation provided with the framework this is not yet implemented: Only the first pose will be considered and no casts into the future attempted.
+      movements::PoseVector path; //! Describes the path for which the information gain shall be calculated. The octomap-based implementation provided with the framework evaluates the union of the voxels seen from all poses on the current map, each voxel is counted once. No casts into the future are attempted.
+      std::vector<std::string> metric_names; //! Vector with the names of all metrics that shall be calculated. Only considered if metric_ids is empty.
+      std::vector<unsigned int> metric_ids; //! Vector with the ids of all metrics that shall be calculated. Takes precedence over metric_names.
+      IgRetrievalConfig config;
+    };
+    
+    /*! Command structure for the batched information gain retrieval of several views, each given by a single pose.
+     */
+    struct ViewspaceIgRetrievalCommand
+    {
+    public:
+      /*! Constructor loads default values.
+       */
+      ViewspaceIgRetrievalCommand();
+      
+    public:
+      movements::PoseVector poses; //! Poses of the views for which the information gains shall be calculated, each calculated independently of the others.
       std::vector<std::string> metric_names; //! Vector with the names of all metrics that shall be calculated. Only considered if metric_ids is empty.
       std::vector<unsigned int> metric_ids; //! Vector with the ids of all metrics that shall be calculated. Takes precedence over metric_names.
       IgRetrievalConfig config;
@@ -143,6 +159,14 @@ namespace world_representation
      */
     virtual ResultInformation computeViewIg(IgRetrievalCommand& command, ViewIgResult& output_ig)=0;
     
+    /*! Calculates a set of information gains for each of several views in one call. The default implementation
+     * calls computeViewIg for each pose, implementations can overwrite it to avoid per-view overhead.
+     * @param command Specifies which information gains have to be calculated and for which poses along with further parameters that define how the ig('s) will be collected.
+     * @param output_ig (Output) One result vector per pose, in the order of the poses in the command, each ordered like the metrics in the command.
+     * @return SUCCEEDED if the batch was processed, the results of the single views carry their own status.
+     */
+    virtual ResultInformation computeViewspaceIg(ViewspaceIgRetrievalCommand& command, ViewspaceIgResult& output_ig);
+    
     /*! Calculates a set of evaluation metrics on the complete map.
      * @param command Specifies which metrics shall be calculated.
      */
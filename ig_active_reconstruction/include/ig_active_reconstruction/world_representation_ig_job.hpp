@@ -0,0 +1,141 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#pragma once
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+
+#include "ig_active_reconstruction/world_representation_communication_interface.hpp"
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+
+  /*! Asynchronous, cancellable information gain computation for a set of views. The views are passed to the linked world
+   * representation in chunks of views_per_step views through computeViewspaceIg, the results of every view are reported
+   * through the view callback as soon as its chunk has finished and cancellation takes effect after the current chunk.
+   * All results computed until the job finished or was cancelled can be retrieved with results().
+   * 
+   * The job can either be run in a background thread (start()) or be driven by the caller (step()), e.g. from a ROS timer
+   * such that the world representation is only ever accessed from the thread that owns it. The two must not be mixed.
+   */
+  class IgJob
+  {
+  public:
+    /*! Status of the job, to be treated as scoped enum.
+     */
+    struct Status
+    {
+      enum Enum
+      {
+	PENDING=0, //! No view has been computed yet.
+	RUNNING, //! Some views were computed.
+	SUCCEEDED, //! All views were computed.
+	CANCELLED, //! The job was cancelled before all views were computed.
+	FAILED //! The world representation threw an exception.
+      };
+    };
+    
+    /*! Called for every view once its information gains were computed, from the thread that computed them.
+     * @param view_index Index of the view in the command.
+     * @param result Information gains of the view, ordered like the metrics in the command.
+     */
+    typedef boost::function<void(size_t view_index, const CommunicationInterface::ViewIgResult& result)> ViewCallback;
+    
+  public:
+    /*! Constructor.
+     * @param world_comm World representation that computes the information gains.
+     * @param command Views and metrics for which the information gains shall be computed.
+     * @param views_per_step Number of views passed to the world representation in one call. Larger chunks let the world
+     * representation parallelize over the views, smaller ones stream results and react to cancellation faster.
+     */
+    IgJob( boost::shared_ptr<CommunicationInterface> world_comm, const CommunicationInterface::ViewspaceIgRetrievalCommand& command, unsigned int views_per_step = 1 );
+    
+    /*! Cancels the job and waits for a running background thread to finish.
+     */
+    virtual ~IgJob();
+    
+    /*! Sets the callback that is called for every computed view. Must be set before the job is started.
+     */
+    void setViewCallback( ViewCallback callback );
+    
+    /*! Computes the next chunk of views in the calling thread. Concurrent calls compute different chunks, the job is
+     * finished by the last one that returns.
+     * @return True if views remain to be computed, false if there are none left for this caller (the job has finished
+     * or the remaining chunks are being computed by other calls).
+     */
+    bool step();
+    
+    /*! Computes all views in a background thread. Does nothing if the job was already started.
+     */
+    void start();
+    
+    /*! Requests the job to stop after the chunk that is currently being computed. A job that is driven by the caller
+     * finishes on the next call to step().
+     */
+    void cancel();
+    
+    /*! Blocks until the job has finished.
+     */
+    void wait();
+    
+    /*! Blocks until the job has finished or the timeout elapsed.
+     * @param timeout_s Maximal time to wait [s].
+     * @return True if the job has finished.
+     */
+    bool waitFor( double timeout_s );
+    
+    /*! Returns true if the job has finished (succeeded, cancelled or failed).
+     */
+    bool isFinished() const;
+    
+    /*! Returns the current status.
+     */
+    Status::Enum status() const;
+    
+    /*! Returns the total number of views.
+     */
+    size_t numberOfViews() const;
+    
+    /*! Returns the number of views whose information gains were computed so far.
+     */
+    size_t numberOfComputedViews() const;
+    
+    /*! Returns the results computed so far, may be called while the job is running.
+     * @param output_ig (Output) One result vector per view in the order of the command, empty for views that weren't computed.
+     * @param computed (Output) True for each view that was computed.
+     */
+    void results( CommunicationInterface::ViewspaceIgResult& output_ig, std::vector<bool>& computed ) const;
+    
+  private:
+    IgJob( const IgJob& );
+    IgJob& operator=( const IgJob& );
+    
+  private:
+    class Impl;
+    boost::shared_ptr<Impl> impl_; //! Implementation, keeps threading headers out of the interface.
+  };
+  
+}
+
+}
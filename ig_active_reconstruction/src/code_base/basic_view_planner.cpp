@@ -18,10 +18,10 @@
 #include "ig_active_reconstruction/basic_view_planner.hpp"
 
 #include <chrono>
+#include <cmath>
+#include <algorithm>
 #include <boost/smart_ptr.hpp>
 #include <iostream>
-#include <boost/thread/thread.hpp>
-#include <boost/chrono/include.hpp>
 
 namespace ig_active_reconstruction
 {
@@ -29,6 +29,27 @@ namespace ig_active_reconstruction
   BasicViewPlanner::Config::Config()
   : discard_visited(false)
   , max_visits(-1)
+  , pipelined(false)
+  , rescore_radius(1.0)
+  , nbv_time_budget_s(0)
+  , min_retry_backoff_s(0.01)
+  , max_retry_backoff_s(1.0)
+  , telemetry_trace_file("")
+  {
+  }
+  
+  BasicViewPlanner::IterationTelemetry::IterationTelemetry()
+  : iteration(0)
+  , viewspace_time_s(0)
+  , data_retrieval_time_s(0)
+  , cost_retrieval_time_s(0)
+  , ig_retrieval_time_s(0)
+  , nbv_selection_time_s(0)
+  , motion_time_s(0)
+  , number_of_candidates(0)
+  , number_of_evaluated(0)
+  , nbv(0)
+  , utility(0)
   {
   }
   
@@ -42,15 +63,19 @@ namespace ig_active_reconstruction
   , status_(Status::UNINITIALIZED)
   , runProcedure_(false)
   , pauseProcedure_(false)
+  , procedureActive_(false)
+  , abort_speculation_(false)
+  , telemetry_trace_json_(false)
   {
     
   }
   
   BasicViewPlanner::~BasicViewPlanner()
   {
-    runProcedure_ = false;
+    stop();
     if( running_procedure_.joinable() )
       running_procedure_.join();
+    stopSpeculation();
   }
   
   void BasicViewPlanner::setRobotCommUnit( boost::shared_ptr<robot::CommunicationInterface> robot_comm_unit )
@@ -118,20 +143,40 @@ namespace ig_active_reconstruction
       status_ = Status::UNINITIALIZED;
   }
   
-  bool BasicViewPlanner::run()
+  void BasicViewPlanner::setTelemetryCallback( TelemetryCallback callback )
   {
     if( runProcedure_ || running_procedure_.joinable() )
+      return;
+    
+    telemetry_callback_ = callback;
+  }
+  
+  bool BasicViewPlanner::run()
+  {
+    if( runProcedure_ )
     {
       if( pauseProcedure_ )
       {
-	pauseProcedure_ = false;
+	{
+	  std::lock_guard<std::mutex> lock(mutex_);
+	  pauseProcedure_ = false;
+	}
+	control_cv_.notify_all();
 	return true;
       }
       
       return false;
     }
     
+    if( !isReady() )
+      return false;
+    
+    if( running_procedure_.joinable() ) // stopped: wait for it to reach the exit point
+      running_procedure_.join();
+    
+    pauseProcedure_ = false;
     runProcedure_ = true;
+    procedureActive_ = true;
     running_procedure_ = std::thread(&BasicViewPlanner::main, this);
     
     return true;
@@ -139,12 +184,32 @@ namespace ig_active_reconstruction
   
   void BasicViewPlanner::pause()
   {
-    pauseProcedure_ = true;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      pauseProcedure_ = true;
+    }
+    control_cv_.notify_all();
   }
   
   void BasicViewPlanner::stop()
   {
-    runProcedure_ = false;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      runProcedure_ = false;
+    }
+    control_cv_.notify_all();
+  }
+  
+  void BasicViewPlanner::wait()
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    control_cv_.wait( lock, [this]{ return !procedureActive_; } );
+  }
+  
+  bool BasicViewPlanner::waitFor( double timeout_s )
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    return control_cv_.wait_for( lock, std::chrono::duration<double>(timeout_s), [this]{ return !procedureActive_; } );
   }
   
   BasicViewPlanner::Status BasicViewPlanner::status()
@@ -165,26 +230,50 @@ namespace ig_active_reconstruction
   {    
     // preparation
     goal_evaluation_module_->reset();
+    if( config_.nbv_time_budget_s>0 )
+      utility_calculator_->setTimeBudget(config_.nbv_time_budget_s);
+    
+    if( telemetry_trace_.is_open() )
+      telemetry_trace_.close();
+    if( !config_.telemetry_trace_file.empty() )
+    {
+      const std::string json_ending = ".json";
+      const std::string& file = config_.telemetry_trace_file;
+      telemetry_trace_json_ = file.size()>=json_ending.size() && file.compare( file.size()-json_ending.size(), json_ending.size(), json_ending )==0;
+      
+      telemetry_trace_.open( file.c_str(), std::ofstream::trunc );
+      if( !telemetry_trace_.is_open() )
+	std::cout<<"\nBasicViewPlanner: Failed to open telemetry trace file '"<<file<<"'.";
+      else if( !telemetry_trace_json_ )
+	telemetry_trace_<<"iteration,viewspace_time_s,data_retrieval_time_s,cost_retrieval_time_s,ig_retrieval_time_s,nbv_selection_time_s,motion_time_s,number_of_candidates,number_of_evaluated,nbv,utility\n";
+    }
     
     // get viewspace................................................
+    std::chrono::steady_clock::time_point phase_start = std::chrono::steady_clock::now();
     viewspace_ = boost::make_shared<views::ViewSpace>();
     views::CommunicationInterface::ViewSpaceStatus viewspace_status;
+    unsigned int failed_attempts = 0;
     do
     {
       status_ = Status::DEMANDING_VIEWSPACE;
       *viewspace_ = views_comm_unit_->getViewSpace();
       
+      if( viewspace_->empty() )
+	retryBackoff(++failed_attempts);
+      
       if( !runProcedure_ ) // exit point
 	{
-	  status_ = Status::IDLE;
-	  runProcedure_ = false;
+	  exitProcedure();
 	  return;
 	}
       pausePoint();
       
     }while( viewspace_->empty() );
+    double viewspace_time_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - phase_start ).count();
     
     unsigned int reception_nr = 0;
+    bool has_moved = false; // whether the robot was moved to a view of the viewspace yet
+    views::View last_view;
     
     do
     {
@@ -197,72 +286,220 @@ namespace ig_active_reconstruction
 	break;
       }
       
+      IterationTelemetry telemetry;
+      telemetry.iteration = reception_nr+1;
+      telemetry.viewspace_time_s = reception_nr==0? viewspace_time_s : 0;
+      
       // receive data....................................................
+      phase_start = std::chrono::steady_clock::now();
       robot::CommunicationInterface::ReceptionInfo data_retrieval_status;
+      failed_attempts = 0;
       do
       {
 	status_ = Status::DEMANDING_NEW_DATA;
 	data_retrieval_status = robot_comm_unit_->retrieveData();
 	
+	if( data_retrieval_status != robot::CommunicationInterface::ReceptionInfo::SUCCEEDED )
+	  retryBackoff(++failed_attempts);
+	
 	if( !runProcedure_ ) // exit point
 	{
-	  status_ = Status::IDLE;
-	  runProcedure_ = false;
+	  exitProcedure();
 	  return;
 	}
 	pausePoint();
 	
       }while( data_retrieval_status != robot::CommunicationInterface::ReceptionInfo::SUCCEEDED );
       
+      telemetry.data_retrieval_time_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - phase_start ).count();
       std::cout<<"\nData reception nr. "<<++reception_nr<<".";
       
+      // speculative scores of views near the position where the new data was recorded from are outdated (distance heuristic,
+      // far views looking at the newly observed region aren't caught)
+      if( config_.pipelined && has_moved )
+      {
+	std::vector<views::View, Eigen::aligned_allocator<views::View> > affected_views;
+	viewspace_->getViewsInRange( last_view, config_.rescore_radius, affected_views );
+	
+	views::ViewSpace::IdSet affected_ids;
+	for( views::View& view: affected_views )
+	{
+	  affected_ids.push_back( view.index() );
+	}
+	utility_calculator_->invalidate(affected_ids);
+      }
+      
       // getting cost and ig is wrapped in the utility calculator..................
       status_ = Status::NBV_CALCULATIONS;
-      views::View::IdType nbv_id = utility_calculator_->getNbv(view_candidate_ids,viewspace_);
+      UtilityCalculator::SelectionReport selection_report;
+      phase_start = std::chrono::steady_clock::now();
+      views::View::IdType nbv_id = utility_calculator_->getNbv(view_candidate_ids,viewspace_,selection_report);
+      telemetry.nbv_selection_time_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - phase_start ).count();
+      telemetry.cost_retrieval_time_s = selection_report.cost_retrieval_time_s;
+      telemetry.ig_retrieval_time_s = selection_report.ig_retrieval_time_s;
+      telemetry.number_of_candidates = selection_report.number_of_candidates;
+      telemetry.number_of_evaluated = selection_report.number_of_evaluated;
+      telemetry.nbv = nbv_id;
+      telemetry.utility = selection_report.utility;
+      std::cout<<"\nEvaluated "<<selection_report.number_of_evaluated<<" out of "<<selection_report.number_of_candidates<<" candidate views"<<(selection_report.budget_exceeded?" before the time budget was used up.":".");
+      if( selection_report.ranking.size()>1 )
+      {
+	std::cout<<"\nBest views:";
+	for( UtilityCalculator::ViewScore& score: selection_report.ranking )
+	{
+	  std::cout<<"\n  view "<<score.id<<": utility "<<score.utility<<", ig "<<score.information_gain<<", cost "<<score.cost<<(score.reused?" (reused)":"");
+	}
+      }
       views::View nbv = viewspace_->getView(nbv_id);
       
       // check termination criteria ...............................................
+      goal_evaluation_module_->update(selection_report);
       if( goal_evaluation_module_->isDone() )
       {
+	reportTelemetry(telemetry);
 	std::cout<<"\n\nTermination criteria was fulfilled. Reconstruction procedure ends.\n\n";
 	break;
       }
       
+      // score next iteration's candidates while moving...........................
+      if( config_.pipelined )
+      {
+	views::ViewSpace::IdSet next_candidate_ids;
+	for( views::View::IdType& id: view_candidate_ids )
+	{
+	  if( id!=nbv_id || !config_.discard_visited )
+	    next_candidate_ids.push_back(id);
+	}
+	startSpeculation(next_candidate_ids);
+      }
+      
       // move to next best view....................................................
       bool successfully_moved = false;
+      failed_attempts = 0;
+      phase_start = std::chrono::steady_clock::now();
       do
       {
 	status_ = Status::DEMANDING_MOVE;
 	successfully_moved = robot_comm_unit_->moveTo(nbv);
 	
+	if( !successfully_moved )
+	  retryBackoff(++failed_attempts);
+	
 	if( !runProcedure_ ) // exit point
 	{
-	  status_ = Status::IDLE;
-	  runProcedure_ = false;
+	  stopSpeculation();
+	  exitProcedure();
 	  return;
 	}
 	pausePoint();
 	
       }while(!successfully_moved);
+      telemetry.motion_time_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - phase_start ).count();
+      
+      // scoring on the old world state must not overlap with data insertion
+      stopSpeculation();
+      has_moved = true;
+      last_view = nbv;
       
       // update viewspace
       viewspace_->setVisited(nbv_id);
       if( config_.max_visits!=-1 && viewspace_->timesVisited(nbv_id) >= config_.max_visits )
 	viewspace_->setBad(nbv_id);
       
+      reportTelemetry(telemetry);
+      
     }while( runProcedure_ );
     
-    status_ = Status::IDLE;
-    runProcedure_ = false;
+    exitProcedure();
     return;
   }
   
+  void BasicViewPlanner::exitProcedure()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      status_ = Status::IDLE;
+      runProcedure_ = false;
+      procedureActive_ = false;
+    }
+    control_cv_.notify_all();
+  }
+  
   void BasicViewPlanner::pausePoint()
   {
-    while(pauseProcedure_)
+    std::unique_lock<std::mutex> lock(mutex_);
+    if( pauseProcedure_ && runProcedure_ )
     {
       status_ = Status::PAUSED;
-      boost::this_thread::sleep_for( boost::chrono::seconds(1) );
+      control_cv_.wait( lock, [this]{ return !pauseProcedure_ || !runProcedure_; } );
+    }
+  }
+  
+  void BasicViewPlanner::retryBackoff( unsigned int failed_attempts )
+  {
+    double backoff_s = config_.min_retry_backoff_s*std::pow( 2.0, std::min(failed_attempts,32u)-1.0 );
+    backoff_s = std::min( backoff_s, config_.max_retry_backoff_s );
+    if( backoff_s<=0 )
+      return;
+    
+    std::unique_lock<std::mutex> lock(mutex_);
+    control_cv_.wait_for( lock, std::chrono::duration<double>(backoff_s), [this]{ return pauseProcedure_ || !runProcedure_; } );
+  }
+  
+  void BasicViewPlanner::reportTelemetry( const IterationTelemetry& telemetry )
+  {
+    if( telemetry_trace_.is_open() )
+    {
+      if( telemetry_trace_json_ )
+      {
+	telemetry_trace_<<"{\"iteration\":"<<telemetry.iteration
+	  <<",\"viewspace_time_s\":"<<telemetry.viewspace_time_s
+	  <<",\"data_retrieval_time_s\":"<<telemetry.data_retrieval_time_s
+	  <<",\"cost_retrieval_time_s\":"<<telemetry.cost_retrieval_time_s
+	  <<",\"ig_retrieval_time_s\":"<<telemetry.ig_retrieval_time_s
+	  <<",\"nbv_selection_time_s\":"<<telemetry.nbv_selection_time_s
+	  <<",\"motion_time_s\":"<<telemetry.motion_time_s
+	  <<",\"number_of_candidates\":"<<telemetry.number_of_candidates
+	  <<",\"number_of_evaluated\":"<<telemetry.number_of_evaluated
+	  <<",\"nbv\":"<<telemetry.nbv
+	  <<",\"utility\":"<<telemetry.utility<<"}\n";
+      }
+      else
+      {
+	telemetry_trace_<<telemetry.iteration
+	  <<","<<telemetry.viewspace_time_s
+	  <<","<<telemetry.data_retrieval_time_s
+	  <<","<<telemetry.cost_retrieval_time_s
+	  <<","<<telemetry.ig_retrieval_time_s
+	  <<","<<telemetry.nbv_selection_time_s
+	  <<","<<telemetry.motion_time_s
+	  <<","<<telemetry.number_of_candidates
+	  <<","<<telemetry.number_of_evaluated
+	  <<","<<telemetry.nbv
+	  <<","<<telemetry.utility<<"\n";
+      }
+      telemetry_trace_.flush();
     }
+    
+    if( telemetry_callback_ )
+      telemetry_callback_(telemetry);
+  }
+  
+  void BasicViewPlanner::startSpeculation( views::ViewSpace::IdSet candidates )
+  {
+    stopSpeculation();
+    
+    abort_speculation_ = false;
+    speculation_thread_ = std::thread( [this,candidates]() mutable
+    {
+      utility_calculator_->precompute(candidates,viewspace_,abort_speculation_);
+    });
+  }
+  
+  void BasicViewPlanner::stopSpeculation()
+  {
+    abort_speculation_ = true;
+    if( speculation_thread_.joinable() )
+      speculation_thread_.join();
   }
 }
\ No newline at end of file
@@ -0,0 +1,153 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+#include "ig_active_reconstruction/convergence_termination_criteria.hpp"
+
+#include <algorithm>
+
+namespace ig_active_reconstruction
+{
+  
+  ConvergenceTerminationCriteria::Config::Config()
+  : entropy_metric_name("TotalEntropy")
+  , unknown_metric_name("UnknownVoxelCount")
+  , window_size(3)
+  , min_entropy_decrease(0.01)
+  , min_unknown_decrease(0.01)
+  , min_best_view_ig(0.05)
+  , max_calls(0)
+  {
+    
+  }
+  
+  ConvergenceTerminationCriteria::Sample::Sample()
+  : entropy(0)
+  , unknown(0)
+  , best_view_ig(0)
+  , has_entropy(false)
+  , has_unknown(false)
+  {
+    
+  }
+  
+  ConvergenceTerminationCriteria::ConvergenceTerminationCriteria( boost::shared_ptr<world_representation::CommunicationInterface> world_comm, Config config )
+  : world_comm_(world_comm)
+  , config_(config)
+  , best_view_ig_(0)
+  , max_best_view_ig_(0)
+  , call_count_(0)
+  {
+    
+  }
+  
+  void ConvergenceTerminationCriteria::reset()
+  {
+    window_.clear();
+    best_view_ig_ = 0;
+    max_best_view_ig_ = 0;
+    call_count_ = 0;
+  }
+  
+  void ConvergenceTerminationCriteria::update( const UtilityCalculator::SelectionReport& report )
+  {
+    best_view_ig_ = report.ranking.empty()? 0 : report.ranking.front().information_gain;
+  }
+  
+  bool ConvergenceTerminationCriteria::isDone()
+  {
+    ++call_count_;
+    
+    Sample sample;
+    retrieveMapMetrics(sample);
+    sample.best_view_ig = best_view_ig_;
+    max_best_view_ig_ = std::max( max_best_view_ig_, best_view_ig_ );
+    
+    window_.push_back(sample);
+    if( window_.size()>config_.window_size+1 )
+      window_.pop_front();
+    
+    if( config_.max_calls!=0 && call_count_>=config_.max_calls )
+      return true;
+    
+    if( window_.size()<config_.window_size+1 )
+      return false;
+    
+    const Sample& start = window_.front();
+    const Sample& end = window_.back();
+    
+    if( start.has_entropy && end.has_entropy && relativeDecrease(start.entropy,end.entropy)>=config_.min_entropy_decrease )
+      return false;
+    
+    if( start.has_unknown && end.has_unknown && relativeDecrease(start.unknown,end.unknown)>=config_.min_unknown_decrease )
+      return false;
+    
+    // the first sample only serves as reference for the map metrics
+    double window_best_view_ig = 0;
+    for( std::deque<Sample>::iterator it = window_.begin()+1; it!=window_.end(); ++it )
+    {
+      window_best_view_ig = std::max( window_best_view_ig, it->best_view_ig );
+    }
+    if( max_best_view_ig_>0 && window_best_view_ig/max_best_view_ig_>=config_.min_best_view_ig )
+      return false;
+    
+    return true;
+  }
+  
+  void ConvergenceTerminationCriteria::retrieveMapMetrics( Sample& sample )
+  {
+    if( world_comm_==nullptr )
+      return;
+    
+    world_representation::CommunicationInterface::MapMetricRetrievalCommand command;
+    if( !config_.entropy_metric_name.empty() )
+      command.metric_names.push_back(config_.entropy_metric_name);
+    if( !config_.unknown_metric_name.empty() )
+      command.metric_names.push_back(config_.unknown_metric_name);
+    
+    if( command.metric_names.empty() )
+      return;
+    
+    world_representation::CommunicationInterface::MapMetricRetrievalResultSet results;
+    world_comm_->computeMapMetric(command,results);
+    
+    for( size_t i=0; i<results.size() && i<command.metric_names.size(); ++i )
+    {
+      if( results[i].status!=world_representation::CommunicationInterface::ResultInformation::SUCCEEDED )
+	continue;
+      
+      if( command.metric_names[i]==config_.entropy_metric_name )
+      {
+	sample.entropy = results[i].value;
+	sample.has_entropy = true;
+      }
+      else
+      {
+	sample.unknown = results[i].value;
+	sample.has_unknown = true;
+      }
+    }
+  }
+  
+  double ConvergenceTerminationCriteria::relativeDecrease( double start, double end )
+  {
+    if( start<=0 )
+      return 0;
+    
+    return (start-end)/start;
+  }
+  
+}
@@ -0,0 +1,252 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+#include "ig_active_reconstruction/receding_horizon_utility.hpp"
+
+#include <boost/smart_ptr.hpp>
+
+#include <iostream>
+#include <limits>
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <set>
+#include <chrono>
+
+namespace ig_active_reconstruction
+{
+  
+  RecedingHorizonUtility::Config::Config()
+  : horizon(3)
+  , beam_width(5)
+  , discount(0.8)
+  , cost_weight(1.0)
+  , use_path_ig(false)
+  {
+    
+  }
+  
+  RecedingHorizonUtility::Tour::Tour()
+  : ig(0)
+  , cost(0)
+  , score(0)
+  {
+    
+  }
+  
+  RecedingHorizonUtility::RecedingHorizonUtility( Config config, unsigned int number_of_threads )
+  : WeightedIgUtility(number_of_threads)
+  , config_(config)
+  {
+    
+  }
+  
+  views::View::IdType RecedingHorizonUtility::getNbv( views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace )
+  {
+    SelectionReport report;
+    return getNbv(id_set,viewspace,report);
+  }
+  
+  views::View::IdType RecedingHorizonUtility::getNbv( views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace, SelectionReport& report )
+  {
+    report = SelectionReport();
+    report.number_of_candidates = id_set.size();
+    
+    if( id_set.empty() )
+      return 0;
+    
+    std::vector<views::View, Eigen::aligned_allocator<views::View> > views;
+    views.reserve( id_set.size() );
+    for( views::View::IdType& view_id: id_set )
+    {
+      views.push_back( viewspace->getView(view_id) );
+    }
+    
+    world_representation::CommunicationInterface::IgRetrievalCommand command;
+    command.config = ig_retrieval_config_;
+    command.metric_names = information_gains_;
+    
+    // information gains of single views, all in parallel
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    std::vector<double> view_igs(views.size(),0);
+    std::vector< std::vector<double> > view_metric_igs(views.size());
+    if( world_comm_unit_!=nullptr )
+    {
+      thread_pool_->parallelFor( views.size(), [&](size_t i)
+      {
+	view_igs[i] = getIg(command,views[i],view_metric_igs[i]);
+      });
+    }
+    report.ig_retrieval_time_s += std::chrono::duration<double>( std::chrono::steady_clock::now() - start_time ).count();
+    report.number_of_evaluated = views.size();
+    
+    // movement costs from the current view and between views, requested once per start view
+    bool use_costs = robot_comm_unit_!=nullptr && config_.cost_weight!=0;
+    std::map<size_t, std::vector<double> > cost_rows; // start view index -> costs to all views, infinite if invalid
+    std::vector<double> start_costs(views.size(),0);
+    
+    auto retrieveCosts = [&]( views::View& start, std::vector<double>& cost_row )
+    {
+      std::chrono::steady_clock::time_point cost_retrieval_start = std::chrono::steady_clock::now();
+      std::vector<robot::MovementCost> costs;
+      robot_comm_unit_->movementCosts( start, views, costs, false );
+      
+      cost_row.assign( views.size(), std::numeric_limits<double>::infinity() );
+      for( size_t i=0; i<costs.size() && i<views.size(); ++i )
+      {
+	if( costs[i].exception == robot::MovementCost::Exception::NONE )
+	  cost_row[i] = costs[i].cost;
+      }
+      report.cost_retrieval_time_s += std::chrono::duration<double>( std::chrono::steady_clock::now() - cost_retrieval_start ).count();
+    };
+    
+    if( use_costs )
+    {
+      views::View current_view = robot_comm_unit_->getCurrentView();
+      if( current_view.bad() ) // costs are unknown if the current pose couldn't be determined
+	start_costs.assign( views.size(), std::numeric_limits<double>::infinity() );
+      else
+	retrieveCosts(current_view,start_costs);
+    }
+    
+    // path information gains by (sorted) view set
+    std::map< std::vector<size_t>, double > path_igs;
+    
+    // beam search, starting with the empty tour at the current view
+    std::vector<Tour> beam(1);
+    for( unsigned int depth=0; depth<config_.horizon; ++depth )
+    {
+      double discount = std::pow(config_.discount,depth);
+      
+      std::vector<Tour> expansions;
+      for( Tour& tour: beam )
+      {
+	std::vector<double>* costs = &start_costs;
+	if( use_costs && !tour.views.empty() )
+	{
+	  size_t last = tour.views.back();
+	  if( cost_rows.count(last)==0 )
+	    retrieveCosts( views[last], cost_rows[last] );
+	  costs = &cost_rows[last];
+	}
+	
+	for( size_t i=0; i<views.size(); ++i )
+	{
+	  if( !std::isfinite((*costs)[i]) || std::find(tour.views.begin(),tour.views.end(),i)!=tour.views.end() )
+	    continue;
+	  
+	  Tour next = tour;
+	  next.views.push_back(i);
+	  next.cost += (*costs)[i];
+	  next.ig += discount*view_igs[i];
+	  expansions.push_back(next);
+	}
+      }
+      
+      if( expansions.empty() ) // no more reachable views
+	break;
+      
+      if( config_.use_path_ig && depth>0 && world_comm_unit_!=nullptr )
+      {
+	std::vector< std::vector<size_t> > keys;
+	std::vector< std::vector<size_t> > missing;
+	for( Tour& tour: expansions )
+	{
+	  std::vector<size_t> key = tour.views;
+	  std::sort( key.begin(), key.end() );
+	  if( path_igs.insert( std::make_pair(key,0.0) ).second )
+	    missing.push_back(key);
+	  keys.push_back(key);
+	}
+	
+	std::vector<double> missing_igs(missing.size(),0);
+	std::chrono::steady_clock::time_point ig_retrieval_start = std::chrono::steady_clock::now();
+	thread_pool_->parallelFor( missing.size(), [&](size_t j)
+	{
+	  std::vector<views::View, Eigen::aligned_allocator<views::View> > path;
+	  for( size_t& i: missing[j] )
+	  {
+	    path.push_back(views[i]);
+	  }
+	  std::vector<double> metric_igs;
+	  missing_igs[j] = getIg(command,path,metric_igs);
+	});
+	report.ig_retrieval_time_s += std::chrono::duration<double>( std::chrono::steady_clock::now() - ig_retrieval_start ).count();
+	for( size_t j=0; j<missing.size(); ++j )
+	{
+	  path_igs[ missing[j] ] = missing_igs[j];
+	}
+	
+	for( size_t e=0; e<expansions.size(); ++e )
+	{
+	  expansions[e].ig = path_igs[ keys[e] ];
+	}
+      }
+      
+      for( Tour& tour: expansions )
+      {
+	tour.score = tour.ig - config_.cost_weight*tour.cost;
+      }
+      
+      size_t beam_width = std::min<size_t>( std::max<unsigned int>(config_.beam_width,1), expansions.size() );
+      std::partial_sort( expansions.begin(), expansions.begin()+beam_width, expansions.end(), [](const Tour& a, const Tour& b){ return a.score>b.score; } );
+      expansions.resize(beam_width);
+      beam.swap(expansions);
+    }
+    
+    if( beam.front().views.empty() ) // no reachable view at all
+    {
+      std::cout<<"\nRecedingHorizonUtility: None of the views is reachable.";
+      report.nbv = id_set.front();
+      report.utility = 0;
+      return report.nbv;
+    }
+    
+    Tour& best = beam.front();
+    std::cout<<"\nRecedingHorizonUtility: Planned tour";
+    for( size_t& i: best.views )
+    {
+      std::cout<<" "<<id_set[i];
+    }
+    std::cout<<" with ig "<<best.ig<<" and cost "<<best.cost<<".";
+    
+    report.nbv = id_set[ best.views.front() ];
+    report.utility = best.score;
+    
+    // best tour for each first view still in the beam
+    std::set<size_t> ranked;
+    for( Tour& tour: beam )
+    {
+      if( report.ranking.size()>=ranking_size_ )
+	break;
+      if( !ranked.insert( tour.views.front() ).second )
+	continue;
+      
+      size_t first = tour.views.front();
+      ViewScore score;
+      score.id = id_set[first];
+      score.utility = tour.score;
+      score.information_gain = tour.ig;
+      score.cost = tour.cost;
+      score.metric_igs = view_metric_igs[first];
+      report.ranking.push_back(score);
+    }
+    
+    return report.nbv;
+  }
+  
+}
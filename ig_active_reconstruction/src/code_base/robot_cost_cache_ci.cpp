@@ -0,0 +1,306 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "ig_active_reconstruction/robot_cost_cache_ci.hpp"
+
+#include <stdexcept>
+#include <functional>
+
+namespace ig_active_reconstruction
+{
+  
+namespace robot
+{
+  
+  CostCacheCI::Config::Config()
+  : symmetric(false)
+  , max_entries(0)
+  {
+  }
+  
+  CostCacheCI::CostCacheCI( boost::shared_ptr<CommunicationInterface> linked_interface, Config config )
+  : config_(config)
+  , linked_interface_(linked_interface)
+  , current_view_known_(false)
+  , hits_(0)
+  , misses_(0)
+  {
+    
+  }
+  
+  void CostCacheCI::setLinkedInterface( boost::shared_ptr<CommunicationInterface> linked_interface )
+  {
+    linked_interface_ = linked_interface;
+    invalidate();
+  }
+  
+  views::View CostCacheCI::getCurrentView()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if( current_view_known_ )
+	return current_view_;
+    }
+    checkLink();
+    return linked_interface_->getCurrentView();
+  }
+  
+  CostCacheCI::ReceptionInfo CostCacheCI::retrieveData()
+  {
+    checkLink();
+    return linked_interface_->retrieveData();
+  }
+  
+  MovementCost CostCacheCI::movementCost( views::View& target_view )
+  {
+    views::View current_view;
+    bool current_view_known;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      current_view_known = current_view_known_;
+      if( current_view_known )
+	current_view = current_view_;
+      else
+	++misses_;
+    }
+    
+    if( current_view_known )
+      return movementCost(current_view,target_view,false);
+    
+    checkLink();
+    return linked_interface_->movementCost(target_view);
+  }
+  
+  MovementCost CostCacheCI::movementCost( views::View& start_view, views::View& target_view, bool fill_additional_information  )
+  {
+    Key key;
+    bool cacheable = makeKey(start_view,target_view,key);
+    
+    MovementCost cost;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if( cacheable && lookup(key,fill_additional_information,cost) )
+      {
+	++hits_;
+	return cost;
+      }
+      ++misses_;
+    }
+    
+    checkLink();
+    cost = linked_interface_->movementCost(start_view,target_view,fill_additional_information);
+    
+    if( cacheable )
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      store(key,cost,fill_additional_information);
+    }
+    return cost;
+  }
+  
+  void CostCacheCI::movementCosts( views::View& start_view, std::vector<views::View, Eigen::aligned_allocator<views::View> >& target_views, std::vector<MovementCost>& costs, bool fill_additional_information )
+  {
+    costs.clear();
+    costs.resize( target_views.size() );
+    
+    std::vector<size_t> missing_indices;
+    std::vector<Key> keys( target_views.size() );
+    std::vector<bool> cacheable( target_views.size() );
+    
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for( size_t i=0; i<target_views.size(); ++i )
+      {
+	cacheable[i] = makeKey(start_view,target_views[i],keys[i]);
+	
+	if( cacheable[i] && lookup(keys[i],fill_additional_information,costs[i]) )
+	{
+	  ++hits_;
+	}
+	else
+	{
+	  ++misses_;
+	  missing_indices.push_back(i);
+	}
+      }
+    }
+    
+    if( missing_indices.empty() )
+      return;
+    
+    checkLink();
+    
+    std::vector<views::View, Eigen::aligned_allocator<views::View> > missing_views;
+    missing_views.reserve( missing_indices.size() );
+    for( size_t& i: missing_indices )
+    {
+      missing_views.push_back( target_views[i] );
+    }
+    
+    std::vector<MovementCost> missing_costs;
+    linked_interface_->movementCosts(start_view,missing_views,missing_costs,fill_additional_information);
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    for( size_t j=0; j<missing_indices.size(); ++j )
+    {
+      size_t i = missing_indices[j];
+      
+      if( j>=missing_costs.size() )
+      {
+	costs[i].exception = MovementCost::Exception::RECEPTION_FAILED;
+	continue;
+      }
+      
+      costs[i] = missing_costs[j];
+      if( cacheable[i] )
+	store(keys[i],costs[i],fill_additional_information);
+    }
+  }
+  
+  bool CostCacheCI::moveTo( views::View& target_view )
+  {
+    checkLink();
+    bool success = linked_interface_->moveTo(target_view);
+    
+    std::lock_guard<std::mutex> lock(mutex_);
+    // after a failed movement the robot might be anywhere
+    current_view_known_ = success && !target_view.nonViewSpace();
+    if( current_view_known_ )
+      current_view_ = target_view;
+    
+    return success;
+  }
+  
+  void CostCacheCI::invalidate()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    cost_table_.clear();
+    lru_list_.clear();
+    current_view_known_ = false;
+  }
+  
+  void CostCacheCI::invalidate( views::View::IdType view_id )
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    
+    for( auto it = cost_table_.begin(); it!=cost_table_.end(); )
+    {
+      if( it->first.first==view_id || it->first.second==view_id )
+      {
+	lru_list_.erase( it->second.lru_position );
+	it = cost_table_.erase(it);
+      }
+      else
+	++it;
+    }
+    
+    if( current_view_known_ && current_view_.index()==view_id )
+      current_view_known_ = false;
+  }
+  
+  size_t CostCacheCI::size()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return cost_table_.size();
+  }
+  
+  size_t CostCacheCI::hits()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+  }
+  
+  size_t CostCacheCI::misses()
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+  }
+  
+  size_t CostCacheCI::KeyHash::operator()( const Key& key ) const
+  {
+    std::hash<views::View::IdType> hasher;
+    size_t seed = hasher(key.first);
+    seed ^= hasher(key.second) + 0x9e3779b9 + (seed<<6) + (seed>>2);
+    return seed;
+  }
+  
+  bool CostCacheCI::makeKey( views::View& start_view, views::View& target_view, Key& key )
+  {
+    // views that aren't part of the viewspace don't have a stable id
+    if( start_view.nonViewSpace() || target_view.nonViewSpace() )
+      return false;
+    
+    key.first = start_view.index();
+    key.second = target_view.index();
+    
+    if( config_.symmetric && key.second<key.first )
+      std::swap(key.first,key.second);
+    
+    return true;
+  }
+  
+  bool CostCacheCI::lookup( const Key& key, bool fill_additional_information, MovementCost& cost )
+  {
+    auto it = cost_table_.find(key);
+    
+    if( it==cost_table_.end() )
+      return false;
+    if( fill_additional_information && !it->second.has_additional_information )
+      return false;
+    
+    lru_list_.splice( lru_list_.begin(), lru_list_, it->second.lru_position );
+    cost = it->second.cost;
+    return true;
+  }
+  
+  void CostCacheCI::store( const Key& key, const MovementCost& cost, bool has_additional_information )
+  {
+    if( cost.exception==MovementCost::Exception::COST_UNKNOWN || cost.exception==MovementCost::Exception::RECEPTION_FAILED )
+      return;
+    
+    auto it = cost_table_.find(key);
+    if( it!=cost_table_.end() )
+    {
+      it->second.cost = cost;
+      it->second.has_additional_information = has_additional_information;
+      lru_list_.splice( lru_list_.begin(), lru_list_, it->second.lru_position );
+      return;
+    }
+    
+    lru_list_.push_front(key);
+    Entry& entry = cost_table_[key];
+    entry.cost = cost;
+    entry.has_additional_information = has_additional_information;
+    entry.lru_position = lru_list_.begin();
+    
+    while( config_.max_entries!=0 && cost_table_.size()>config_.max_entries )
+    {
+      cost_table_.erase( lru_list_.back() );
+      lru_list_.pop_back();
+    }
+  }
+  
+  void CostCacheCI::checkLink()
+  {
+    if( linked_interface_ == nullptr )
+      throw std::runtime_error("robot::CostCacheCI::Interface not linked.");
+  }
+  
+}
+
+}
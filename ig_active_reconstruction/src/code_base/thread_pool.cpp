@@ -0,0 +1,191 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "ig_active_reconstruction/thread_pool.hpp"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <memory>
+#include <deque>
+#include <vector>
+#include <algorithm>
+
+namespace ig_active_reconstruction
+{
+  
+  /*! Shared state of a parallelFor() call. Helper tasks might only be started after the call returned, hence
+   * it is held by shared pointer.
+   */
+  struct ParallelForState
+  {
+    ParallelForState( size_t count, boost::function<void(size_t)>& body )
+    : body(body)
+    , count(count)
+    , next_index(0)
+    , active_helpers(0)
+    , closed(false)
+    {}
+    
+    //! Processes indices until none are left.
+    void process()
+    {
+      for( size_t i = next_index++; i<count; i = next_index++ )
+      {
+	body(i);
+      }
+    }
+    
+    boost::function<void(size_t)> body;
+    size_t count;
+    std::atomic<size_t> next_index;
+    
+    std::mutex mutex;
+    std::condition_variable helpers_done;
+    unsigned int active_helpers; //! Number of helpers currently processing indices.
+    bool closed; //! Once set, helpers that haven't started yet won't touch any index anymore.
+  };
+  
+  class ThreadPool::Impl
+  {
+  public:
+    Impl( unsigned int number_of_threads );
+    ~Impl();
+    
+    //! Worker thread loop.
+    void work();
+    
+  public:
+    std::vector<std::thread> workers; //! Worker threads.
+    std::deque< boost::function<void()> > tasks; //! Queued tasks.
+    std::mutex mutex; //! Protects the task queue.
+    std::condition_variable task_available; //! Signals newly queued tasks.
+    bool shutdown; //! If true, workers exit once the queue is empty.
+  };
+  
+  ThreadPool::Impl::Impl( unsigned int number_of_threads )
+  : shutdown(false)
+  {
+    if( number_of_threads==0 )
+      number_of_threads = std::thread::hardware_concurrency();
+    if( number_of_threads==0 )
+      number_of_threads = 1;
+    
+    for( unsigned int i=0; i<number_of_threads; ++i )
+    {
+      workers.push_back( std::thread(&Impl::work,this) );
+    }
+  }
+  
+  ThreadPool::Impl::~Impl()
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      shutdown = true;
+    }
+    task_available.notify_all();
+    
+    for( std::thread& worker: workers )
+    {
+      worker.join();
+    }
+  }
+  
+  void ThreadPool::Impl::work()
+  {
+    while(true)
+    {
+      boost::function<void()> task;
+      {
+	std::unique_lock<std::mutex> lock(mutex);
+	task_available.wait( lock, [this](){ return shutdown || !tasks.empty(); } );
+	
+	if( tasks.empty() )
+	  return; // shutdown
+	
+	task = tasks.front();
+	tasks.pop_front();
+      }
+      task();
+    }
+  }
+  
+  ThreadPool::ThreadPool( unsigned int number_of_threads )
+  : impl_( new Impl(number_of_threads) )
+  {
+    
+  }
+  
+  ThreadPool::~ThreadPool()
+  {
+    
+  }
+  
+  unsigned int ThreadPool::size() const
+  {
+    return impl_->workers.size();
+  }
+  
+  void ThreadPool::push( boost::function<void()> task )
+  {
+    {
+      std::lock_guard<std::mutex> lock(impl_->mutex);
+      impl_->tasks.push_back(task);
+    }
+    impl_->task_available.notify_one();
+  }
+  
+  void ThreadPool::parallelFor( size_t count, boost::function<void(size_t)> body )
+  {
+    if( count==0 )
+      return;
+    
+    std::shared_ptr<ParallelForState> state = std::make_shared<ParallelForState>(count,body);
+    
+    // the calling thread works as well, thus one helper less is needed
+    size_t number_of_helpers = std::min<size_t>( impl_->workers.size(), count-1 );
+    for( size_t i=0; i<number_of_helpers; ++i )
+    {
+      push( [state]()
+      {
+	{
+	  std::lock_guard<std::mutex> lock(state->mutex);
+	  if( state->closed )
+	    return;
+	  ++state->active_helpers;
+	}
+	
+	state->process();
+	
+	std::lock_guard<std::mutex> lock(state->mutex);
+	if( --state->active_helpers==0 )
+	  state->helpers_done.notify_all();
+      });
+    }
+    
+    state->process();
+    
+    // all indices have been taken: wait for the helpers that are still working on theirs. Helpers that are still queued
+    // (e.g. because all workers are busy) aren't waited for, which prevents deadlocks for nested calls.
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->closed = true;
+    state->helpers_done.wait( lock, [&state](){ return state->active_helpers==0; } );
+  }
+  
+}
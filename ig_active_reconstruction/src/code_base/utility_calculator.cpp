@@ -0,0 +1,58 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "ig_active_reconstruction/utility_calculator.hpp"
+
+namespace ig_active_reconstruction
+{
+  
+  UtilityCalculator::ViewScore::ViewScore()
+  : id(0)
+  , utility(0)
+  , information_gain(0)
+  , cost(0)
+  , reused(false)
+  {
+  }
+  
+  UtilityCalculator::SelectionReport::SelectionReport()
+  : nbv(0)
+  , utility(0)
+  , number_of_candidates(0)
+  , number_of_evaluated(0)
+  , budget_exceeded(false)
+  , cost_retrieval_time_s(0)
+  , ig_retrieval_time_s(0)
+  {
+  }
+  
+  views::View::IdType UtilityCalculator::getNbv( views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace, SelectionReport& report )
+  {
+    report = SelectionReport();
+    report.nbv = getNbv(id_set,viewspace);
+    report.number_of_candidates = id_set.size();
+    report.number_of_evaluated = id_set.size();
+    
+    ViewScore nbv_score;
+    nbv_score.id = report.nbv;
+    report.ranking.push_back(nbv_score);
+    
+    return report.nbv;
+  }
+  
+}
@@ -18,6 +18,8 @@
 #include "ig_active_reconstruction/view_space.hpp"
 #include <fstream>
 #include <stdexcept>
+#include <atomic>
+#include <chrono>
 
 namespace ig_active_reconstruction
 {
@@ -26,8 +28,13 @@ namespace views
 {
 
 ViewSpace::ViewSpace()
+: version_(0)
 {
-  
+  // time and a running count make the instance unique within and (most likely) across processes
+  static std::atomic<VersionType> constructed(0);
+  instance_ = static_cast<VersionType>( std::chrono::system_clock::now().time_since_epoch().count() ) ^ ( constructed++<<48 );
+  if( instance_==0 )
+    instance_ = 1;
 }
 
 std::vector<View, Eigen::aligned_allocator<View> > ViewSpace::getViewSpace()
@@ -70,6 +77,7 @@ bool ViewSpace::deleteView( View::IdType index )
     {
       views_index_map_.erase(it);
       recalculateIndexMap();
+      recordRemoval(index);
       return true;
     }
   }
@@ -104,6 +112,7 @@ void ViewSpace::setBad( View::IdType index )
   try
   {
     static_cast<View&>(views_index_map_.at(index)).bad()=true;
+    recordChange(index);
     return;
   }
   catch(...)
@@ -117,6 +126,7 @@ void ViewSpace::setGood( View::IdType index )
   try
   {
     static_cast<View&>(views_index_map_.at(index)).bad()=false;
+    recordChange(index);
     return;
   }
   catch(...)
@@ -130,6 +140,7 @@ void ViewSpace::setVisited( View::IdType index )
   try
   {
     static_cast<View&>(views_index_map_.at(index)).timesVisited() += 1;
+    recordChange(index);
     return;
   }
   catch(...)
@@ -143,6 +154,7 @@ void ViewSpace::setUnReachable( View::IdType index )
   try
   {
     static_cast<View&>(views_index_map_.at(index)).reachable() = false;
+    recordChange(index);
     return;
   }
   catch(...)
@@ -156,6 +168,7 @@ void ViewSpace::setReachable( View::IdType index )
   try
   {
     static_cast<View&>(views_index_map_.at(index)).reachable() = true;
+    recordChange(index);
     return;
   }
   catch(...)
@@ -170,6 +183,7 @@ void ViewSpace::push_back( View new_vp )
   //view_space_.push_back(new_vp);
   //View& view_ref = view_space_.back();
   views_index_map_[new_vp.index()] = new_vp;//std::reference_wrapper<View>(view_ref);
+  recordChange(new_vp.index());
 }
 
 View ViewSpace::getAClosestNeighbour( View& _view )
@@ -268,6 +282,7 @@ void ViewSpace::loadFromFile( std::string _filename )
     
     //view_space_.push_back(new_pose);
     views_index_map_[new_pose.index()] = new_pose;//view_space_.back();
+    recordChange(new_pose.index());
   }
 }
 
@@ -296,6 +311,36 @@ bool ViewSpace::empty() const
   return views_index_map_.empty();
 }
 
+ViewSpace::VersionType ViewSpace::instance() const
+{
+  return instance_;
+}
+
+ViewSpace::VersionType ViewSpace::version() const
+{
+  return version_;
+}
+
+void ViewSpace::markChanged( View::IdType index )
+{
+  if( views_index_map_.count(index)!=0 )
+    recordChange(index);
+}
+
+void ViewSpace::changesSince( VersionType version, std::vector<View, Eigen::aligned_allocator<View> >& changed_views, IdSet& removed_ids ) const
+{
+  for( auto& change: change_versions_ )
+  {
+    if( change.second>version )
+      changed_views.push_back( views_index_map_.at(change.first) );
+  }
+  for( auto& removal: removal_versions_ )
+  {
+    if( removal.second>version )
+      removed_ids.push_back(removal.first);
+  }
+}
+
 void ViewSpace::recalculateIndexMap()
 {
   /*views_index_map_.clear();
@@ -306,6 +351,18 @@ void ViewSpace::recalculateIndexMap()
   }*/
 }
 
+void ViewSpace::recordChange( View::IdType index )
+{
+  change_versions_[index] = ++version_;
+  removal_versions_.erase(index);
+}
+
+void ViewSpace::recordRemoval( View::IdType index )
+{
+  removal_versions_[index] = ++version_;
+  change_versions_.erase(index);
+}
+
 // Iterator ***************************************************************************
   ViewSpace::Iterator::Iterator()
   {
@@ -0,0 +1,110 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "ig_active_reconstruction/weighted_ig_utility.hpp"
+
+#include <boost/smart_ptr.hpp>
+
+namespace ig_active_reconstruction
+{
+  
+  WeightedIgUtility::WeightedIgUtility( unsigned int number_of_threads )
+  : world_comm_unit_(nullptr)
+  , robot_comm_unit_(nullptr)
+  , ranking_size_(1)
+  , thread_pool_( boost::make_shared<ThreadPool>(number_of_threads) )
+  {
+    
+  }
+  
+  void WeightedIgUtility::useInformationGain( std::string name, double weight )
+  {
+    information_gains_.push_back(name);
+    ig_weights_.push_back(weight);
+  }
+  
+  void WeightedIgUtility::setIgRetrievalConfig( world_representation::CommunicationInterface::IgRetrievalConfig& config )
+  {
+    ig_retrieval_config_ = config;
+  }
+  
+  void WeightedIgUtility::setWorldCommUnit( boost::shared_ptr<world_representation::CommunicationInterface> world_comm_unit )
+  {
+    world_comm_unit_ = world_comm_unit;
+  }
+  
+  void WeightedIgUtility::setRobotCommUnit( boost::shared_ptr<robot::CommunicationInterface> robot_comm_unit )
+  {
+    robot_comm_unit_ = robot_comm_unit;
+  }
+  
+  void WeightedIgUtility::setThreadPool( boost::shared_ptr<ThreadPool> thread_pool )
+  {
+    if( thread_pool!=nullptr )
+      thread_pool_ = thread_pool;
+  }
+  
+  void WeightedIgUtility::setRankingSize( unsigned int k )
+  {
+    ranking_size_ = k;
+  }
+  
+  double WeightedIgUtility::getIg( world_representation::CommunicationInterface::IgRetrievalCommand command, views::View& view, std::vector<double>& metric_igs )
+  {
+    world_representation::CommunicationInterface::ViewIgResult information_gains;
+    
+    command.path.clear();
+    command.path.push_back( view.pose() );
+    
+    world_comm_unit_->computeViewIg(command,information_gains);
+    
+    return weightedIg(information_gains,metric_igs);
+  }
+  
+  double WeightedIgUtility::getIg( world_representation::CommunicationInterface::IgRetrievalCommand command, std::vector<views::View, Eigen::aligned_allocator<views::View> >& views, std::vector<double>& metric_igs )
+  {
+    world_representation::CommunicationInterface::ViewIgResult information_gains;
+    
+    command.path.clear();
+    for( views::View& view: views )
+    {
+      command.path.push_back( view.pose() );
+    }
+    
+    world_comm_unit_->computeViewIg(command,information_gains);
+    
+    return weightedIg(information_gains,metric_igs);
+  }
+  
+  double WeightedIgUtility::weightedIg( world_representation::CommunicationInterface::ViewIgResult& information_gains, std::vector<double>& metric_igs )
+  {
+    double ig_val = 0;
+    
+    metric_igs.assign( information_gains_.size(), 0 );
+    for( unsigned int i= 0; i<information_gains.size() && i<metric_igs.size(); ++i )
+    {
+      if( information_gains[i].status == world_representation::CommunicationInterface::ResultInformation::SUCCEEDED )
+      {
+	metric_igs[i] = information_gains[i].predicted_gain;
+	ig_val += ig_weights_[i]*information_gains[i].predicted_gain;
+      }
+    }
+    return ig_val;
+  }
+  
+}
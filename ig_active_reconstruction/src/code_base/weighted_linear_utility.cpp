@@ -17,135 +17,329 @@
 
 #include "ig_active_reconstruction/weighted_linear_utility.hpp"
 
-#include <thread>
+#include <boost/smart_ptr.hpp>
+
 #include <iostream>
+#include <limits>
+#include <algorithm>
 
 namespace ig_active_reconstruction
 {
   
-  WeightedLinearUtility::WeightedLinearUtility( double cost_weight )
-  : world_comm_unit_(nullptr)
-  , robot_comm_unit_(nullptr)
+  WeightedLinearUtility::WeightedLinearUtility( double cost_weight, unsigned int number_of_threads )
+  : WeightedIgUtility(number_of_threads)
   , cost_weight_(cost_weight)
+  , selection_mode_(SelectionMode::EXHAUSTIVE)
+  , ig_reference_scale_(0)
+  , ig_upper_bound_(0)
+  , evaluation_order_(EvaluationOrder::TIERED)
+  , time_budget_s_(0)
+  , ig_batch_size_(0)
+  , max_staleness_(0)
+  , reuse_radius_(0)
+  , iteration_(0)
+  , has_last_nbv_(false)
   {
     
   }
   
-  void WeightedLinearUtility::useInformationGain( std::string name, double weight)
+  void WeightedLinearUtility::setCostWeight( double weight )
   {
-    information_gains_.push_back(name);
-    ig_weights_.push_back(weight);
+    cost_weight_ = weight;
   }
   
-  void WeightedLinearUtility::setCostWeight( double weight )
+  void WeightedLinearUtility::setSelectionMode( SelectionMode mode )
   {
-    cost_weight_ = weight;
+    selection_mode_ = mode;
+  }
+  
+  void WeightedLinearUtility::setIgReferenceScale( double scale )
+  {
+    ig_reference_scale_ = scale;
+  }
+  
+  void WeightedLinearUtility::setIgUpperBound( double bound )
+  {
+    ig_upper_bound_ = bound;
   }
   
-  void WeightedLinearUtility::setIgRetrievalConfig( world_representation::CommunicationInterface::IgRetrievalConfig& config )
+  void WeightedLinearUtility::setEvaluationOrder( EvaluationOrder order )
   {
-    ig_retrieval_config_ = config;
+    evaluation_order_ = order;
   }
   
-  void WeightedLinearUtility::setWorldCommUnit( boost::shared_ptr<world_representation::CommunicationInterface> world_comm_unit )
+  void WeightedLinearUtility::setTimeBudget( double time_budget_s )
   {
-    world_comm_unit_ = world_comm_unit;
+    time_budget_s_ = time_budget_s;
   }
   
-  void WeightedLinearUtility::setRobotCommUnit( boost::shared_ptr<robot::CommunicationInterface> robot_comm_unit )
+  void WeightedLinearUtility::setScoreReuse( unsigned int max_staleness, double radius )
   {
-    robot_comm_unit_ = robot_comm_unit;
+    max_staleness_ = max_staleness;
+    reuse_radius_ = radius;
+  }
+  
+  void WeightedLinearUtility::setIgBatchSize( unsigned int batch_size )
+  {
+    ig_batch_size_ = batch_size;
   }
   
   views::View::IdType WeightedLinearUtility::getNbv( views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace )
   {
+    SelectionReport report;
+    return getNbv(id_set,viewspace,report);
+  }
+  
+  views::View::IdType WeightedLinearUtility::getNbv( views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace, SelectionReport& report )
+  {
+    std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+    
     // structure to store received values
-    std::vector<double> cost_vector;
-    std::vector<double> ig_vector;
+    std::vector<views::View, Eigen::aligned_allocator<views::View> > views;
+    std::vector<double> cost_vector(id_set.size(),0);
+    std::vector<double> ig_vector(id_set.size(),0);
+    std::vector< std::vector<double> > metric_igs(id_set.size());
+    std::vector<bool> is_valid(id_set.size(),true); // views with invalid costs are disregarded in calculation
+    std::vector<bool> has_ig(id_set.size(),false); // whether the information gain of a view is known
     
     double total_cost=0;
     double total_ig=0;
     
-    world_representation::CommunicationInterface::IgRetrievalCommand command;
-    command.config = ig_retrieval_config_;
-    command.metric_names = information_gains_;
-    
-    // receive costs and igs
+    views.reserve( id_set.size() );
     for( views::View::IdType& view_id: id_set )
     {
-      views::View view = viewspace->getView(view_id);
+      views.push_back( viewspace->getView(view_id) );
+    }
+    
+    // receive costs, all in one batch
+    std::chrono::steady_clock::time_point cost_retrieval_start = std::chrono::steady_clock::now();
+    if( robot_comm_unit_!=nullptr && cost_weight_!=0 )
+    {
+      views::View current_view = robot_comm_unit_->getCurrentView();
+      std::vector<robot::MovementCost> costs;
+      if( !current_view.bad() ) // costs are unknown if the current pose couldn't be determined
+	robot_comm_unit_->movementCosts( current_view, views, costs, false );
       
-      robot::MovementCost cost;
-      world_representation::CommunicationInterface::ViewIgResult information_gains;
+      for( size_t i=0; i<id_set.size(); ++i )
+      {
+	if( i>=costs.size() || costs[i].exception != robot::MovementCost::Exception::NONE )
+	{
+	  is_valid[i] = false;
+	  continue;
+	}
+	cost_vector[i] = costs[i].cost;
+	total_cost += costs[i].cost;
+      }
+    }
+    double cost_retrieval_time_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - cost_retrieval_start ).count();
+    
+    double cost_factor;
+    if( total_cost==0 )
+      cost_factor=0;
+    else
+      cost_factor = cost_weight_/total_cost;
+    
+    // precomputed and reusable information gains
+    {
+      std::lock_guard<std::mutex> lock(ig_cache_mutex_);
       
-      double cost_val = 0;
-      double ig_val = 0;
+      // drop outdated ones, precomputed ones are stamped with the current iteration
+      for( std::map<views::View::IdType,CachedScore>::iterator it = ig_cache_.begin(); it!=ig_cache_.end(); )
+      {
+	if( iteration_ - it->second.iteration > max_staleness_ )
+	  it = ig_cache_.erase(it);
+	else
+	  ++it;
+      }
       
-      // cost
-      if( robot_comm_unit_!=nullptr && cost_weight_!=0 )
+      for( views::View::IdType& id: last_ranking_ ) // contenders are always re-evaluated
       {
-	cost = robot_comm_unit_->movementCost(view);
+	ig_cache_.erase(id);
+      }
+      
+      for( size_t i=0; i<id_set.size(); ++i )
+      {
+	std::map<views::View::IdType,CachedScore>::const_iterator cached = ig_cache_.find(id_set[i]);
+	if( cached==ig_cache_.end() )
+	  continue;
 	
-	if( cost.exception != robot::MovementCost::Exception::NONE )
-	  continue; // invalid view... disregard in calculation
-	else
-	  cost_val = cost.cost;
+	if( has_last_nbv_ && (views[i].pose().position - last_nbv_position_).norm() < reuse_radius_ ) // likely affected by the new data
+	  continue;
+	
+	ig_vector[i] = cached->second.ig;
+	metric_igs[i] = cached->second.metric_igs;
+	has_ig[i] = true;
       }
+    }
+    std::vector<bool> reused = has_ig;
+    
+    std::vector<size_t> candidates; // indices of valid views
+    for( size_t i=0; i<id_set.size(); ++i )
+    {
+      if( is_valid[i] )
+	candidates.push_back(i);
+    }
+    
+    bool bounded = selection_mode_==SelectionMode::COST_BOUNDED && ig_reference_scale_>0 && ig_upper_bound_>0;
+    if( selection_mode_==SelectionMode::COST_BOUNDED && !bounded )
+      std::cout<<"\nWeightedLinearUtility: Cost bounded selection needs a reference ig scale and an ig upper bound, evaluating all views.";
+    
+    // optimistic utility: exact where the information gain is known already, using the upper bound otherwise
+    std::vector<double> optimistic_utility(id_set.size(),0);
+    if( ig_reference_scale_>0 && ig_upper_bound_>0 )
+    {
+      for( size_t& i: candidates )
+      {
+	double ig = has_ig[i]? ig_vector[i] : ig_upper_bound_;
+	optimistic_utility[i] = ig/ig_reference_scale_ - cost_factor*cost_vector[i];
+      }
+    }
+    else // without bound, cheaper views are more promising
+    {
+      for( size_t& i: candidates )
+      {
+	optimistic_utility[i] = -cost_vector[i];
+      }
+    }
+    
+    // establish evaluation order, most promising first
+    std::vector<double> distance(id_set.size(),0); // to the last nbv
+    if( has_last_nbv_ )
+    {
+      for( size_t& i: candidates )
+      {
+	distance[i] = (views[i].pose().position - last_nbv_position_).norm();
+      }
+    }
+    auto byOptimisticUtility = [&](size_t a, size_t b){ return optimistic_utility[a]>optimistic_utility[b]; };
+    auto byDistance = [&](size_t a, size_t b){ return distance[a]<distance[b]; };
+    
+    switch( evaluation_order_ )
+    {
+      case EvaluationOrder::TIERED:
+      {
+	size_t tier_size = thread_pool_->size();
+	std::vector<size_t> remaining = candidates;
+	candidates.clear();
+	
+	// cheap bound
+	std::stable_sort( remaining.begin(), remaining.end(), byOptimisticUtility );
+	size_t tier_end = std::min( tier_size, remaining.size() );
+	candidates.insert( candidates.end(), remaining.begin(), remaining.begin()+tier_end );
+	remaining.erase( remaining.begin(), remaining.begin()+tier_end );
+	
+	// last-best neighbourhood
+	if( has_last_nbv_ )
+	{
+	  std::stable_sort( remaining.begin(), remaining.end(), byDistance );
+	  tier_end = std::min( tier_size, remaining.size() );
+	  candidates.insert( candidates.end(), remaining.begin(), remaining.begin()+tier_end );
+	  remaining.erase( remaining.begin(), remaining.begin()+tier_end );
+	}
+	
+	// random
+	std::shuffle( remaining.begin(), remaining.end(), random_generator_ );
+	candidates.insert( candidates.end(), remaining.begin(), remaining.end() );
+	break;
+      }
+      case EvaluationOrder::LAST_BEST_NEIGHBOURHOOD:
+	if( has_last_nbv_ )
+	{
+	  std::stable_sort( candidates.begin(), candidates.end(), byDistance );
+	  break;
+	}
+	// no last nbv yet: use optimistic utility
+      case EvaluationOrder::OPTIMISTIC_UTILITY:
+	std::stable_sort( candidates.begin(), candidates.end(), byOptimisticUtility );
+	break;
+      case EvaluationOrder::RANDOM:
+	std::shuffle( candidates.begin(), candidates.end(), random_generator_ );
+	break;
+    };
+    
+    std::chrono::steady_clock::time_point deadline = std::chrono::steady_clock::time_point::max();
+    if( time_budget_s_>0 )
+      deadline = start_time + std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::duration<double>(time_budget_s_) );
+    
+    // retrieve information gains
+    std::chrono::steady_clock::time_point ig_retrieval_start = std::chrono::steady_clock::now();
+    size_t number_of_retrievals = 0;
+    size_t number_of_pruned = 0; // views skipped because they can't beat the best one
+    if( bounded )
+    {
+      double best_util = std::numeric_limits<double>::lowest();
+      size_t position = 0;
       
-      // information gain - non multithreaded version
-      /*if( world_comm_unit_!=nullptr )
+      while( position<candidates.size() && std::chrono::steady_clock::now()<deadline )
       {
-	command.path.clear();
-	command.path.push_back( view.pose() );
+	// evaluate the next batch of promising views in parallel, then tighten the bound
+	std::vector<size_t> batch;
+	for( ; position<candidates.size() && batch.size()<thread_pool_->size(); ++position )
+	{
+	  size_t i = candidates[position];
+	  if( optimistic_utility[i]>best_util ) // others can't beat the best one
+	    batch.push_back(i);
+	  else if( !has_ig[i] )
+	    ++number_of_pruned;
+	}
+	
+	number_of_retrievals += retrieveIgs( batch, views, ig_vector, metric_igs, has_ig, deadline );
 	
-	world_comm_unit_->computeViewIg(command,information_gains);
-	for( unsigned int i= 0; i<information_gains.size(); ++i )
+	for( size_t& i: batch )
 	{
-	  if( information_gains[i].status == world_representation::CommunicationInterface::ResultInformation::SUCCEEDED )
-	  {
-	    //std::cout<<"\nReturned gain of metric "<<i<<":"<<information_gains[i].predicted_gain;
-	    ig_val += ig_weights_[i]*information_gains[i].predicted_gain;
-	  }
+	  if( !has_ig[i] )
+	    continue;
+	  double utility = ig_vector[i]/ig_reference_scale_ - cost_factor*cost_vector[i];
+	  if( utility>best_util )
+	    best_util = utility;
 	}
-	//std::cout<<"\nReturned total information gain is: "<<ig_val;
-      }      
-      total_ig += ig_val;
-      ig_vector.push_back(ig_val);
-      */
-      total_cost += cost_val;
-      cost_vector.push_back(cost_val);
+      }
+    }
+    else
+    {
+      number_of_retrievals = retrieveIgs( candidates, views, ig_vector, metric_igs, has_ig, deadline );
     }
     
-    // multithreaded information gain retrieval
-    unsigned int number_of_threads = 8;
-    ig_vector.resize(id_set.size(),0);
-    std::vector<double> total_multitthread_ig(number_of_threads,0);
-    std::vector<std::thread> threads;
-    for( size_t i = 0; i<number_of_threads; ++i )
+    report = SelectionReport();
+    report.cost_retrieval_time_s = cost_retrieval_time_s;
+    report.ig_retrieval_time_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - ig_retrieval_start ).count();
+    report.number_of_candidates = candidates.size();
+    std::cout<<"\nWeightedLinearUtility: Retrieved the information gain of "<<number_of_retrievals<<" out of "<<candidates.size()<<" views.";
+    
+    // calculate utility and choose nbv among all views whose information gain is known
+    std::vector<size_t> evaluated;
+    for( size_t& i: candidates )
     {
-      threads.push_back( std::thread(&WeightedLinearUtility::getIg,this,std::ref(ig_vector),std::ref(total_multitthread_ig[i]),command, std::ref(id_set), viewspace, i, number_of_threads ) );
+      if( has_ig[i] )
+	evaluated.push_back(i);
     }
-    for( size_t i = 0; i<number_of_threads; ++i )
+    report.number_of_evaluated = evaluated.size();
+    report.budget_exceeded = evaluated.size()+number_of_pruned < candidates.size() && std::chrono::steady_clock::now()>=deadline;
+    
+    if( ig_reference_scale_>0 )
     {
-      threads[i].join();
-      total_ig += total_multitthread_ig[i];
+      total_ig = ig_reference_scale_;
+    }
+    else
+    {
+      for( size_t& i: evaluated )
+      {
+	total_ig += ig_vector[i];
+      }
+      if( total_ig==0 )
+	total_ig=1;
     }
     
-    // calculate utility and choose nbv
-    views::View::IdType nbv;
+    views::View::IdType nbv = id_set.empty()? 0 : id_set.front();
     double best_util = std::numeric_limits<double>::lowest();
     
-    double cost_factor;
-    
-    if( total_ig==0 )
-      total_ig=1;
-    
-    if( total_cost==0 )
-      cost_factor=0;
-    else
-      cost_factor = cost_weight_/total_cost;
+    if( evaluated.empty() && !candidates.empty() ) // no time for any evaluation: take the most promising one
+    {
+      nbv = id_set[ candidates.front() ];
+      best_util = -cost_factor*cost_vector[ candidates.front() ]; // its utility without information gain
+    }
     
-    for( unsigned int i=0; i<id_set.size(); ++i )
+    for( size_t& i: evaluated )
     {
       double utility = ig_vector[i]/total_ig - cost_factor*cost_vector[i];
       std::cout<<"\nutility of view "<<id_set[i]<<": "<<utility;
@@ -155,44 +349,222 @@ namespace ig_active_reconstruction
 	nbv = id_set[i];
       }
     }
+    
+    report.nbv = nbv;
+    report.utility = best_util;
+    
+    // rank the evaluated views
+    std::vector<double> utility(id_set.size(),0);
+    for( size_t& i: evaluated )
+    {
+      utility[i] = ig_vector[i]/total_ig - cost_factor*cost_vector[i];
+    }
+    size_t ranking_size = std::min<size_t>( ranking_size_, evaluated.size() );
+    std::partial_sort( evaluated.begin(), evaluated.begin()+ranking_size, evaluated.end(), [&](size_t a, size_t b){ return utility[a]>utility[b]; } );
+    
+    last_ranking_.clear();
+    for( size_t r=0; r<ranking_size; ++r )
+    {
+      size_t i = evaluated[r];
+      
+      ViewScore score;
+      score.id = id_set[i];
+      score.utility = utility[i];
+      score.information_gain = ig_vector[i];
+      score.cost = cost_vector[i];
+      score.metric_igs = metric_igs[i];
+      score.reused = reused[i];
+      report.ranking.push_back(score);
+      
+      last_ranking_.push_back(id_set[i]);
+    }
+    
+    // keep retrieved information gains for reuse
+    {
+      std::lock_guard<std::mutex> lock(ig_cache_mutex_);
+      
+      // they were computed on the map that a following precompute() call scores on, thus it only needs to fill the gaps
+      last_retrieved_.clear();
+      for( size_t& i: candidates )
+      {
+	if( !has_ig[i] || reused[i] )
+	  continue;
+	
+	CachedScore& retrieved = last_retrieved_[ id_set[i] ];
+	retrieved.ig = ig_vector[i];
+	retrieved.metric_igs = metric_igs[i];
+	retrieved.iteration = iteration_;
+      }
+      
+      if( max_staleness_>0 )
+      {
+	for( size_t& i: candidates )
+	{
+	  if( !has_ig[i] || reused[i] )
+	    continue;
+	  
+	  CachedScore& cached = ig_cache_[ id_set[i] ];
+	  cached.ig = ig_vector[i];
+	  cached.metric_igs = metric_igs[i];
+	  cached.iteration = iteration_;
+	}
+      }
+      ++iteration_;
+    }
+    
+    if( viewspace->size()!=0 && !id_set.empty() )
+    {
+      has_last_nbv_ = true;
+      last_nbv_position_ = viewspace->getView(nbv).pose().position;
+    }
     //std::cout<<"\nChoosing view "<<nbv<<".";
     return nbv;
   }
   
-  void WeightedLinearUtility::getIg(std::vector<double>& ig_vector,double& total_ig, world_representation::CommunicationInterface::IgRetrievalCommand command, views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace, unsigned int base_index, unsigned int batch_size )
+  void WeightedLinearUtility::precompute( views::ViewSpace::IdSet& id_set, boost::shared_ptr<views::ViewSpace> viewspace, const std::atomic<bool>& abort )
   {
+    if( world_comm_unit_==nullptr )
+      return;
+    
+    world_representation::CommunicationInterface::IgRetrievalCommand command;
+    command.config = ig_retrieval_config_;
+    command.metric_names = information_gains_;
     
-    // information gain
-    if( world_comm_unit_!=nullptr )
+    // views scored by the last getNbv call are taken over, only those it skipped are retrieved
+    std::vector<size_t> missing;
     {
-      for( size_t i = base_index; i<id_set.size(); i+=batch_size )
-      {	
-	views::View view = viewspace->getView( id_set[i] );
-	
-	world_representation::CommunicationInterface::ViewIgResult information_gains;
-	double ig_val = 0;
-	
-	command.path.clear();
-	command.path.push_back( view.pose() );
-	
-	world_comm_unit_->computeViewIg(command,information_gains);
+      std::lock_guard<std::mutex> lock(ig_cache_mutex_);
+      for( size_t i=0; i<id_set.size(); ++i )
+      {
+	std::map<views::View::IdType,CachedScore>::const_iterator cached = ig_cache_.find(id_set[i]);
+	if( cached!=ig_cache_.end() && cached->second.iteration==iteration_ )
+	  continue;
 	
-	for( unsigned int i= 0; i<information_gains.size(); ++i )
+	std::map<views::View::IdType,CachedScore>::const_iterator retrieved = last_retrieved_.find(id_set[i]);
+	if( retrieved!=last_retrieved_.end() )
 	{
-	  if( information_gains[i].status == world_representation::CommunicationInterface::ResultInformation::SUCCEEDED )
-	  {
-	    //std::cout<<"\nReturned gain of metric "<<i<<":"<<information_gains[i].predicted_gain;
-	    ig_val += ig_weights_[i]*information_gains[i].predicted_gain;
-	  }
+	  CachedScore& seeded = ig_cache_[id_set[i]];
+	  seeded = retrieved->second;
+	  seeded.iteration = iteration_; // for the next getNbv call
+	  continue;
 	}
-	total_ig += ig_val;
-	ig_vector[i] = ig_val;
+	missing.push_back(i);
       }
-      return;
     }
-    else
-      return;
+    
+    thread_pool_->parallelFor( missing.size(), [&](size_t j)
+    {
+      if( abort )
+	return;
+      
+      size_t i = missing[j];
+      views::View view = viewspace->getView( id_set[i] );
+      std::vector<double> metric_igs;
+      double ig = getIg(command,view,metric_igs);
+      
+      std::lock_guard<std::mutex> lock(ig_cache_mutex_);
+      CachedScore& cached = ig_cache_[id_set[i]];
+      cached.ig = ig;
+      cached.metric_igs = metric_igs;
+      cached.iteration = iteration_; // computed for the next getNbv call
+    });
   }
+  
+  void WeightedLinearUtility::invalidate( views::ViewSpace::IdSet& id_set )
+  {
+    std::lock_guard<std::mutex> lock(ig_cache_mutex_);
+    for( views::View::IdType& id: id_set )
+    {
+      ig_cache_.erase(id);
+      last_retrieved_.erase(id);
+    }
+  }
+  
+  size_t WeightedLinearUtility::retrieveIgs( std::vector<size_t>& indices, std::vector<views::View, Eigen::aligned_allocator<views::View> >& views, std::vector<double>& ig_vector, std::vector< std::vector<double> >& metric_igs, std::vector<bool>& has_ig, std::chrono::steady_clock::time_point deadline )
+  {
+    if( world_comm_unit_==nullptr )
+      return 0;
+    
+    if( ig_batch_size_>0 )
+      return retrieveIgBatches( indices, views, ig_vector, metric_igs, has_ig, deadline );
+    
+    world_representation::CommunicationInterface::IgRetrievalCommand command;
+    command.config = ig_retrieval_config_;
+    command.metric_names = information_gains_;
     
+    std::vector<char> retrieved( indices.size(), 0 ); // written concurrently, thus not vector<bool>
+    std::atomic<size_t> number_of_retrievals(0);
+    thread_pool_->parallelFor( indices.size(), [&](size_t j)
+    {
+      size_t i = indices[j];
+      if( has_ig[i] || std::chrono::steady_clock::now()>=deadline )
+	return;
+      
+      ig_vector[i] = getIg(command,views[i],metric_igs[i]);
+      retrieved[j] = 1;
+      ++number_of_retrievals;
+    });
+    
+    for( size_t j=0; j<indices.size(); ++j )
+    {
+      if( retrieved[j] )
+	has_ig[ indices[j] ] = true;
+    }
+    return number_of_retrievals;
+  }
+  
+  size_t WeightedLinearUtility::retrieveIgBatches( std::vector<size_t>& indices, std::vector<views::View, Eigen::aligned_allocator<views::View> >& views, std::vector<double>& ig_vector, std::vector< std::vector<double> >& metric_igs, std::vector<bool>& has_ig, std::chrono::steady_clock::time_point deadline )
+  {
+    std::vector<size_t> missing;
+    for( size_t& i: indices )
+    {
+      if( !has_ig[i] )
+	missing.push_back(i);
+    }
+    
+    size_t number_of_batches = (missing.size()+ig_batch_size_-1)/ig_batch_size_;
+    std::vector<char> retrieved( number_of_batches, 0 ); // written concurrently, thus not vector<bool>
+    thread_pool_->parallelFor( number_of_batches, [&](size_t b)
+    {
+      if( std::chrono::steady_clock::now()>=deadline )
+	return;
+      
+      size_t begin = b*ig_batch_size_;
+      size_t end = std::min<size_t>( begin+ig_batch_size_, missing.size() );
+      
+      world_representation::CommunicationInterface::ViewspaceIgRetrievalCommand command;
+      command.config = ig_retrieval_config_;
+      command.metric_names = information_gains_;
+      for( size_t j=begin; j<end; ++j )
+      {
+	command.poses.push_back( views[ missing[j] ].pose() );
+      }
+      
+      world_representation::CommunicationInterface::ViewspaceIgResult information_gains;
+      world_comm_unit_->computeViewspaceIg(command,information_gains);
+      information_gains.resize( end-begin );
+      
+      for( size_t j=begin; j<end; ++j )
+      {
+	size_t i = missing[j];
+	ig_vector[i] = weightedIg( information_gains[j-begin], metric_igs[i] );
+      }
+      retrieved[b] = 1;
+    });
+    
+    size_t number_of_retrievals = 0;
+    for( size_t b=0; b<number_of_batches; ++b )
+    {
+      if( !retrieved[b] )
+	continue;
+      
+      for( size_t j=b*ig_batch_size_; j<missing.size() && j<(b+1)*ig_batch_size_; ++j )
+      {
+	has_ig[ missing[j] ] = true;
+	++number_of_retrievals;
+      }
+    }
+    return number_of_retrievals;
+  }
   
 }
\ No newline at end of file
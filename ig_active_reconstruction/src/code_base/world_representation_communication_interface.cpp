@@ -41,6 +41,31 @@ namespace world_representation
   {
   }
   
+  CommunicationInterface::ViewspaceIgRetrievalCommand::ViewspaceIgRetrievalCommand()
+  : config()
+  {
+  }
+  
+  CommunicationInterface::ResultInformation CommunicationInterface::computeViewspaceIg(ViewspaceIgRetrievalCommand& command, ViewspaceIgResult& output_ig)
+  {
+    IgRetrievalCommand view_command;
+    view_command.metric_names = command.metric_names;
+    view_command.metric_ids = command.metric_ids;
+    view_command.config = command.config;
+    
+    output_ig.clear();
+    output_ig.reserve( command.poses.size() );
+    for( movements::Pose& pose: command.poses )
+    {
+      view_command.path.clear();
+      view_command.path.push_back(pose);
+      
+      output_ig.push_back( ViewIgResult() );
+      computeViewIg( view_command, output_ig.back() );
+    }
+    return ResultInformation::SUCCEEDED;
+  }
+  
 }
 
 
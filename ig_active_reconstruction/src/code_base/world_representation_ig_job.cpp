@@ -0,0 +1,250 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "ig_active_reconstruction/world_representation_ig_job.hpp"
+
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <exception>
+#include <algorithm>
+
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+  
+  class IgJob::Impl
+  {
+  public:
+    Impl( boost::shared_ptr<CommunicationInterface> world_comm, const CommunicationInterface::ViewspaceIgRetrievalCommand& command, unsigned int views_per_step );
+    
+    //! Marks the job as finished, mutex must be held.
+    void finish( Status::Enum final_status );
+    
+  public:
+    boost::shared_ptr<CommunicationInterface> world_comm;
+    CommunicationInterface::ViewspaceIgRetrievalCommand command;
+    size_t views_per_step;
+    ViewCallback view_callback;
+    
+    mutable std::mutex mutex; //! Guards all members below.
+    std::condition_variable finished_signal;
+    CommunicationInterface::ViewspaceIgResult output_ig;
+    std::vector<bool> computed;
+    size_t next_view; //! First view of the next chunk that hasn't been reserved by a step yet.
+    size_t number_of_computed_views;
+    size_t steps_in_progress; //! Number of steps that are computing their chunk.
+    Status::Enum status;
+    bool finished;
+    bool cancel_requested;
+    std::thread worker;
+  };
+  
+  IgJob::Impl::Impl( boost::shared_ptr<CommunicationInterface> world_comm, const CommunicationInterface::ViewspaceIgRetrievalCommand& command, unsigned int views_per_step )
+  : world_comm(world_comm)
+  , command(command)
+  , views_per_step( std::max(views_per_step,1u) )
+  , output_ig( command.poses.size() )
+  , computed( command.poses.size(), false )
+  , next_view(0)
+  , number_of_computed_views(0)
+  , steps_in_progress(0)
+  , status(Status::PENDING)
+  , finished(false)
+  , cancel_requested(false)
+  {
+  }
+  
+  void IgJob::Impl::finish( Status::Enum final_status )
+  {
+    status = final_status;
+    finished = true;
+    finished_signal.notify_all();
+  }
+  
+  IgJob::IgJob( boost::shared_ptr<CommunicationInterface> world_comm, const CommunicationInterface::ViewspaceIgRetrievalCommand& command, unsigned int views_per_step )
+  : impl_( new Impl(world_comm,command,views_per_step) )
+  {
+  }
+  
+  IgJob::~IgJob()
+  {
+    cancel();
+    if( impl_->worker.joinable() )
+      impl_->worker.join();
+  }
+  
+  void IgJob::setViewCallback( ViewCallback callback )
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->view_callback = callback;
+  }
+  
+  bool IgJob::step()
+  {
+    CommunicationInterface::ViewspaceIgRetrievalCommand chunk_command;
+    size_t first_view, end_view;
+    ViewCallback view_callback;
+    {
+      std::lock_guard<std::mutex> lock(impl_->mutex);
+      if( impl_->finished )
+	return false;
+      
+      if( impl_->cancel_requested || impl_->next_view==impl_->command.poses.size() )
+      {
+	// the last step that is still computing its chunk finishes the job otherwise
+	if( impl_->steps_in_progress==0 )
+	  impl_->finish( impl_->cancel_requested?Status::CANCELLED:Status::SUCCEEDED );
+	return false;
+      }
+      
+      // the chunk is reserved before the lock is released, such that concurrent steps never compute the same views
+      first_view = impl_->next_view;
+      end_view = std::min( first_view+impl_->views_per_step, impl_->command.poses.size() );
+      impl_->next_view = end_view;
+      ++impl_->steps_in_progress;
+      view_callback = impl_->view_callback;
+    }
+    
+    // the command is never changed after construction, thus it can be read without holding the lock
+    chunk_command.metric_names = impl_->command.metric_names;
+    chunk_command.metric_ids = impl_->command.metric_ids;
+    chunk_command.config = impl_->command.config;
+    chunk_command.poses.assign( impl_->command.poses.begin()+first_view, impl_->command.poses.begin()+end_view );
+    
+    CommunicationInterface::ViewspaceIgResult chunk_result;
+    try
+    {
+      impl_->world_comm->computeViewspaceIg(chunk_command,chunk_result);
+    }
+    catch( std::exception& )
+    {
+      std::lock_guard<std::mutex> lock(impl_->mutex);
+      --impl_->steps_in_progress;
+      if( !impl_->finished )
+	impl_->finish(Status::FAILED);
+      return false;
+    }
+    chunk_result.resize( end_view-first_view ); // views without result are reported as computed but empty
+    
+    {
+      std::lock_guard<std::mutex> lock(impl_->mutex);
+      if( impl_->finished ) // another step failed in the meantime, the results of a finished job don't change anymore
+      {
+	--impl_->steps_in_progress;
+	return false;
+      }
+      for( size_t i=0; i<chunk_result.size(); ++i )
+      {
+	impl_->output_ig[first_view+i].swap(chunk_result[i]);
+	impl_->computed[first_view+i] = true;
+      }
+      impl_->number_of_computed_views += end_view-first_view;
+      impl_->status = Status::RUNNING;
+    }
+    
+    if( view_callback )
+    {
+      // results of computed views are never changed anymore
+      for( size_t view=first_view; view<end_view; ++view )
+	view_callback( view, impl_->output_ig[view] );
+    }
+    
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    --impl_->steps_in_progress;
+    if( impl_->steps_in_progress==0 )
+    {
+      if( impl_->number_of_computed_views==impl_->command.poses.size() )
+      {
+	impl_->finish(Status::SUCCEEDED);
+	return false;
+      }
+      if( impl_->cancel_requested )
+      {
+	impl_->finish(Status::CANCELLED);
+	return false;
+      }
+    }
+    return !impl_->cancel_requested && impl_->next_view<impl_->command.poses.size();
+  }
+  
+  void IgJob::start()
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    if( impl_->worker.joinable() || impl_->finished )
+      return;
+    
+    impl_->worker = std::thread( [this](){ while( step() ){} } );
+  }
+  
+  void IgJob::cancel()
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    impl_->cancel_requested = true;
+  }
+  
+  void IgJob::wait()
+  {
+    std::unique_lock<std::mutex> lock(impl_->mutex);
+    impl_->finished_signal.wait( lock, [this](){ return impl_->finished; } );
+  }
+  
+  bool IgJob::waitFor( double timeout_s )
+  {
+    std::unique_lock<std::mutex> lock(impl_->mutex);
+    return impl_->finished_signal.wait_for( lock, std::chrono::duration<double>(timeout_s), [this](){ return impl_->finished; } );
+  }
+  
+  bool IgJob::isFinished() const
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->finished;
+  }
+  
+  IgJob::Status::Enum IgJob::status() const
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->status;
+  }
+  
+  size_t IgJob::numberOfViews() const
+  {
+    return impl_->command.poses.size();
+  }
+  
+  size_t IgJob::numberOfComputedViews() const
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    return impl_->number_of_computed_views;
+  }
+  
+  void IgJob::results( CommunicationInterface::ViewspaceIgResult& output_ig, std::vector<bool>& computed ) const
+  {
+    std::lock_guard<std::mutex> lock(impl_->mutex);
+    output_ig = impl_->output_ig;
+    computed = impl_->computed;
+  }
+  
+}
+
+}
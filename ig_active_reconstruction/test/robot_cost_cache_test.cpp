@@ -0,0 +1,246 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+#include <gtest/gtest.h>
+#include <boost/make_shared.hpp>
+
+#include "ig_active_reconstruction/robot_cost_cache_ci.hpp"
+
+using namespace ig_active_reconstruction;
+
+namespace
+{
+  typedef std::vector<views::View, Eigen::aligned_allocator<views::View> > ViewVector;
+  
+  /*! Robot interface that returns the distance between views as cost and counts the requests it receives.
+   */
+  class CountingRobot: public robot::CommunicationInterface
+  {
+  public:
+    CountingRobot()
+    : cost_requests(0)
+    , move_succeeds(true)
+    {
+      current_view.nonViewSpace() = true;
+    }
+    
+    virtual views::View getCurrentView()
+    {
+      return current_view;
+    }
+    
+    virtual ReceptionInfo retrieveData()
+    {
+      return ReceptionInfo::SUCCEEDED;
+    }
+    
+    virtual robot::MovementCost movementCost( views::View& target_view )
+    {
+      return movementCost(current_view,target_view,false);
+    }
+    
+    virtual robot::MovementCost movementCost( views::View& start_view, views::View& target_view, bool fill_additional_information )
+    {
+      ++cost_requests;
+      robot::MovementCost cost;
+      if( target_view.bad() )
+      {
+	cost.exception = robot::MovementCost::Exception::COST_UNKNOWN;
+	return cost;
+      }
+      cost.cost = (start_view.pose().position - target_view.pose().position).norm();
+      return cost;
+    }
+    
+    virtual bool moveTo( views::View& target_view )
+    {
+      if( move_succeeds )
+      {
+	current_view = target_view;
+	current_view.nonViewSpace() = true;
+      }
+      return move_succeeds;
+    }
+    
+  public:
+    size_t cost_requests;
+    bool move_succeeds;
+    views::View current_view;
+  };
+  
+  views::View viewAt( views::View::IdType id, double x )
+  {
+    views::View view(id);
+    view.pose().position = Eigen::Vector3d(x,0,0);
+    return view;
+  }
+}
+
+TEST(CostCacheCI, CachesCostsBetweenViewspaceViews)
+{
+  boost::shared_ptr<CountingRobot> robot = boost::make_shared<CountingRobot>();
+  robot::CostCacheCI cache(robot);
+  
+  views::View a = viewAt(0,0), b = viewAt(1,2);
+  EXPECT_DOUBLE_EQ( 2, cache.movementCost(a,b,false).cost );
+  EXPECT_DOUBLE_EQ( 2, cache.movementCost(a,b,false).cost );
+  EXPECT_EQ( 1u, robot->cost_requests );
+  EXPECT_EQ( 1u, cache.hits() );
+  EXPECT_EQ( 1u, cache.misses() );
+  
+  // not symmetric by default
+  cache.movementCost(b,a,false);
+  EXPECT_EQ( 2u, robot->cost_requests );
+  EXPECT_EQ( 2u, cache.size() );
+}
+
+TEST(CostCacheCI, SymmetricModeStoresOneEntryPerPair)
+{
+  boost::shared_ptr<CountingRobot> robot = boost::make_shared<CountingRobot>();
+  robot::CostCacheCI::Config config;
+  config.symmetric = true;
+  robot::CostCacheCI cache(robot,config);
+  
+  views::View a = viewAt(0,0), b = viewAt(1,3);
+  cache.movementCost(a,b,false);
+  EXPECT_DOUBLE_EQ( 3, cache.movementCost(b,a,false).cost );
+  EXPECT_EQ( 1u, robot->cost_requests );
+  EXPECT_EQ( 1u, cache.size() );
+}
+
+TEST(CostCacheCI, DoesNotCacheNonViewspaceViews)
+{
+  boost::shared_ptr<CountingRobot> robot = boost::make_shared<CountingRobot>();
+  robot::CostCacheCI cache(robot);
+  
+  // same id as a viewspace view, but a different pose: must never be served from or stored in the cache
+  views::View current = viewAt(1,5);
+  current.nonViewSpace() = true;
+  views::View a = viewAt(0,0), b = viewAt(1,2);
+  
+  cache.movementCost(a,b,false);
+  EXPECT_DOUBLE_EQ( 5, cache.movementCost(current,a,false).cost );
+  EXPECT_DOUBLE_EQ( 5, cache.movementCost(a,current,false).cost );
+  EXPECT_EQ( 3u, robot->cost_requests );
+  EXPECT_EQ( 1u, cache.size() );
+}
+
+TEST(CostCacheCI, DoesNotCacheUnknownCosts)
+{
+  boost::shared_ptr<CountingRobot> robot = boost::make_shared<CountingRobot>();
+  robot::CostCacheCI cache(robot);
+  
+  views::View a = viewAt(0,0), b = viewAt(1,2);
+  b.bad() = true;
+  cache.movementCost(a,b,false);
+  EXPECT_EQ( robot::MovementCost::Exception::COST_UNKNOWN, cache.movementCost(a,b,false).exception );
+  EXPECT_EQ( 2u, robot->cost_requests );
+  EXPECT_EQ( 0u, cache.size() );
+}
+
+TEST(CostCacheCI, DropsLeastRecentlyUsedEntries)
+{
+  boost::shared_ptr<CountingRobot> robot = boost::make_shared<CountingRobot>();
+  robot::CostCacheCI::Config config;
+  config.max_entries = 2;
+  robot::CostCacheCI cache(robot,config);
+  
+  views::View a = viewAt(0,0), b = viewAt(1,1), c = viewAt(2,2), d = viewAt(3,3);
+  cache.movementCost(a,b,false);
+  cache.movementCost(a,c,false);
+  cache.movementCost(a,b,false); // (a,c) is now the least recently used
+  cache.movementCost(a,d,false);
+  EXPECT_EQ( 2u, cache.size() );
+  EXPECT_EQ( 3u, robot->cost_requests );
+  
+  cache.movementCost(a,b,false);
+  EXPECT_EQ( 3u, robot->cost_requests );
+  cache.movementCost(a,c,false);
+  EXPECT_EQ( 4u, robot->cost_requests );
+}
+
+TEST(CostCacheCI, BatchRequestsOnlyMissingCosts)
+{
+  boost::shared_ptr<CountingRobot> robot = boost::make_shared<CountingRobot>();
+  robot::CostCacheCI cache(robot);
+  
+  views::View a = viewAt(0,0);
+  ViewVector targets;
+  targets.push_back( viewAt(1,1) );
+  targets.push_back( viewAt(2,2) );
+  targets.push_back( viewAt(3,3) );
+  
+  cache.movementCost(a,targets[1],false);
+  
+  std::vector<robot::MovementCost> costs;
+  cache.movementCosts(a,targets,costs,false);
+  ASSERT_EQ( 3u, costs.size() );
+  EXPECT_DOUBLE_EQ( 1, costs[0].cost );
+  EXPECT_DOUBLE_EQ( 2, costs[1].cost );
+  EXPECT_DOUBLE_EQ( 3, costs[2].cost );
+  EXPECT_EQ( 3u, robot->cost_requests );
+}
+
+TEST(CostCacheCI, TracksTheCurrentViewAcrossMovements)
+{
+  boost::shared_ptr<CountingRobot> robot = boost::make_shared<CountingRobot>();
+  robot::CostCacheCI cache(robot);
+  
+  views::View a = viewAt(0,0), b = viewAt(1,4);
+  
+  // unknown current view: forwarded and not cached
+  EXPECT_TRUE( cache.getCurrentView().nonViewSpace() );
+  cache.movementCost(b);
+  cache.movementCost(b);
+  EXPECT_EQ( 2u, robot->cost_requests );
+  
+  ASSERT_TRUE( cache.moveTo(a) );
+  EXPECT_EQ( a.index(), cache.getCurrentView().index() );
+  EXPECT_FALSE( cache.getCurrentView().nonViewSpace() );
+  EXPECT_DOUBLE_EQ( 4, cache.movementCost(b).cost );
+  EXPECT_DOUBLE_EQ( 4, cache.movementCost(b).cost );
+  EXPECT_EQ( 3u, robot->cost_requests );
+  
+  // after a failed movement the robot might be anywhere
+  robot->move_succeeds = false;
+  EXPECT_FALSE( cache.moveTo(b) );
+  EXPECT_TRUE( cache.getCurrentView().nonViewSpace() );
+}
+
+TEST(CostCacheCI, InvalidatesSingleViews)
+{
+  boost::shared_ptr<CountingRobot> robot = boost::make_shared<CountingRobot>();
+  robot::CostCacheCI cache(robot);
+  
+  views::View a = viewAt(0,0), b = viewAt(1,1), c = viewAt(2,2);
+  cache.movementCost(a,b,false);
+  cache.movementCost(c,b,false);
+  cache.movementCost(a,c,false);
+  
+  cache.invalidate(b.index());
+  EXPECT_EQ( 1u, cache.size() );
+  
+  cache.invalidate();
+  EXPECT_EQ( 0u, cache.size() );
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
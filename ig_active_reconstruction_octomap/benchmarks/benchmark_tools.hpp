@@ -0,0 +1,130 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <cmath>
+#include <fstream>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <movements/core>
+
+namespace ig_active_reconstruction
+{
+  
+namespace benchmarks
+{
+  
+  /*! Measures wall-clock time.
+   */
+  class Timer
+  {
+  public:
+    /*! Constructor, starts the timer.
+     */
+    Timer()
+    : start_( boost::posix_time::microsec_clock::universal_time() )
+    {}
+    
+    /*! Restarts the timer.
+     */
+    void restart()
+    {
+      start_ = boost::posix_time::microsec_clock::universal_time();
+    }
+    
+    /*! Returns the seconds that passed since the timer was (re)started.
+     */
+    double elapsedS() const
+    {
+      return (boost::posix_time::microsec_clock::universal_time() - start_).total_microseconds()*1e-6;
+    }
+    
+  private:
+    boost::posix_time::ptime start_;
+  };
+  
+  /*! Returns count/duration_s, or 0 for an empty duration.
+   */
+  inline double perSecond( double count, double duration_s )
+  {
+    return (duration_s>0)? count/duration_s : 0;
+  }
+  
+  /*! Returns the peak resident memory of the process so far [MB].
+   */
+  inline double peakResidentMemoryMb()
+  {
+    struct rusage usage;
+    if( getrusage(RUSAGE_SELF,&usage)!=0 )
+      return 0;
+    return usage.ru_maxrss/1024.0; // [kB] on Linux
+  }
+  
+  /*! Returns the current resident memory of the process [MB], 0 if it can't be determined (Linux only).
+   */
+  inline double residentMemoryMb()
+  {
+    std::ifstream statm("/proc/self/statm");
+    long total_pages, resident_pages;
+    if( !(statm>>total_pages>>resident_pages) )
+      return 0;
+    return resident_pages*(sysconf(_SC_PAGESIZE)/1048576.0);
+  }
+  
+  /*! Prints a section title.
+   */
+  inline void printSection( std::string title )
+  {
+    std::cout<<"\n\n"<<title<<"\n"<<std::string(title.size(),'-');
+  }
+  
+  /*! Returns the pose of a camera (optical axis along z) at the given position that looks at the target.
+   */
+  inline movements::Pose lookAt( Eigen::Vector3d position, Eigen::Vector3d target )
+  {
+    return movements::Pose( position, Eigen::Quaterniond::FromTwoVectors( Eigen::Vector3d::UnitZ(), target-position ) );
+  }
+  
+  /*! Returns poses evenly distributed on (an arc of) a horizontal circle around the origin, all looking at the origin.
+   * @param number Number of poses.
+   * @param radius_m Radius of the circle [m].
+   * @param height_m Height of the circle [m].
+   * @param start_angle_rad Angle of the first pose [rad].
+   * @param arc_rad Angle covered by the poses [rad], the complete circle by default.
+   */
+  inline movements::PoseVector ringPoses( unsigned int number, double radius_m, double height_m, double start_angle_rad = 0, double arc_rad = 2*M_PI )
+  {
+    movements::PoseVector poses;
+    for( unsigned int i=0; i<number; ++i )
+    {
+      double angle = start_angle_rad + arc_rad*i/number;
+      poses.push_back( lookAt( Eigen::Vector3d( radius_m*std::cos(angle), radius_m*std::sin(angle), height_m ), Eigen::Vector3d(0,0,0) ) );
+    }
+    return poses;
+  }
+  
+}
+
+}
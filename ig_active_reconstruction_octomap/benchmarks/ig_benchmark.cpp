@@ -0,0 +1,369 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <cstdlib>
+
+#include <boost/make_shared.hpp>
+#include <boost/thread/thread.hpp>
+
+#include "ig_active_reconstruction_octomap/octomap_ig_tree_world_representation.hpp"
+#include "ig_active_reconstruction_octomap/octomap_ray_occlusion_calculator.hpp"
+#include "ig_active_reconstruction_octomap/octomap_std_pcl_input_point_xyz.hpp"
+#include "ig_active_reconstruction_octomap/octomap_basic_ray_ig_calculator.hpp"
+#include "ig_active_reconstruction_octomap/octomap_simulated_sensor.hpp"
+#include "ig_active_reconstruction_octomap/octomap_session_log.hpp"
+#include "ig_active_reconstruction_octomap/ig/occlusion_aware.hpp"
+#include "ig_active_reconstruction_octomap/ig/unobserved_voxel.hpp"
+#include "ig_active_reconstruction_octomap/ig/rear_side_voxel.hpp"
+#include "ig_active_reconstruction_octomap/ig/rear_side_entropy.hpp"
+#include "ig_active_reconstruction_octomap/ig/proximity_count.hpp"
+#include "ig_active_reconstruction_octomap/ig/vasquez_gomez_area_factor.hpp"
+#include "ig_active_reconstruction_octomap/ig/average_entropy.hpp"
+
+#include "benchmark_tools.hpp"
+
+namespace iar = ig_active_reconstruction;
+namespace oct = ig_active_reconstruction::world_representation::octomap;
+namespace bm = ig_active_reconstruction::benchmarks;
+
+typedef oct::IgTreeWorldRepresentation WorldRepresentation;
+typedef WorldRepresentation::TreeType TreeType;
+typedef oct::StdPclInputPointXYZ<TreeType>::PclType PclType;
+typedef oct::InformationGain<TreeType> Ig;
+typedef iar::world_representation::CommunicationInterface WorldComm;
+typedef iar::world_representation::RayCaster RayCaster;
+typedef iar::world_representation::PinholeCamRayCaster PinholeCamRayCaster;
+
+/*! Information gain that only counts the voxels it is handed, used as reference for the number of traversed voxels and
+ * to measure the cost of the traversal itself.
+ */
+template<class TREE_TYPE>
+class TraversalCount: public oct::InformationGain<TREE_TYPE>
+{
+public:
+  typedef typename oct::InformationGain<TREE_TYPE>::GainType GainType;
+  typedef typename oct::InformationGain<TREE_TYPE>::Config Config;
+  
+public:
+  TraversalCount( Config config = Config() ): voxel_count_(0){}
+  virtual std::string type(){ return "TraversalCount"; }
+  virtual GainType getInformation(){ return voxel_count_; }
+  virtual void makeReadyForNewRay(){}
+  virtual void reset(){ voxel_count_ = 0; }
+  virtual void includeRayMeasurement( typename TREE_TYPE::NodeType* node ){ ++voxel_count_; }
+  virtual void includeEndPointMeasurement( typename TREE_TYPE::NodeType* node ){ ++voxel_count_; }
+  virtual void informAboutVoidRay(){}
+  virtual uint64_t voxelCount(){ return voxel_count_; }
+  
+private:
+  uint64_t voxel_count_;
+};
+
+/*! Exposes the ray casting of the information gain calculator, such that single information gains can be measured on
+ * precomputed rays.
+ */
+template<class TREE_TYPE>
+class BenchmarkIgCalculator: public oct::BasicRayIgCalculator<TREE_TYPE>
+{
+public:
+  typedef typename oct::BasicRayIgCalculator<TREE_TYPE>::Config Config;
+  
+public:
+  BenchmarkIgCalculator( Config config = Config() ): oct::BasicRayIgCalculator<TREE_TYPE>(config){}
+  
+  /*! Casts all rays of a ray set and includes the traversed voxels in the given information gains.
+   */
+  void castRays( RayCaster::RaySet& ray_set, std::vector< boost::shared_ptr< oct::InformationGain<TREE_TYPE> > >& ig_set )
+  {
+    typename oct::BasicRayIgCalculator<TREE_TYPE>::RayCastSettings settings;
+    settings.max_ray_depth = this->config_.ray_caster_config.max_ray_depth_m;
+    
+    for( size_t i=0; i<ray_set.size(); ++i )
+    {
+      for( size_t j=0; j<ig_set.size(); ++j )
+	ig_set[j]->makeReadyForNewRay();
+      this->calculateIgsOnRay( ray_set[i], ig_set, settings );
+    }
+  }
+};
+
+//! Prints a row of the results table.
+static void printRow( std::string name, double duration_s, double rays, double voxels )
+{
+  std::cout<<"\n"<<std::left<<std::setw(28)<<name<<std::right
+	   <<std::setw(12)<<std::fixed<<std::setprecision(4)<<duration_s
+	   <<std::setw(16)<<std::setprecision(0)<<bm::perSecond(rays,duration_s)
+	   <<std::setw(16)<<bm::perSecond(voxels,duration_s);
+}
+
+//! Prints the header of the results table.
+static void printHeader()
+{
+  std::cout<<"\n"<<std::left<<std::setw(28)<<"benchmark"<<std::right<<std::setw(12)<<"time [s]"<<std::setw(16)<<"rays/s"<<std::setw(16)<<"voxels/s";
+}
+
+//! Registers all information gains, in the same order as the octomap world representation node.
+static void registerInformationGains( BenchmarkIgCalculator<TreeType>& ig_calculator, Ig::Config config )
+{
+  ig_calculator.registerInformationGain<oct::OcclusionAwareIg>(config);
+  ig_calculator.registerInformationGain<oct::UnobservedVoxelIg>(config);
+  ig_calculator.registerInformationGain<oct::RearSideVoxelIg>(config);
+  ig_calculator.registerInformationGain<oct::RearSideEntropyIg>(config);
+  ig_calculator.registerInformationGain<oct::ProximityCountIg>(config);
+  ig_calculator.registerInformationGain<oct::VasquezGomezAreaFactorIg>(config);
+  ig_calculator.registerInformationGain<oct::AverageEntropyIg>(config);
+}
+
+//! Creates an information gain by name, or the traversal counter.
+static boost::shared_ptr<Ig> createIg( std::string name, Ig::Config config )
+{
+  if( name=="OcclusionAwareIg" ) return boost::make_shared< oct::OcclusionAwareIg<TreeType> >(config);
+  if( name=="UnobservedVoxelIg" ) return boost::make_shared< oct::UnobservedVoxelIg<TreeType> >(config);
+  if( name=="RearSideVoxelIg" ) return boost::make_shared< oct::RearSideVoxelIg<TreeType> >(config);
+  if( name=="RearSideEntropyIg" ) return boost::make_shared< oct::RearSideEntropyIg<TreeType> >(config);
+  if( name=="ProximityCountIg" ) return boost::make_shared< oct::ProximityCountIg<TreeType> >(config);
+  if( name=="VasquezGomezAreaFactorIg" ) return boost::make_shared< oct::VasquezGomezAreaFactorIg<TreeType> >(config);
+  if( name=="AverageEntropyIg" ) return boost::make_shared< oct::AverageEntropyIg<TreeType> >(config);
+  return boost::make_shared< TraversalCount<TreeType> >(config);
+}
+
+/*! Micro-benchmarks of the information gain hot path: Ray generation, the ray casting of each information gain on its own,
+ * complete view information gain calls and batched viewspace calls for increasing numbers of threads.
+ * 
+ * The map is either synthetic, a box with a sphere on top that was partially observed by a simulated sensor, or the map
+ * resulting from the pointclouds of a recorded session (see replay_session). The views are poses on a circle around the
+ * scene, or the recorded viewspace.
+ * 
+ * Usage: ig_benchmark [repetitions=3] [session_log]
+ */
+int main(int argc, char **argv)
+{
+  unsigned int repetitions = (argc>1)? std::max(1,std::atoi(argv[1])) : 3;
+  std::string session_log = (argc>2)? argv[2] : "";
+  
+  // Configuration, the synthetic one corresponds to the flying gazebo stereo camera example
+  // .............................................................................................
+  oct::SessionSetup setup;
+  setup.octree.resolution_m = 0.01;
+  setup.camera.img_width_px = 480;
+  setup.camera.img_height_px = 480;
+  setup.camera.camera_matrix << 448.1008985853343, 0, 240.5,
+				0, 448.1008985853343, 240.5,
+				0, 0, 1;
+  setup.camera.max_ray_depth_m = 1.5;
+  setup.camera.resolution.ray_resolution_x = 0.1;
+  setup.camera.resolution.ray_resolution_y = 0.1;
+  setup.max_sensor_range_m = 1.5;
+  setup.occlusion_update_dist_m = 0.3;
+  
+  std::vector<PclType::Ptr> clouds;
+  std::vector< Eigen::Transform<double,3,Eigen::Affine>, Eigen::aligned_allocator< Eigen::Transform<double,3,Eigen::Affine> > > sensor_to_world;
+  movements::PoseVector views;
+  
+  if( !session_log.empty() )
+  {
+    oct::SessionLogReader reader;
+    if( !reader.open(session_log) )
+    {
+      std::cout<<"Failed to open the session log '"<<session_log<<"'.\n";
+      return 1;
+    }
+    iar::views::ViewSpace viewspace;
+    for( oct::SessionRecordType::Enum type=reader.next(); type!=oct::SessionRecordType::NONE; type=reader.next() )
+    {
+      if( type==oct::SessionRecordType::SETUP )
+	reader.get(setup);
+      else if( type==oct::SessionRecordType::VIEWSPACE )
+	reader.get(viewspace);
+      else if( type==oct::SessionRecordType::POINTCLOUD )
+      {
+	Eigen::Transform<double,3,Eigen::Affine> transform;
+	PclType::Ptr cloud = boost::make_shared<PclType>();
+	if( reader.getPointcloud(transform,*cloud) )
+	{
+	  clouds.push_back(cloud);
+	  sensor_to_world.push_back(transform);
+	}
+      }
+    }
+    for( iar::views::ViewSpace::Iterator it=viewspace.begin(); it!=viewspace.end(); ++it )
+      views.push_back( it->pose() );
+  }
+  else
+  {
+    // a partially observed scene: the sensor only sees it from one side
+    boost::shared_ptr<TreeType> ground_truth = boost::make_shared<TreeType>(setup.octree);
+    oct::SimulatedSensor<TreeType,PclType>::addBox( *ground_truth, Eigen::Vector3d(-0.15,-0.15,0), Eigen::Vector3d(0.15,0.15,0.15) );
+    oct::SimulatedSensor<TreeType,PclType>::addSphere( *ground_truth, Eigen::Vector3d(0,0,0.23), 0.08 );
+    
+    oct::SimulatedSensor<TreeType,PclType>::Config sensor_config;
+    sensor_config.camera = setup.camera;
+    sensor_config.camera.resolution = PinholeCamRayCaster::ResolutionSettings();
+    oct::SimulatedSensor<TreeType,PclType> sensor(ground_truth,sensor_config);
+    
+    movements::PoseVector capture_poses = bm::ringPoses(3,0.6,0.25,0,M_PI/2);
+    for( size_t i=0; i<capture_poses.size(); ++i )
+    {
+      PclType::Ptr cloud = boost::make_shared<PclType>();
+      sensor.capture(capture_poses[i],*cloud);
+      clouds.push_back(cloud);
+      sensor_to_world.push_back( oct::SimulatedSensor<TreeType,PclType>::sensorToWorld(capture_poses[i]) );
+    }
+  }
+  if( views.empty() )
+    views = bm::ringPoses(16,0.6,0.2);
+  
+  // Build the map
+  // .............................................................................................
+  boost::shared_ptr<WorldRepresentation> world_representation = boost::make_shared<WorldRepresentation>(setup.octree);
+  world_representation->mapMetricCounters()->setConfig(setup.ig);
+  
+  oct::StdPclInputPointXYZ<TreeType>::Type::Config input_config;
+  input_config.use_bounding_box = setup.use_bounding_box;
+  input_config.bounding_box_min_point_m = ::octomap::point3d( setup.bounding_box_min_point_m(0), setup.bounding_box_min_point_m(1), setup.bounding_box_min_point_m(2) );
+  input_config.bounding_box_max_point_m = ::octomap::point3d( setup.bounding_box_max_point_m(0), setup.bounding_box_max_point_m(1), setup.bounding_box_max_point_m(2) );
+  input_config.max_sensor_range_m = setup.max_sensor_range_m;
+  oct::StdPclInputPointXYZ<TreeType>::Ptr input = world_representation->getLinkedObj<oct::StdPclInputPointXYZ>(input_config);
+  if( setup.occlusion_update_dist_m>=0 )
+    input->setOcclusionCalculator<oct::RayOcclusionCalculator>( oct::RayOcclusionCalculator<TreeType,PclType>::Options(setup.occlusion_update_dist_m) );
+  
+  for( size_t i=0; i<clouds.size(); ++i )
+    input->push( sensor_to_world[i], *clouds[i] );
+  
+  BenchmarkIgCalculator<TreeType>::Config ig_calc_config;
+  ig_calc_config.ray_caster_config = setup.camera;
+  boost::shared_ptr< BenchmarkIgCalculator<TreeType> > ig_calculator = world_representation->getLinkedObj<BenchmarkIgCalculator>(ig_calc_config);
+  
+  registerInformationGains(*ig_calculator,setup.ig);
+  
+  std::vector<std::string> ig_names;
+  std::vector<WorldComm::MetricInfo> ig_metrics;
+  ig_calculator->availableIgMetrics(ig_metrics);
+  for( size_t i=0; i<ig_metrics.size(); ++i )
+    ig_names.push_back(ig_metrics[i].name);
+  
+  std::cout<<"\nMap: "<<(session_log.empty()? std::string("synthetic") : session_log)<<", "<<clouds.size()<<" pointclouds inserted, "<<views.size()<<" views, "<<repetitions<<" repetitions.";
+  
+  // Ray generation
+  // .............................................................................................
+  bm::printSection("Ray generation (PinholeCamRayCaster::getRaySet)");
+  printHeader();
+  
+  PinholeCamRayCaster ray_caster(setup.camera);
+  std::vector< boost::shared_ptr<RayCaster::RaySet> > ray_sets( views.size() );
+  double number_of_rays = 0;
+  bm::Timer timer;
+  for( unsigned int rep=0; rep<repetitions; ++rep )
+  {
+    for( size_t i=0; i<views.size(); ++i )
+      ray_sets[i] = ray_caster.getRaySet(views[i]);
+  }
+  double ray_generation_s = timer.elapsedS();
+  for( size_t i=0; i<ray_sets.size(); ++i )
+    number_of_rays += ray_sets[i]->size();
+  printRow( "getRaySet", ray_generation_s, repetitions*number_of_rays, 0 );
+  
+  // Ray casting, one information gain at a time, on the precomputed rays
+  // .............................................................................................
+  bm::printSection("Ray casting per information gain (BasicRayIgCalculator::calculateIgsOnRay)");
+  printHeader();
+  
+  double number_of_voxels = 0;
+  std::vector<std::string> cast_names = ig_names;
+  cast_names.insert( cast_names.begin(), "TraversalCount" );
+  for( size_t n=0; n<cast_names.size(); ++n )
+  {
+    std::vector< boost::shared_ptr<Ig> > ig_set( 1, createIg(cast_names[n],setup.ig) );
+    timer.restart();
+    for( unsigned int rep=0; rep<repetitions; ++rep )
+    {
+      for( size_t i=0; i<ray_sets.size(); ++i )
+	ig_calculator->castRays( *ray_sets[i], ig_set );
+    }
+    double duration_s = timer.elapsedS();
+    
+    if( n==0 ) // the traversal count is the reference for all others
+      number_of_voxels = ig_set[0]->voxelCount()/double(repetitions);
+    printRow( cast_names[n], duration_s, repetitions*number_of_rays, repetitions*number_of_voxels );
+  }
+  
+  // Complete view information gain calls with all information gains
+  // .............................................................................................
+  bm::printSection("View information gain (BasicRayIgCalculator::computeViewIg, all information gains)");
+  printHeader();
+  
+  timer.restart();
+  for( unsigned int rep=0; rep<repetitions; ++rep )
+  {
+    for( size_t i=0; i<views.size(); ++i )
+    {
+      WorldComm::IgRetrievalCommand command;
+      command.path.push_back(views[i]);
+      command.metric_names = ig_names;
+      WorldComm::ViewIgResult result;
+      ig_calculator->computeViewIg(command,result);
+    }
+  }
+  printRow( "computeViewIg", timer.elapsedS(), repetitions*number_of_rays, repetitions*number_of_voxels );
+  
+  // Batched viewspace calls, thread count sweep
+  // .............................................................................................
+  bm::printSection("Viewspace information gain (BasicRayIgCalculator::computeViewspaceIg), thread sweep");
+  printHeader();
+  
+  unsigned int max_threads = std::max( 1u, boost::thread::hardware_concurrency() );
+  double single_thread_s = 0;
+  for( unsigned int threads=1; ; threads = std::min(2*threads,max_threads) )
+  {
+    BenchmarkIgCalculator<TreeType>::Config sweep_config = ig_calc_config;
+    sweep_config.number_of_threads = threads;
+    boost::shared_ptr< BenchmarkIgCalculator<TreeType> > sweep_calculator = world_representation->getLinkedObj<BenchmarkIgCalculator>(sweep_config);
+    registerInformationGains(*sweep_calculator,setup.ig);
+    
+    WorldComm::ViewspaceIgRetrievalCommand command;
+    command.poses = views;
+    command.metric_names = ig_names;
+    
+    timer.restart();
+    for( unsigned int rep=0; rep<repetitions; ++rep )
+    {
+      WorldComm::ViewspaceIgResult result;
+      sweep_calculator->computeViewspaceIg(command,result);
+    }
+    double duration_s = timer.elapsedS();
+    if( threads==1 )
+      single_thread_s = duration_s;
+    
+    std::stringstream name;
+    name<<threads<<" thread(s), speedup "<<std::setprecision(2)<<std::fixed<<bm::perSecond(single_thread_s,duration_s);
+    printRow( name.str(), duration_s, repetitions*number_of_rays, repetitions*number_of_voxels );
+    
+    if( threads==max_threads )
+      break;
+  }
+  
+  std::cout<<"\n\n";
+  return 0;
+}
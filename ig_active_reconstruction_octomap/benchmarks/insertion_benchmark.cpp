@@ -0,0 +1,194 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+#include <boost/make_shared.hpp>
+
+#include "ig_active_reconstruction_octomap/octomap_ig_tree_world_representation.hpp"
+#include "ig_active_reconstruction_octomap/octomap_ray_occlusion_calculator.hpp"
+#include "ig_active_reconstruction_octomap/octomap_std_pcl_input_point_xyz.hpp"
+
+#include "benchmark_tools.hpp"
+
+namespace oct = ig_active_reconstruction::world_representation::octomap;
+namespace bm = ig_active_reconstruction::benchmarks;
+
+typedef oct::IgTreeWorldRepresentation WorldRepresentation;
+typedef WorldRepresentation::TreeType TreeType;
+typedef oct::StdPclInputPointXYZ<TreeType>::PclType PclType;
+typedef oct::StdPclInputPointXYZ<TreeType>::Type Input;
+
+/*! Configuration of the synthetic clouds.
+ */
+struct CloudConfig
+{
+  unsigned int number_of_points; //! Points per cloud.
+  double range_m; //! Mean distance of the points from the sensor [m].
+  double fov_deg; //! Horizontal and vertical angle covered by the points [deg], the smaller the denser.
+  unsigned int number_of_clouds; //! Number of clouds, captured from poses on a quarter circle around the origin.
+};
+
+/*! Creates a cloud of points on a wavy surface in front of the sensor (z axis), in sensor coordinates. The points are
+ * distributed on a regular grid of angles.
+ */
+static void createCloud( const CloudConfig& config, PclType& pc )
+{
+  pc.clear();
+  unsigned int side = std::max( 1u, static_cast<unsigned int>( std::sqrt( static_cast<double>(config.number_of_points) ) ) );
+  double half_fov_rad = 0.5*config.fov_deg*M_PI/180.0;
+  
+  for( unsigned int row=0; row<side; ++row )
+  {
+    for( unsigned int col=0; col<side; ++col )
+    {
+      double u = -half_fov_rad + 2*half_fov_rad*(col+0.5)/side;
+      double v = -half_fov_rad + 2*half_fov_rad*(row+0.5)/side;
+      Eigen::Vector3d direction = Eigen::Vector3d( std::tan(u), std::tan(v), 1 ).normalized();
+      double depth = config.range_m*( 1 + 0.1*std::sin(5*u)*std::cos(5*v) );
+      
+      pcl::PointXYZ point;
+      point.x = depth*direction(0);
+      point.y = depth*direction(1);
+      point.z = depth*direction(2);
+      pc.push_back(point);
+    }
+  }
+}
+
+/*! Inserts the clouds into a fresh world and prints the per-phase throughput.
+ * @param resolution_m Octree resolution [m].
+ * @param occlusion_update_dist_m Occlusion update distance of the RayOcclusionCalculator [m], negative to insert without occlusion calculation.
+ */
+static void run( const CloudConfig& cloud_config, const PclType& cloud, double resolution_m, double occlusion_update_dist_m )
+{
+  TreeType::Config octree_config;
+  octree_config.resolution_m = resolution_m;
+  boost::shared_ptr<WorldRepresentation> world_representation = boost::make_shared<WorldRepresentation>(octree_config);
+  
+  Input::Config input_config;
+  input_config.max_sensor_range_m = 2*cloud_config.range_m;
+  Input::Ptr input = world_representation->getLinkedObj<oct::StdPclInputPointXYZ>(input_config);
+  if( occlusion_update_dist_m>=0 )
+    input->setOcclusionCalculator<oct::RayOcclusionCalculator>( oct::RayOcclusionCalculator<TreeType,PclType>::Options(occlusion_update_dist_m) );
+  
+  movements::PoseVector poses = bm::ringPoses( cloud_config.number_of_clouds, cloud_config.range_m, 0, 0, M_PI/2 );
+  
+  Input::InsertionStatistics total;
+  bm::Timer timer;
+  double total_s = 0;
+  for( size_t i=0; i<poses.size(); ++i )
+  {
+    PclType pc = cloud; // push() operates on the cloud
+    Eigen::Transform<double,3,Eigen::Affine> sensor_to_world = Eigen::Translation3d(poses[i].position)*poses[i].orientation;
+    
+    timer.restart();
+    input->push(sensor_to_world,pc);
+    total_s += timer.elapsedS();
+    
+    Input::InsertionStatistics statistics = input->lastInsertionStatistics();
+    total.number_of_points += statistics.number_of_points;
+    total.number_of_valid_points += statistics.number_of_valid_points;
+    total.number_of_free_voxels += statistics.number_of_free_voxels;
+    total.number_of_occupied_voxels += statistics.number_of_occupied_voxels;
+    total.node_count_delta += statistics.node_count_delta;
+    total.filter_s += statistics.filter_s;
+    total.key_computation_s += statistics.key_computation_s;
+    total.free_update_s += statistics.free_update_s;
+    total.occupied_update_s += statistics.occupied_update_s;
+    total.occlusion_s += statistics.occlusion_s;
+  }
+  
+  std::stringstream title;
+  title<<"resolution "<<resolution_m<<" m, ";
+  if( occlusion_update_dist_m>=0 )
+    title<<"occlusion update distance "<<occlusion_update_dist_m<<" m";
+  else
+    title<<"no occlusion calculation";
+  bm::printSection(title.str());
+  
+  std::cout<<std::fixed<<std::setprecision(3)
+	   <<"\n"<<total.number_of_points<<" points ("<<total.number_of_valid_points<<" valid) in "<<total_s<<" s, "<<std::setprecision(0)<<bm::perSecond(total.number_of_points,total_s)<<" points/s"
+	   <<"\n"<<total.number_of_free_voxels<<" free and "<<total.number_of_occupied_voxels<<" occupied voxel updates, node count delta "<<std::showpos<<total.node_count_delta<<std::noshowpos
+	   <<"\nresident memory "<<std::setprecision(1)<<bm::residentMemoryMb()<<" MB, process peak "<<bm::peakResidentMemoryMb()<<" MB";
+  
+  std::cout<<"\n"<<std::left<<std::setw(20)<<"phase"<<std::right<<std::setw(12)<<"time [s]"<<std::setw(16)<<"points/s"<<std::setw(10)<<"share";
+  const char* phase_names[] = { "filter", "key computation", "free update", "occupied update", "occlusion" };
+  double phase_s[] = { total.filter_s, total.key_computation_s, total.free_update_s, total.occupied_update_s, total.occlusion_s };
+  for( unsigned int i=0; i<5; ++i )
+  {
+    std::cout<<"\n"<<std::left<<std::setw(20)<<phase_names[i]<<std::right
+	     <<std::setw(12)<<std::setprecision(4)<<phase_s[i]
+	     <<std::setw(16)<<std::setprecision(0)<<bm::perSecond(total.number_of_valid_points,phase_s[i])
+	     <<std::setw(9)<<std::setprecision(1)<<100*bm::perSecond(phase_s[i],total_s)<<"%";
+  }
+}
+
+/*! Measures the throughput of pointcloud insertion through StdPclInput::push into an IgTreeWorldRepresentation, for
+ * each insertion phase separately, with and without RayOcclusionCalculator. The clouds are synthetic, of configurable size,
+ * density and range.
+ * 
+ * By default, the octree resolution is swept with and without occlusion calculation, then the occlusion update distance is
+ * swept at 0.01 m resolution, such that scaling cliffs become visible. If a resolution is given, only that configuration
+ * is run, which yields its own peak memory usage (the peak is per process).
+ * 
+ * Usage: insertion_benchmark [points=100000] [range_m=1.0] [fov_deg=60] [clouds=4] [resolution_m occlusion_update_dist_m (<0: none)]
+ */
+int main(int argc, char **argv)
+{
+  CloudConfig cloud_config;
+  cloud_config.number_of_points = (argc>1)? std::atoi(argv[1]) : 100000;
+  cloud_config.range_m = (argc>2)? std::atof(argv[2]) : 1.0;
+  cloud_config.fov_deg = (argc>3)? std::atof(argv[3]) : 60;
+  cloud_config.number_of_clouds = (argc>4)? std::atoi(argv[4]) : 4;
+  
+  PclType cloud;
+  createCloud(cloud_config,cloud);
+  std::cout<<"\nInserting "<<cloud_config.number_of_clouds<<" clouds of "<<cloud.points.size()<<" points at "<<cloud_config.range_m<<" m range, covering "<<cloud_config.fov_deg<<" deg.";
+  
+  if( argc>6 )
+  {
+    run( cloud_config, cloud, std::atof(argv[5]), std::atof(argv[6]) );
+    std::cout<<"\n\n";
+    return 0;
+  }
+  
+  double resolutions_m[] = { 0.04, 0.02, 0.01, 0.005 };
+  for( unsigned int i=0; i<4; ++i )
+  {
+    run( cloud_config, cloud, resolutions_m[i], -1 );
+    run( cloud_config, cloud, resolutions_m[i], 0.3 );
+  }
+  
+  double occlusion_update_dists_m[] = { 0.05, 0.1, 0.3, 0.6, 1.0 };
+  for( unsigned int i=0; i<5; ++i )
+  {
+    run( cloud_config, cloud, 0.01, occlusion_update_dists_m[i] );
+  }
+  
+  std::cout<<"\n\n";
+  return 0;
+}
@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include "ig_active_reconstruction_octomap/octomap_map_metric.hpp"
+#include "ig_active_reconstruction_octomap/octomap_map_metric_counters.hpp"
+
 namespace ig_active_reconstruction
 {
   
@@ -26,13 +29,72 @@ namespace world_representation
 namespace octomap
 {  
   
-  /*! Class that calculates a whole set of tree metrics simultaneously.
-   * 
-   * TODO: refactoring...
+  /*! Map metric that returns one of the values kept by the map metric counters of the world representation. Since
+   * the counters are updated incrementally while data is inserted, a query costs O(1) instead of a scan of the
+   * complete tree. One instance is registered per metric of interest, each with its own name.
    */
   template<class TREE_TYPE>
-  class OmniCalculator
+  class OmniCalculator: public MapMetric<TREE_TYPE>
   {
+  public:
+    typedef typename MapMetric<TREE_TYPE>::Result Result;
+    typedef typename MapMetric<TREE_TYPE>::Link Link;
+    typedef typename MapMetricCounters<TREE_TYPE>::Values Values;
+    
+    /*! Metrics that can be retrieved.
+     */
+    enum Metric
+    {
+      TOTAL_ENTROPY=0,
+      TOTAL_VOXELS,
+      KNOWN_VOXELS,
+      UNKNOWN_VOXELS,
+      OCCUPIED_VOXELS,
+      FREE_VOXELS,
+      OCCLUDED_VOXELS,
+      NUMBER_OF_METRICS
+    };
+    
+    struct Config
+    {
+    public:
+      Config();
+      
+    public:
+      Metric metric; //! Metric that is returned. Default: TOTAL_ENTROPY.
+    };
+    
+  public:
+    /*! Constructor.
+     * @param config Configuration.
+     */
+    OmniCalculator( Config config = Config() );
+    
+    /*! Returns the name of the metric, e.g. "TotalEntropy" or "KnownVoxelCount".
+     */
+    virtual std::string type();
+    
+    /*! Returns the configured metric, read from the counters of the link. If the link has no counters, they are
+     * computed by traversing the complete octree with the default thresholds.
+     * @param link Link to the world representation.
+     */
+    virtual Result calculateOn( Link& link );
+    
+    /*! Returns all counter values at once.
+     * @param link Link to the world representation.
+     */
+    static Values calculateAll( Link& link );
+    
+    /*! Returns the value of a metric in a set of counter values.
+     */
+    static Result select( Metric metric, const Values& values );
+    
+    /*! Returns the name of a metric.
+     */
+    static std::string name( Metric metric );
+    
+  private:
+    Config config_;
   };
   
 }
@@ -41,4 +103,4 @@ namespace octomap
 
 }
 
-#include "../src/code_base/map_metric/omni_calculator.hpp"
\ No newline at end of file
+#include "../src/code_base/map_metric/omni_calculator.inl"
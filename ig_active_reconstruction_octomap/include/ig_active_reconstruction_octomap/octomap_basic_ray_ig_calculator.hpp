@@ -18,8 +18,12 @@
 #pragma once
 
 
+#include <boost/unordered_map.hpp>
+
 #include "ig_active_reconstruction_octomap/octomap_ig_calculator.hpp"
+#include "ig_active_reconstruction_octomap/octomap_session_log.hpp"
 #include "ig_active_reconstruction/world_representation_pinhole_cam_raycaster.hpp"
+#include "ig_active_reconstruction/thread_pool.hpp"
 
 namespace ig_active_reconstruction
 {
@@ -45,6 +49,8 @@ namespace octomap
     typedef typename IgCalculator<TREE_TYPE>::MapMetricRetrievalResult MapMetricRetrievalResult;
     typedef typename IgCalculator<TREE_TYPE>::MetricInfo MetricInfo;
     typedef typename IgCalculator<TREE_TYPE>::ViewIgRetrievalResult ViewIgRetrievalResult;
+    typedef typename IgCalculator<TREE_TYPE>::ViewspaceIgRetrievalCommand ViewspaceIgRetrievalCommand;
+    typedef typename IgCalculator<TREE_TYPE>::ViewspaceIgResult ViewspaceIgResult;
     typedef typename IgCalculator<TREE_TYPE>::MapMetricRetrievalResultSet MapMetricRetrievalResultSet;
     typedef typename IgCalculator<TREE_TYPE>::IgFactory IgFactory;
     typedef typename IgCalculator<TREE_TYPE>::MmFactory MmFactory;
@@ -57,6 +63,7 @@ namespace octomap
       Config();
     public:
       PinholeCamRayCaster::Config ray_caster_config; //! Configuration for the pinhole ray casting module.
+      unsigned int number_of_threads; //! Number of threads computing the views of batched viewspace ig calls, 0 uses the number of hardware threads. Default: 0.
     };
     
   public:
@@ -71,14 +78,28 @@ namespace octomap
      */
     void setNewRayCastingConfig( PinholeCamRayCaster::Config& config );
     
+    /*! Sets a recorder to which every information gain retrieval command is recorded, including the ones of batched
+     * viewspace calls (one per view). Pass an empty pointer to stop recording.
+     */
+    void setRecorder( boost::shared_ptr<SessionRecorder> recorder );
+    
   // Interface implementation
   public:
-    /*! Calculates a set of information gains for a given view.
+    /*! Calculates a set of information gains for a given view. If the path holds several poses, the information gain of
+     * the union of the voxels seen from all of them is calculated: Every voxel contributes once, with the largest
+     * contribution it makes from any single pose. This is exact for metrics that sum up contributions of single voxels and
+     * an approximation for averaging metrics (AverageEntropyIg, VasquezGomezAreaFactorIg).
      * @param command Specifies which information gains have to be calculated and for which pose along with further parameters that define how the ig('s) will be collected.
      * @param output_ig (Output) Vector with the results of the information gain calculation. The indices correspond to the indices of the names in the metric_names array within the passed command.
      */
     virtual ResultInformation computeViewIg(IgRetrievalCommand& command, ViewIgRetrievalResult& output_ig);
     
+    /*! Calculates a set of information gains for each of several views, the views being distributed among several threads.
+     * @param command Specifies which information gains have to be calculated and for which poses.
+     * @param output_ig (Output) One result vector per pose, in the order of the poses in the command.
+     */
+    virtual ResultInformation computeViewspaceIg(ViewspaceIgRetrievalCommand& command, ViewspaceIgResult& output_ig);
+    
     /*! Calculates a set of evaluation metrics on the complete map.
      * @param command Specifies which metrics shall be calculated.
      */
@@ -95,6 +116,8 @@ namespace octomap
     virtual void availableMapMetrics( std::vector<MetricInfo>& available_map_metrics );
     
   protected:
+    //! Contributions of single voxels to each information gain of a set, by voxel key.
+    typedef boost::unordered_map< ::octomap::OcTreeKey, std::vector<double>, ::octomap::OcTreeKey::KeyHash > VoxelContributions;
     
     struct RayCastSettings
     {
@@ -109,12 +132,27 @@ namespace octomap
      * @param ray Ray which is cast.
      * @param ig_set Set of information gains to be calculated.
      * @param setting Additional ray casting settings.
+     * @param contributions (Output) If not NULL, the contributions of the traversed voxels are added to it.
+     */
+    void calculateIgsOnRay( RayCaster::Ray& ray, std::vector< boost::shared_ptr< InformationGain<TREE_TYPE> > >& ig_set, RayCastSettings& setting, VoxelContributions* contributions = NULL );
+    
+    /*! Includes a voxel into all information gains of a set, through includeRayMeasurement or includeEndPointMeasurement.
+     * @param contributions (Output) If not NULL, the change of each information gain is added to the entry of the voxel.
+     */
+    void includeVoxel( const ::octomap::OcTreeKey& key, bool end_point, std::vector< boost::shared_ptr< InformationGain<TREE_TYPE> > >& ig_set, VoxelContributions* contributions );
+    
+    /*! Computes the information gains of a single view of a batched command, called by computeViewspaceIg for each view.
+     * @param command The batched command.
+     * @param output_ig (Output) Results, one entry per view.
+     * @param index Index of the view.
      */
-    void calculateIgsOnRay( RayCaster::Ray& ray, std::vector< boost::shared_ptr< InformationGain<TREE_TYPE> > >& ig_set, RayCastSettings& setting );
+    void computePoseIg( ViewspaceIgRetrievalCommand* command, ViewspaceIgResult* output_ig, size_t index );
     
   protected:
     Config config_; //! Configuration...
     PinholeCamRayCaster ray_caster_; //! Ray caster module.
+    boost::shared_ptr<SessionRecorder> recorder_; //! Records retrieval commands if set.
+    boost::shared_ptr<ThreadPool> thread_pool_; //! Worker threads computing the views of batched calls.
   };
 }
 
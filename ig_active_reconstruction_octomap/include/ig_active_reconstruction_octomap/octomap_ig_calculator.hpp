@@ -88,12 +88,22 @@ namespace octomap
     template<template<typename> class IG_METRIC_TYPE>
     unsigned int registerInformationGain( typename IG_METRIC_TYPE<TREE_TYPE>::Utils::Config utils = typename IG_METRIC_TYPE<TREE_TYPE>::Utils() );
     
+    /*! Registers a map metric with an optional Config type constructor parameter that will then be available for calculations. It must take the TREE_TYPE as its only template argument which is being set automatically.
+     */
+    template<template<typename> class MAP_METRIC_TYPE>
+    unsigned int registerMapMetric( typename MAP_METRIC_TYPE<TREE_TYPE>::Config config = typename MAP_METRIC_TYPE<TREE_TYPE>::Config() );
+    
   protected:
     /*! Helper function for binding make shared.
      */
     template<template<typename> class IG_METRIC_TYPE>
     boost::shared_ptr< InformationGain<TREE_TYPE> > makeShared(typename IG_METRIC_TYPE<TREE_TYPE>::Utils::Config utils);
     
+    /*! Helper function for binding make shared for map metrics.
+     */
+    template<template<typename> class MAP_METRIC_TYPE>
+    boost::shared_ptr< MapMetric<TREE_TYPE> > makeSharedMapMetric(typename MAP_METRIC_TYPE<TREE_TYPE>::Config config);
+    
   protected:
     IgFactory ig_factory_; //! Information gain factory.
     MmFactory mm_factory_; //! Map metric factory.
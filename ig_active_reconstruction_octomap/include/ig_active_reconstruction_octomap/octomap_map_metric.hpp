@@ -17,6 +17,11 @@
 
 #pragma once
 
+#include <string>
+#include <boost/shared_ptr.hpp>
+
+#include "ig_active_reconstruction_octomap/octomap_world_representation.hpp"
+
 namespace ig_active_reconstruction
 {
   
@@ -34,18 +39,21 @@ namespace octomap
   class MapMetric
   {
   public:
+    typedef boost::shared_ptr< MapMetric<TREE_TYPE> > Ptr;
     typedef double Result;
-    
+    typedef typename WorldRepresentation<TREE_TYPE>::Link Link;
     
   public:
+    virtual ~MapMetric(){};
+    
     /*! Returns the name of the method.
      */
     virtual std::string type()=0;
     
-    /*! Calculates the metric on the given octree.
-     * @param octree Pointer to the octree on which the metric will be calculated.
+    /*! Calculates the metric on the map the link points to.
+     * @param link Link to the world representation, providing the octree and its map metric counters.
      */
-    Result calculateOn( boost::shared_ptr<TREE_TYPE> octree )=0;
+    virtual Result calculateOn( Link& link )=0;
   };
   
 }
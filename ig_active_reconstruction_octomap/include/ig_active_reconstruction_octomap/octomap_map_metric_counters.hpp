@@ -0,0 +1,137 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <stdint.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "ig_active_reconstruction_octomap/octomap_information_gain.hpp"
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+  
+namespace octomap
+{  
+  
+  /*! Keeps map-wide metrics up to date while the octree is being changed, such that they can be queried in constant
+   * time instead of traversing the complete tree. Whoever changes a voxel passes its state before and after the change.
+   * 
+   * Counts refer to voxels at maximal tree depth: A pruned node counts for all the voxels it represents. Voxels that were
+   * neither measured nor marked as occluded don't exist in the tree and aren't counted. Voxels are classified with the
+   * same thresholds that are used for information gain calculation.
+   */
+  template<class TREE_TYPE>
+  class MapMetricCounters
+  {
+  public:
+    typedef boost::shared_ptr< MapMetricCounters<TREE_TYPE> > Ptr;
+    typedef typename InformationGain<TREE_TYPE>::Utils Utils;
+    typedef typename InformationGain<TREE_TYPE>::Utils::Config Config;
+    
+    /*! State of a single voxel, as far as relevant for the counters.
+     */
+    struct VoxelState
+    {
+    public:
+      /*! Constructor, describes a voxel that doesn't exist.
+       */
+      VoxelState();
+      
+    public:
+      bool exists; //! Whether the voxel exists in the octree.
+      bool has_measurement; //! Whether the voxel was part of a measurement.
+      double p_occupancy; //! Occupancy likelihood, the unknown prior if the voxel wasn't measured.
+      bool occluded; //! Whether an occlusion distance was registered for the unmeasured voxel.
+    };
+    
+    /*! Current counter values.
+     */
+    struct Values
+    {
+    public:
+      /*! Constructor sets all values to zero.
+       */
+      Values();
+      
+    public:
+      double total_entropy; //! Sum of the entropies of all voxels [nat].
+      int64_t total_voxels; //! Number of voxels in the map.
+      int64_t known_voxels; //! Number of voxels that are considered free or occupied.
+      int64_t unknown_voxels; //! Number of voxels that are neither considered free nor occupied, including unmeasured ones.
+      int64_t occupied_voxels; //! Number of voxels that are considered occupied.
+      int64_t free_voxels; //! Number of voxels that are considered free.
+      int64_t occluded_voxels; //! Number of unmeasured voxels with a registered occlusion distance.
+    };
+    
+  public:
+    /*! Constructor.
+     * @param octree The octree whose voxels are counted, expected to be empty.
+     * @param config Thresholds used to classify voxels.
+     */
+    MapMetricCounters( boost::shared_ptr<TREE_TYPE> octree, Config config = Config() );
+    
+    /*! Sets new thresholds and recounts all voxels.
+     */
+    void setConfig( Config config );
+    
+    /*! Returns the state of a voxel.
+     * @param voxel Pointer to the voxel, NULL if it doesn't exist.
+     */
+    VoxelState stateOf( typename TREE_TYPE::NodeType* voxel );
+    
+    /*! Updates the counters with the change of a single voxel.
+     * @param before State of the voxel before it was changed.
+     * @param after State of the voxel after it was changed.
+     */
+    void update( const VoxelState& before, const VoxelState& after );
+    
+    /*! Returns the current values, O(1).
+     */
+    Values values();
+    
+    /*! Recounts all voxels of the octree by traversing it, e.g. after it was loaded or changed by other means.
+     */
+    void rebuild();
+    
+  protected:
+    /*! Adds (or removes) the contribution of voxels in the given state to (from) the values. Not guarded.
+     * @param state Voxel state.
+     * @param number Number of voxels, negative to remove them.
+     * @param values Values that are changed.
+     */
+    void add( const VoxelState& state, int64_t number, Values& values );
+    
+  protected:
+    boost::shared_ptr<TREE_TYPE> octree_; //! The octree whose voxels are counted.
+    Utils utils_; //! Voxel classification.
+    Values values_; //! Current values.
+    boost::mutex mutex_; //! Guards the values.
+  };
+  
+}
+
+}
+
+}
+
+#include "../src/code_base/octomap_map_metric_counters.inl"
@@ -0,0 +1,146 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <octomap/OcTreeKey.h>
+
+#include "ig_active_reconstruction_octomap/octomap_world_representation.hpp"
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+
+namespace octomap
+{
+  /*! Traverses all leaves of the linked octree in parallel. The tree is partitioned at a configurable depth into
+   * independent subtrees that are distributed among worker threads. Each worker accumulates its leaves in its own
+   * copy of an accumulator, the per-worker accumulators are combined with a user supplied reduce function afterwards.
+   * 
+   * Which worker visits which subtree is not deterministic, the reduce function should hence not depend on the order
+   * in which leaves were visited. The octree must not be modified during a traversal.
+   * 
+   * Example, counting all occupied leaves:
+   * ******************************************
+   * struct CountOccupied
+   * {
+   *   CountOccupied( IgTree* tree ): tree(tree){}
+   *   void operator()( size_t& count, const ParallelTraversal<IgTree>::Leaf& leaf ){ if( tree->isNodeOccupied(*leaf.node) ) ++count; }
+   *   IgTree* tree;
+   * };
+   * struct Sum{ void operator()( size_t& total, const size_t& part ){ total+=part; } };
+   * 
+   * size_t occupied = traversal->traverseLeafs<size_t>( CountOccupied(tree), Sum(), 0 );
+   */
+  template<class TREE_TYPE>
+  class ParallelTraversal: public WorldRepresentation<TREE_TYPE>::LinkedObject
+  {
+  public:
+    typedef boost::shared_ptr< ParallelTraversal<TREE_TYPE> > Ptr;
+    typedef TREE_TYPE TreeType;
+    typedef typename TREE_TYPE::NodeType NodeType;
+    
+    struct Config
+    {
+    public:
+      Config();
+      
+    public:
+      unsigned int partition_depth; //! Depth at which the tree is split into subtrees, yielding at most 8^partition_depth subtrees. Default: 3.
+      unsigned int number_of_threads; //! Number of worker threads, 0 uses the number of hardware threads. Default: 0.
+    };
+    
+    /*! Leaf information passed to visitors, corresponding to what the octomap leaf iterators provide.
+     */
+    struct Leaf
+    {
+      NodeType* node; //! The leaf node.
+      ::octomap::OcTreeKey key; //! Key of the leaf at its depth.
+      unsigned int depth; //! Depth of the leaf.
+      double size; //! Edge length of the leaf [m].
+      double x; //! Center coordinates of the leaf [m].
+      double y;
+      double z;
+    };
+    
+  public:
+    /*! Constructor.
+     * @param config Configuration.
+     */
+    ParallelTraversal( Config config = Config() );
+    
+    /*! Visits all leaves of the linked octree in parallel and returns the reduced accumulator.
+     * @tparam ACCUMULATOR Accumulator type, must be copyable. Each worker starts with a copy of init.
+     * @tparam VISITOR Callable with signature void(ACCUMULATOR&, const Leaf&), copied for each worker.
+     * @tparam REDUCER Callable with signature void(ACCUMULATOR& total, const ACCUMULATOR& part), called once per worker.
+     * @param visit Visitor called for each leaf.
+     * @param reduce Combines the accumulators of the workers.
+     * @param init Initial accumulator value, also the value reduced into.
+     * @return The accumulator after all workers were reduced into init.
+     */
+    template<class ACCUMULATOR, class VISITOR, class REDUCER>
+    ACCUMULATOR traverseLeafs( VISITOR visit, REDUCER reduce, ACCUMULATOR init = ACCUMULATOR() );
+    
+  protected:
+    /*! Root of an independent subtree.
+     */
+    struct Subtree
+    {
+      NodeType* node;
+      ::octomap::OcTreeKey key;
+      unsigned int depth;
+    };
+    
+    /*! Collects the roots of all subtrees at the partition depth, or of leaves above it.
+     */
+    void partition( NodeType* node, const ::octomap::OcTreeKey& key, unsigned int depth, std::vector<Subtree>& subtrees );
+    
+    /*! Worker loop: Takes subtrees until none is left and visits their leaves.
+     */
+    template<class ACCUMULATOR, class VISITOR>
+    void work( const std::vector<Subtree>* subtrees, size_t* next_subtree, boost::mutex* mutex, VISITOR visit, ACCUMULATOR* accumulator );
+    
+    /*! Recursively visits all leaves below the given node.
+     */
+    template<class ACCUMULATOR, class VISITOR>
+    void visitLeafs( NodeType* node, const ::octomap::OcTreeKey& key, unsigned int depth, VISITOR& visit, ACCUMULATOR& accumulator );
+    
+    /*! Returns the key of the root node in each dimension.
+     */
+    unsigned short int treeMaxKey() const;
+    
+    /*! Returns the key offset between a node at the given depth and its children.
+     */
+    unsigned short int childOffset( unsigned int depth ) const;
+    
+  private:
+    Config config_;
+  };
+  
+}
+
+}
+
+}
+
+#include "../src/code_base/octomap_parallel_traversal.inl"
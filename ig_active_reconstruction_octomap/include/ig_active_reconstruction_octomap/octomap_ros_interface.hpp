@@ -19,7 +19,14 @@
 
 #include <ros/ros.h>
 
+#include <vector>
+#include <geometry_msgs/Point.h>
+#include <boost/thread/thread.hpp>
+#include <boost/unordered_map.hpp>
+#include <octomap/OcTreeKey.h>
+
 #include "ig_active_reconstruction_octomap/octomap_world_representation.hpp"
+#include "ig_active_reconstruction_octomap/octomap_parallel_traversal.hpp"
 
 namespace ig_active_reconstruction
 {
@@ -34,6 +41,12 @@ namespace octomap
    * functionality like publishers and services.
    * Inputs (e.g. pcl) are not provided as these are supposed to be provided by dedicated classes in order
    * to allow a multiple sensor and multiple sensor modality approach.
+   * 
+   * The voxel map can either be published completely (publishVoxelMap()) or incrementally: Then a background thread takes
+   * the voxels that changed since its last run from the voxel change log of the world representation at a fixed rate and
+   * only republishes the markers of the blocks of space that contain changed voxels. Its cost is thus proportional to the
+   * changes and neither the insertion of data nor the octree is ever blocked by it. Voxels can be decimated to a coarser
+   * level of detail, a coarse voxel is shown as long as any of the voxels it contains is occupied.
    */
   template<class TREE_TYPE>
   class RosInterface: public WorldRepresentation<TREE_TYPE>::LinkedObject
@@ -41,29 +54,114 @@ namespace octomap
   public:
     typedef boost::shared_ptr< RosInterface<TREE_TYPE> > Ptr;
     typedef TREE_TYPE TreeType;
+    typedef typename WorldRepresentation<TREE_TYPE>::Link Link;
     
     struct Config
     {
+    public:
+      Config();
+      
+    public:
       ros::NodeHandle nh;
       std::string world_frame_name;
+      typename ParallelTraversal<TREE_TYPE>::Config traversal_config; //! Configuration of the parallel traversal used to collect the voxels that are published.
+      double publishing_rate_hz; //! Rate at which incremental updates of the voxel map are published [Hz]. Default: 2.0.
+      unsigned int lod_levels; //! Number of tree levels by which voxels are coarsened for incremental publishing, each level doubles the edge length of the shown voxels. Default: 0.
+      unsigned int block_levels; //! Edge length of the blocks of space that are published as one marker, as power of two of the (coarsened) voxel edge length. Default: 4.
     };
     
   public:
     RosInterface(Config config);
     
+    /*! Stops incremental publishing.
+     */
+    virtual ~RosInterface();
+    
+    /*! Links the interface and its parallel traversal to the world representation.
+     */
+    virtual void setLink( Link& link );
+    
     /*! Publishes the voxel map as a visualization_msgs::MarkerArray.
      */
     void publishVoxelMap();
+    
+    /*! Starts incremental publishing of the voxel map in a background thread and enables the voxel change log of the
+     * world representation. Only voxels changed after the start are shown, it is thus meant to be started on an empty map.
+     */
+    void startIncrementalPublishing();
+    
+    /*! Stops incremental publishing and disables the voxel change log.
+     */
+    void stopIncrementalPublishing();
+    
   protected:
     //virtual bool octomapBinarySrv(OctomapSrv::Request  &req, OctomapSrv::GetOctomap::Response &res);
     //virtual bool octomapFullSrv(OctomapSrv::Request  &req, OctomapSrv::GetOctomap::Response &res);
     //bool clearBBXSrv(BBXSrv::Request& req, BBXSrv::Response& resp);
     //bool resetSrv(std_srvs::Empty::Request& req, std_srvs::Empty::Response& resp);
     
+  protected:
+    //! Voxel centers per depth
+    typedef std::vector< std::vector<geometry_msgs::Point> > PointsPerDepth;
+    
+    /*! Traversal visitor collecting the centers of occupied leaves.
+     */
+    struct OccupiedLeafCollector
+    {
+      OccupiedLeafCollector( TREE_TYPE* octree );
+      void operator()( PointsPerDepth& points, const typename ParallelTraversal<TREE_TYPE>::Leaf& leaf );
+      TREE_TYPE* octree;
+    };
+    
+    /*! Traversal reducer appending the points collected by one worker.
+     */
+    struct PointsAppender
+    {
+      void operator()( PointsPerDepth& total, const PointsPerDepth& part );
+    };
+    
+    typedef boost::unordered_map< ::octomap::OcTreeKey, unsigned int, ::octomap::OcTreeKey::KeyHash > KeyCountMap;
+    
+    /*! Block of space that is published as one marker.
+     */
+    struct Block
+    {
+      int id; //! Marker id.
+      ::octomap::KeySet voxels; //! Occupied (coarsened) voxels within the block.
+    };
+    typedef boost::unordered_map< ::octomap::OcTreeKey, Block, ::octomap::OcTreeKey::KeyHash > BlockMap;
+    
+    /*! Background thread loop for incremental publishing.
+     */
+    void incrementalPublishingLoop();
+    
+    /*! Applies the changes recorded since the last call to the shown voxels and publishes the changed blocks.
+     */
+    void publishVoxelMapChanges();
+    
+    /*! Updates the shown voxels with the change of a single voxel at maximal tree depth.
+     */
+    void applyChange( const ::octomap::OcTreeKey& key, bool occupied );
+    
   private:
+    ParallelTraversal<TREE_TYPE> traversal_;
     ros::NodeHandle nh_;
     std::string world_frame_name_;
     ros::Publisher voxel_map_publisher_;
+    
+    // incremental publishing, all state but the thread is only accessed from the publishing thread
+    double publishing_rate_hz_;
+    unsigned int lod_levels_;
+    unsigned int block_levels_;
+    boost::thread publishing_thread_;
+    unsigned int lod_depth_; //! Tree depth of the shown voxels.
+    ::octomap::KeyBoolMap changes_; //! Changes taken from the change log.
+    ::octomap::KeySet occupied_voxels_; //! Occupied voxels at maximal tree depth.
+    KeyCountMap occupied_per_coarse_voxel_; //! Number of occupied voxels within each shown coarse voxel.
+    BlockMap blocks_; //! Shown voxels per block.
+    ::octomap::KeySet changed_blocks_; //! Blocks that need to be republished.
+    int next_block_id_; //! Marker id of the next new block.
+    uint32_t number_of_subscribers_; //! Number of subscribers at the last publishing, all blocks are republished when new ones connect.
   };
   
 }
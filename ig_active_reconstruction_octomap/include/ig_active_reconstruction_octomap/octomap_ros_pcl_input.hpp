@@ -19,9 +19,14 @@
 
 #include <ros/ros.h>
 #include <tf/transform_listener.h>
+#include <boost/thread/mutex.hpp>
 
 #include <sensor_msgs/PointCloud2.h>
 #include "ig_active_reconstruction_msgs/PclInput.h"
+#include "ig_active_reconstruction_msgs/PclShmInput.h"
+
+#include "ig_active_reconstruction_ros/pointcloud2_view.hpp"
+#include "ig_active_reconstruction_ros/pointcloud_shm_ring.hpp"
 
 #include "ig_active_reconstruction_octomap/octomap_pcl_input.hpp"
 
@@ -38,6 +43,12 @@ namespace octomap
    * 
    * Subscribes to "pcl_input" on the passed ros node.
    * Advertices "pcl_input" as service
+   * Advertices "pcl_input_shm" as service, receiving the sequence number of a pointcloud in a shared memory ring buffer
+   * (see ros_tools::PointCloudShmRing) written by a process on the same machine.
+   * Within the same process, pointclouds can be handed over directly through insertCloud.
+   * 
+   * The x, y and z fields of the incoming clouds are read in place into the PCL cloud if they are float32, which avoids
+   * the intermediate copies of pcl::fromROSMsg. Other field layouts are converted with pcl::fromROSMsg.
    */
   template<class TREE_TYPE, class POINTCLOUD_TYPE>
   class RosPclInput
@@ -55,6 +66,12 @@ namespace octomap
      */
     void addInputDoneSignalCall( boost::function<void()> signal_call );
     
+    /*! Inserts a pointcloud handed over directly by a module within the same process, e.g. a robot interface.
+     * @param cloud The pointcloud.
+     * @return True if the cloud was inserted.
+     */
+    bool insertCloud( const sensor_msgs::PointCloud2& cloud );
+    
   protected:
     /*! Pcl input topic listener.
      */
@@ -64,13 +81,22 @@ namespace octomap
      */
     bool insertCloudService( ig_active_reconstruction_msgs::PclInput::Request& req, ig_active_reconstruction_msgs::PclInput::Response& res);
     
+    /*! Shared memory pcl input service.
+     */
+    bool insertShmCloudService( ig_active_reconstruction_msgs::PclShmInput::Request& req, ig_active_reconstruction_msgs::PclShmInput::Response& res);
+    
+    /*! Converts a ROS pointcloud to PCL, reading the x, y and z fields in place if possible.
+     */
+    void cloudFromView( const ros_tools::PointCloud2View& cloud, POINTCLOUD_TYPE& pointcloud );
+    
     /*! Helper function calling the signal call stack.
      */
     void issueInputDoneSignals();
     
     /*! Inserts a cloud by reference and calls issueInputDoneSignals when done.
+     * @return False if the cloud couldn't be transformed to the world frame.
      */
-    void insertCloud( POINTCLOUD_TYPE& pointcloud );
+    bool insertCloud( POINTCLOUD_TYPE& pointcloud );
     
   private:
     ros::NodeHandle nh_;
@@ -82,6 +108,10 @@ namespace octomap
     
     ros::Subscriber pcl_subscriber_;
     ros::ServiceServer pcl_input_service_;
+    ros::ServiceServer pcl_shm_input_service_;
+    
+    boost::mutex shm_ring_mutex_; //! Guards shm_ring_, service calls might be processed concurrently.
+    boost::shared_ptr<ros_tools::PointCloudShmRing> shm_ring_; //! Ring buffer opened on the first shared memory input.
     
     tf::TransformListener tf_listener_;
   };
@@ -0,0 +1,81 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <ros/ros.h>
+#include <sensor_msgs/PointCloud2.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+
+#include "ig_active_reconstruction/world_representation_communication_interface.hpp"
+#include "ig_active_reconstruction/view_space.hpp"
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+
+namespace octomap
+{
+  
+  /*! Sets up the complete octomap based world representation as it is used by the octomap_world_representation node:
+   * The IgTree world with its pointcloud input and occlusion calculation, the ROS pointcloud input and map publisher, the
+   * information gain calculator with all information gains and map metrics registered, its ROS server interface and the
+   * "world/ig_job" action for asynchronous information gain computation.
+   * 
+   * Instead of running it in its own node, the world can thus be created in the same process as the other modules, which
+   * can then directly call the information gain calculator returned by igCalculator(). The ROS interfaces are advertised
+   * nevertheless, such that external tools (e.g. rviz, recorders) keep working.
+   * 
+   * The header doesn't expose any octomap or PCL types and can thus be included by C++11 code.
+   */
+  class IgTreeRosWorld
+  {
+  public:
+    /*! Constructor, loads the configuration from the parameter server (see the octomap_world_representation launch file)
+     * and sets up the world.
+     * @param nh Node handle under whose namespace the "world/..." services and topics are advertised.
+     * @param param_nh Node handle from whose namespace the parameters are loaded.
+     */
+    IgTreeRosWorld( ros::NodeHandle nh = ros::NodeHandle(), ros::NodeHandle param_nh = ros::NodeHandle("~") );
+    
+    /*! Returns the information gain calculator of the world, which computes information gains and map metrics.
+     */
+    boost::shared_ptr<CommunicationInterface> igCalculator();
+    
+    /*! Returns a function through which modules in the same process hand pointclouds directly to the world, instead of
+     * sending them through the "world/pcl_input" service. Returns true if the cloud was inserted.
+     */
+    boost::function<bool(const sensor_msgs::PointCloud2ConstPtr&)> pointcloudSink();
+    
+    /*! Records the viewspace of the session if the session is recorded (parameter "session_recording/file_path" is set),
+     * does nothing otherwise. Inserted pointclouds and information gain commands are recorded by the world itself.
+     */
+    void recordViewSpace( views::ViewSpace& viewspace );
+    
+  private:
+    class Impl;
+    boost::shared_ptr<Impl> impl_; //! Holds the world with all linked objects and ROS interfaces.
+  };
+  
+}
+
+}
+
+}
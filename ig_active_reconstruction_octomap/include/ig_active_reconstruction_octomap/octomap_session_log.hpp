@@ -0,0 +1,189 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+
+#include "ig_active_reconstruction/world_representation_communication_interface.hpp"
+#include "ig_active_reconstruction/world_representation_pinhole_cam_raycaster.hpp"
+#include "ig_active_reconstruction/view_space.hpp"
+#include "ig_active_reconstruction_octomap/octomap_ig_tree.hpp"
+#include "ig_active_reconstruction_octomap/octomap_information_gain.hpp"
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+
+namespace octomap
+{
+  
+  /*! Record types of a session log, to be treated as scoped enum.
+   */
+  struct SessionRecordType
+  {
+    enum Enum
+    {
+      NONE=0, //! No (valid) record.
+      SETUP=1, //! Configuration of the world representation.
+      POINTCLOUD=2, //! Pointcloud that was inserted, along with its sensor transform.
+      IG_COMMAND=3, //! Information gain retrieval command.
+      VIEWSPACE=4 //! Viewspace of the session.
+    };
+  };
+  
+  /*! Configuration of the world representation during a recorded session, such that a replay runs on an identically
+   * configured world.
+   */
+  struct SessionSetup
+  {
+  public:
+    /*! Constructor sets the defaults of the respective configurations.
+     */
+    SessionSetup();
+    
+  public:
+    IgTree::Config octree; //! Octree configuration.
+    PinholeCamRayCaster::Config camera; //! Ray caster configuration of the information gain calculator.
+    InformationGain<IgTree>::Config ig; //! Information gain configuration.
+    bool use_bounding_box; //! Whether the pointcloud input filters with a bounding box. Default: false.
+    Eigen::Vector3d bounding_box_min_point_m; //! Bounding box minimum [m]. Default: lowest double.
+    Eigen::Vector3d bounding_box_max_point_m; //! Bounding box maximum [m]. Default: largest double.
+    double max_sensor_range_m; //! Maximal range of the pointcloud input [m], negative for none. Default: -1.
+    double occlusion_update_dist_m; //! Occlusion update distance of the occlusion calculator [m], negative if none was used. Default: -1.
+  };
+  
+  /*! Records the inputs of a reconstruction session into a compact binary log: Every pointcloud that is inserted into the
+   * world along with its sensor transform, every information gain retrieval command and the viewspace. Replaying the log
+   * (see SessionLogReader and the replay_session executable) reproduces the exact workload of the session, without any
+   * robot, ROS or viewplanner involved.
+   * 
+   * The log consists of a header followed by records, each being a type, its payload size and the payload. Numbers are
+   * written in the byte order of the recording machine. All record functions are thread-safe.
+   */
+  class SessionRecorder
+  {
+  public:
+    typedef boost::shared_ptr<SessionRecorder> Ptr;
+    
+  public:
+    SessionRecorder();
+    
+    /*! Opens a new log, replacing an existing file.
+     * @param path Path of the log file.
+     * @return False if the file couldn't be opened.
+     */
+    bool open( std::string path );
+    
+    /*! Closes the log, further records are dropped.
+     */
+    void close();
+    
+    /*! Returns true if a log is open.
+     */
+    bool isOpen();
+    
+    /*! Records the configuration of the world.
+     */
+    void recordSetup( const SessionSetup& setup );
+    
+    /*! Records a pointcloud, only the point coordinates are stored.
+     * @param sensor_to_world Transform from sensor to world coordinates.
+     * @param pc Pointcloud in sensor coordinates.
+     */
+    template<class POINTCLOUD_TYPE>
+    void recordPointcloud( const Eigen::Transform<double,3,Eigen::Affine>& sensor_to_world, const POINTCLOUD_TYPE& pc );
+    
+    /*! Records an information gain retrieval command.
+     */
+    void recordIgCommand( const CommunicationInterface::IgRetrievalCommand& command );
+    
+    /*! Records the poses of all views of a viewspace.
+     */
+    void recordViewSpace( views::ViewSpace& viewspace );
+    
+  protected:
+    /*! Writes a record to the log.
+     */
+    void write( SessionRecordType::Enum type, const std::vector<char>& payload );
+    
+  protected:
+    boost::mutex mutex_; //! Guards the file.
+    std::ofstream file_; //! Log file.
+  };
+  
+  /*! Reads the records of a log written by SessionRecorder, one by one.
+   */
+  class SessionLogReader
+  {
+  public:
+    SessionLogReader();
+    
+    /*! Opens a log.
+     * @param path Path of the log file.
+     * @return False if the file couldn't be opened or isn't a session log.
+     */
+    bool open( std::string path );
+    
+    /*! Reads the next record. A record whose payload size exceeds the rest of the file (being corrupt or incomplete) is
+     * returned with an empty payload, thus it fails to decode, and ends the log.
+     * @return Type of the record, NONE at the end of the log.
+     */
+    SessionRecordType::Enum next();
+    
+    /*! Decodes the current record as setup. Returns false if it is of another type.
+     */
+    bool get( SessionSetup& setup ) const;
+    
+    /*! Decodes the current record as pointcloud. Returns false if it is of another type.
+     * @param sensor_to_world (Output) Transform from sensor to world coordinates.
+     * @param pc (Output) Pointcloud in sensor coordinates, previous content is discarded.
+     */
+    template<class POINTCLOUD_TYPE>
+    bool getPointcloud( Eigen::Transform<double,3,Eigen::Affine>& sensor_to_world, POINTCLOUD_TYPE& pc ) const;
+    
+    /*! Decodes the current record as information gain retrieval command. Returns false if it is of another type.
+     */
+    bool get( CommunicationInterface::IgRetrievalCommand& command ) const;
+    
+    /*! Decodes the current record as viewspace, the views are appended. Returns false if it is of another type.
+     */
+    bool get( views::ViewSpace& viewspace ) const;
+    
+  protected:
+    std::ifstream file_; //! Log file.
+    std::streamoff file_size_; //! Size of the log file.
+    SessionRecordType::Enum type_; //! Type of the current record.
+    std::vector<char> payload_; //! Payload of the current record.
+  };
+  
+}
+
+}
+
+}
+
+#include "../src/code_base/octomap_session_log.inl"
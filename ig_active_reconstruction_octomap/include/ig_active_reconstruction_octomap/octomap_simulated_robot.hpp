@@ -0,0 +1,116 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+#pragma once
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include "ig_active_reconstruction/robot_communication_interface.hpp"
+#include "ig_active_reconstruction_octomap/octomap_simulated_sensor.hpp"
+#include "ig_active_reconstruction_octomap/octomap_pcl_input.hpp"
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+
+namespace octomap
+{
+  
+  /*! Headless robot interface that replaces the real robot (and the simulator it runs in) by a simulated sensor: Movements
+   * are executed instantaneously and data retrieval synthesizes a pointcloud by ray casting on the ground truth of the sensor,
+   * which is inserted directly into a pointcloud input of the world representation. The complete view planning loop can
+   * thus be run deterministically within a single process, without ROS or Gazebo.
+   * 
+   * Requires c++11, since the robot communication interface does.
+   */
+  template<class TREE_TYPE, class POINTCLOUD_TYPE>
+  class SimulatedRobot: public robot::CommunicationInterface
+  {
+  public:
+    typedef boost::shared_ptr< SimulatedRobot<TREE_TYPE,POINTCLOUD_TYPE> > Ptr;
+    typedef SimulatedSensor<TREE_TYPE,POINTCLOUD_TYPE> Sensor;
+    typedef PclInput<TREE_TYPE,POINTCLOUD_TYPE> Input;
+    typedef views::View View;
+    typedef robot::MovementCost MovementCost;
+    
+  public:
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    
+    /*! Constructor.
+     * @param sensor Simulated sensor that is carried by the robot.
+     * @param input Pointcloud input of the world representation into which retrieved data is inserted.
+     * @param initial_view Initial sensor pose.
+     */
+    SimulatedRobot( typename Sensor::Ptr sensor, boost::shared_ptr<Input> input, View initial_view = View() );
+    
+    /*! returns the current view */
+    virtual View getCurrentView();
+    
+    /*! Captures a pointcloud at the current view and inserts it into the world representation.
+     * @return Always SUCCEEDED, an empty measurement is a valid measurement.
+     */
+    virtual ReceptionInfo retrieveData();
+    
+    /*! Returns the cost to move from the current view to the indicated view
+     * @param target_view the next view
+     * @return cost to move to that view: Simple distance
+     */
+    virtual MovementCost movementCost( View& target_view );
+    
+    /*! returns the cost to move from start view to target view
+     * @param start_view the start view
+     * @param target_view the target view
+     * @param fill_additional_information if true then the different parts of the cost will be included in the additional fields as well
+     * @return cost for the movement: Simple distance.
+     */
+    virtual MovementCost movementCost( View& start_view, View& target_view, bool fill_additional_information );
+    
+    /*! Moves the sensor to the target view, instantaneously.
+     * @param target_view where to move to
+     * @return Always true.
+     */
+    virtual bool moveTo( View& target_view );
+    
+    /*! Returns the number of pointclouds that were captured so far.
+     */
+    unsigned int numberOfMeasurements();
+    
+    /*! Returns the distance the sensor travelled so far [m].
+     */
+    double travelledDistance();
+    
+  protected:
+    typename Sensor::Ptr sensor_; //! Simulated sensor.
+    boost::shared_ptr<Input> input_; //! Input of the world representation.
+    
+    boost::mutex mutex_; //! Protects the state below, the cost functions may be called from several threads.
+    View current_view_; //! Current sensor pose.
+    unsigned int number_of_measurements_; //! Number of captured pointclouds.
+    double travelled_distance_m_; //! Travelled distance [m].
+  };
+  
+}
+
+}
+
+}
+
+#include "../src/code_base/octomap_simulated_robot.inl"
@@ -0,0 +1,116 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#pragma once
+
+#include <boost/shared_ptr.hpp>
+#include <Eigen/Core>
+#include <Eigen/Geometry>
+#include <movements/core>
+
+#include "ig_active_reconstruction/world_representation_pinhole_cam_raycaster.hpp"
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+
+namespace octomap
+{
+  
+  /*! Simulates a depth sensor by casting the rays of a pinhole camera on a ground truth octree: Each ray that hits an
+   * occupied voxel within the maximal ray depth yields a point. The rays are the same as the ones cast by the information
+   * gain calculator for the same camera configuration, which makes predicted and received information directly comparable.
+   * 
+   * The ground truth can be loaded from a binary octomap file (.bt) or be built from primitives (boxes, spheres), and
+   * is never changed by the sensor.
+   */
+  template<class TREE_TYPE, class POINTCLOUD_TYPE>
+  class SimulatedSensor
+  {
+  public:
+    typedef boost::shared_ptr< SimulatedSensor<TREE_TYPE,POINTCLOUD_TYPE> > Ptr;
+    typedef TREE_TYPE TreeType;
+    typedef POINTCLOUD_TYPE PclType;
+    
+    struct Config
+    {
+    public:
+      Config();
+      
+    public:
+      PinholeCamRayCaster::Config camera; //! Camera intrinsics, image size and maximal ray depth of the sensor. The default is a 640x480 px camera with 525 px focal length and 10 m range.
+    };
+    
+  public:
+    /*! Constructor.
+     * @param ground_truth Octree whose occupied voxels are observed by the sensor.
+     * @param config Configuration.
+     */
+    SimulatedSensor( boost::shared_ptr<TREE_TYPE> ground_truth, Config config = Config() );
+    
+    /*! Returns the ground truth octree.
+     */
+    boost::shared_ptr<TREE_TYPE> groundTruth();
+    
+    /*! Simulates a measurement from the given pose.
+     * @param sensor_pose Pose of the sensor in world coordinates.
+     * @param pc (Output) Measured points in sensor coordinates, previous content is discarded.
+     */
+    void capture( movements::Pose sensor_pose, POINTCLOUD_TYPE& pc );
+    
+    /*! Returns the transform from sensor to world coordinates for a sensor at the given pose, as expected by PclInput::push().
+     */
+    static Eigen::Transform<double,3,Eigen::Affine> sensorToWorld( const movements::Pose& sensor_pose );
+    
+    /*! Loads a ground truth from a binary octomap file.
+     * @param path Path to the file.
+     * @param tree (Output) Tree into which the file is read.
+     * @return False if the file couldn't be read.
+     */
+    static bool loadGroundTruth( std::string path, TREE_TYPE& tree );
+    
+    /*! Marks all voxels whose centers lie within an axis aligned box as occupied.
+     * @param tree Ground truth octree.
+     * @param min_m Minimal corner of the box [m].
+     * @param max_m Maximal corner of the box [m].
+     */
+    static void addBox( TREE_TYPE& tree, Eigen::Vector3d min_m, Eigen::Vector3d max_m );
+    
+    /*! Marks all voxels whose centers lie within a sphere as occupied.
+     * @param tree Ground truth octree.
+     * @param center_m Center of the sphere [m].
+     * @param radius_m Radius of the sphere [m].
+     */
+    static void addSphere( TREE_TYPE& tree, Eigen::Vector3d center_m, double radius_m );
+    
+  protected:
+    boost::shared_ptr<TREE_TYPE> ground_truth_; //! Observed octree.
+    PinholeCamRayCaster ray_caster_; //! Generates the rays of the camera.
+    double max_ray_depth_m_; //! Maximal ray depth [m].
+  };
+  
+}
+
+}
+
+}
+
+#include "../src/code_base/octomap_simulated_sensor.inl"
@@ -18,10 +18,13 @@
 #pragma once
 
 #include <pcl/common/projection_matrix.h>
+#include <boost/thread/mutex.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 #include <Eigen/Core>
 #include <Eigen/Geometry>
 
 #include "ig_active_reconstruction_octomap/octomap_pcl_input.hpp"
+#include "ig_active_reconstruction_octomap/octomap_session_log.hpp"
 
 namespace ig_active_reconstruction
 {
@@ -56,6 +59,27 @@ namespace octomap
       double max_sensor_range_m; //! Maximal range for integrating sensor data [m]. Anything exceeding this distance will be dropped. For negative values, it is ignored. Default: -1.
     };
     
+    /*! Sizes and per-phase durations of a pointcloud insertion.
+     */
+    struct InsertionStatistics
+    {
+    public:
+      /*! Constructor sets all values to zero. */
+      InsertionStatistics();
+      
+    public:
+      size_t number_of_points; //! Points of the pushed cloud.
+      size_t number_of_valid_points; //! Points left after filtering.
+      size_t number_of_free_voxels; //! Voxels traversed by the rays, updated as free unless they are end points as well.
+      size_t number_of_occupied_voxels; //! Voxels at the end points of the rays, updated as occupied.
+      long node_count_delta; //! Change of the number of tree nodes, including the occlusion calculator's updates. Negative if pruning removed more nodes than were created.
+      double filter_s; //! Transformation and filtering of the cloud [s].
+      double key_computation_s; //! Computation of the free and occupied voxel keys through ray casting [s].
+      double free_update_s; //! Update of the free voxels [s].
+      double occupied_update_s; //! Update of the occupied voxels [s].
+      double occlusion_s; //! Occlusion calculation [s], 0 if no occlusion calculator is set.
+    };
+    
   public:
     /*! Constructor
      * @param config Configuration.
@@ -73,8 +97,24 @@ namespace octomap
      */
     virtual void push( const Eigen::Transform<double,3,Eigen::Affine>& sensor_to_world, POINTCLOUD_TYPE& pcl );
     
+    /*! Sets a recorder to which every pushed pointcloud is recorded before it is inserted. Pass an empty pointer to stop recording.
+     */
+    void setRecorder( boost::shared_ptr<SessionRecorder> recorder );
+    
+    /*! Returns the statistics of the last insertion.
+     */
+    InsertionStatistics lastInsertionStatistics();
+    
+  protected:
+    /*! Returns the seconds that passed since start.
+     */
+    static double secondsSince( boost::posix_time::ptime start );
+    
   protected:
     Config config_;
+    boost::shared_ptr<SessionRecorder> recorder_; //! Records pushed pointclouds if set.
+    boost::mutex statistics_mutex_; //! Guards the statistics.
+    InsertionStatistics last_statistics_; //! Statistics of the last insertion.
   };
   
 }
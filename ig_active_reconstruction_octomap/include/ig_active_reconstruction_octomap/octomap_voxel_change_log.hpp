@@ -0,0 +1,77 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#pragma once
+
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <octomap/OcTreeKey.h>
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+  
+namespace octomap
+{
+  
+  /*! Collects the keys of voxels whose occupancy was changed, along with their new occupancy, such that consumers (e.g.
+   * map visualization) can update their state incrementally instead of traversing the complete tree. Whoever changes voxels
+   * collects the keys locally and records them in one call, consumers take all changes recorded since their last call.
+   * 
+   * Recording is disabled until a consumer enables it, such that the log doesn't grow if nobody takes the changes.
+   */
+  class VoxelChangeLog
+  {
+  public:
+    typedef boost::shared_ptr<VoxelChangeLog> Ptr;
+    
+  public:
+    VoxelChangeLog();
+    
+    /*! Enables or disables recording, disabling it drops all changes that weren't taken yet.
+     */
+    void setEnabled( bool enabled );
+    
+    /*! Returns true if changes are recorded.
+     */
+    bool isEnabled();
+    
+    /*! Records a set of changed voxels, later changes of the same voxel replace earlier ones.
+     * @param changes Keys of the changed voxels at maximal tree depth along with their occupancy after the change (true if occupied).
+     */
+    void record( const ::octomap::KeyBoolMap& changes );
+    
+    /*! Takes all changes recorded since the last call, O(1).
+     * @param changes (Output) Changed keys with their latest occupancy, previous content is discarded.
+     */
+    void take( ::octomap::KeyBoolMap& changes );
+    
+  protected:
+    boost::mutex mutex_; //! Guards the members below.
+    bool enabled_; //! Whether changes are recorded.
+    ::octomap::KeyBoolMap changes_; //! Changes that weren't taken yet.
+  };
+  
+}
+
+}
+
+}
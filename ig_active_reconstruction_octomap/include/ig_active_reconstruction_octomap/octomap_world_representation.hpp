@@ -17,6 +17,9 @@
 
 #pragma once
 
+#include "ig_active_reconstruction_octomap/octomap_map_metric_counters.hpp"
+#include "ig_active_reconstruction_octomap/octomap_voxel_change_log.hpp"
+
 namespace ig_active_reconstruction
 {
   
@@ -41,6 +44,8 @@ namespace octomap
     struct Link
     {
       boost::shared_ptr<TREE_TYPE> octree;
+      boost::shared_ptr< MapMetricCounters<TREE_TYPE> > counters; //! Map metric counters, to be updated by objects that change the octree. Might be NULL.
+      VoxelChangeLog::Ptr changes; //! Log of voxels whose occupancy changed, to be fed by objects that change the octree. Might be NULL.
     };
     
     /*! Base class providing "link-functionality"
@@ -61,6 +66,14 @@ namespace octomap
     
     virtual ~WorldRepresentation();
     
+    /*! Returns the map metric counters which are kept up to date by the linked objects that change the octree.
+     */
+    boost::shared_ptr< MapMetricCounters<TREE_TYPE> > mapMetricCounters();
+    
+    /*! Returns the log of changed voxels which is fed by the linked objects that change the octree.
+     */
+    VoxelChangeLog::Ptr voxelChangeLog();
+    
     /*! (cpp11 version)Returns a shared pointer to an object on which a setLink() was called, with a link object linking to the world representation. 
      * The type of the object is the first template parameter of the function. It must be a templated type where the first template argument is
      * the TREE_TYPE. It is automatically templated on the TREE_TYPE used within the world representation. If the linked object expects
@@ -111,6 +124,8 @@ namespace octomap
     
   protected:
     boost::shared_ptr<TREE_TYPE> octree_; //! Octomap tree instance.
+    boost::shared_ptr< MapMetricCounters<TREE_TYPE> > counters_; //! Map metric counters for the octree.
+    VoxelChangeLog::Ptr changes_; //! Log of changed voxels of the octree.
   };
   
 }
@@ -15,6 +15,8 @@
  * on <http://www.gnu.org/licenses/>.
 */
 
+#define TEMPT template<class TREE_TYPE>
+#define CSCOPE OmniCalculator<TREE_TYPE>
 
 namespace ig_active_reconstruction
 {
@@ -25,10 +27,99 @@ namespace world_representation
 namespace octomap
 {  
   
+  TEMPT
+  CSCOPE::Config::Config()
+  : metric(TOTAL_ENTROPY)
+  {
+    
+  }
   
+  TEMPT
+  CSCOPE::OmniCalculator( Config config )
+  : config_(config)
+  {
+    
+  }
   
+  TEMPT
+  std::string CSCOPE::type()
+  {
+    return name(config_.metric);
+  }
+  
+  TEMPT
+  typename CSCOPE::Result CSCOPE::calculateOn( Link& link )
+  {
+    return select( config_.metric, calculateAll(link) );
+  }
+  
+  TEMPT
+  typename CSCOPE::Values CSCOPE::calculateAll( Link& link )
+  {
+    if( link.counters!=NULL )
+      return link.counters->values();
+    
+    if( link.octree==NULL )
+      return Values();
+    
+    MapMetricCounters<TREE_TYPE> counters(link.octree);
+    counters.rebuild();
+    return counters.values();
+  }
+  
+  TEMPT
+  typename CSCOPE::Result CSCOPE::select( Metric metric, const Values& values )
+  {
+    switch(metric)
+    {
+      case TOTAL_ENTROPY:
+	return values.total_entropy;
+      case TOTAL_VOXELS:
+	return static_cast<Result>(values.total_voxels);
+      case KNOWN_VOXELS:
+	return static_cast<Result>(values.known_voxels);
+      case UNKNOWN_VOXELS:
+	return static_cast<Result>(values.unknown_voxels);
+      case OCCUPIED_VOXELS:
+	return static_cast<Result>(values.occupied_voxels);
+      case FREE_VOXELS:
+	return static_cast<Result>(values.free_voxels);
+      case OCCLUDED_VOXELS:
+	return static_cast<Result>(values.occluded_voxels);
+      default:
+	return 0;
+    }
+  }
+  
+  TEMPT
+  std::string CSCOPE::name( Metric metric )
+  {
+    switch(metric)
+    {
+      case TOTAL_ENTROPY:
+	return "TotalEntropy";
+      case TOTAL_VOXELS:
+	return "TotalVoxelCount";
+      case KNOWN_VOXELS:
+	return "KnownVoxelCount";
+      case UNKNOWN_VOXELS:
+	return "UnknownVoxelCount";
+      case OCCUPIED_VOXELS:
+	return "OccupiedVoxelCount";
+      case FREE_VOXELS:
+	return "FreeVoxelCount";
+      case OCCLUDED_VOXELS:
+	return "OccludedVoxelCount";
+      default:
+	return "Undefined";
+    }
+  }
+  
+}
+
 }
 
 }
 
-}
\ No newline at end of file
+#undef CSCOPE
+#undef TEMPT
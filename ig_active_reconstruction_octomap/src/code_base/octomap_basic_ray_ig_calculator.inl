@@ -18,8 +18,11 @@
 #define TEMPT template<class TREE_TYPE>
 #define CSCOPE BasicRayIgCalculator<TREE_TYPE>
 
+#include <algorithm>
 #include <octomap/octomap_types.h>
 #include <boost/foreach.hpp>
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
 
 namespace ig_active_reconstruction
 {
@@ -32,6 +35,7 @@ namespace octomap
   TEMPT
   CSCOPE::Config::Config()
   : ray_caster_config()
+  , number_of_threads(0)
   {
     
   }
@@ -40,6 +44,7 @@ namespace octomap
   CSCOPE::BasicRayIgCalculator( Config config )
   : config_(config)
   , ray_caster_(config.ray_caster_config)
+  , thread_pool_( boost::make_shared<ThreadPool>(config.number_of_threads) )
   {
   }
   
@@ -49,9 +54,18 @@ namespace octomap
     ray_caster_.setConfig(config);
   }
   
+  TEMPT
+  void CSCOPE::setRecorder( boost::shared_ptr<SessionRecorder> recorder )
+  {
+    recorder_ = recorder;
+  }
+  
   TEMPT
   typename CSCOPE::ResultInformation CSCOPE::computeViewIg(IgRetrievalCommand& command, ViewIgRetrievalResult& output_ig)
   {
+    if( recorder_ )
+      recorder_->recordIgCommand(command);
+    
     output_ig.clear();
     
     // Can't calculate ig for no given view.
@@ -78,7 +92,6 @@ namespace octomap
     ray_caster_config.max_y_perc = command.config.ray_window.max_y_perc;
     
     //ray_caster_.setResolution(ray_caster_config);
-    boost::shared_ptr<RayCaster::RaySet> ray_set = ray_caster_.getRaySet(command.path[0]);
     
     // build ig metric set
     std::vector< boost::shared_ptr< InformationGain<TREE_TYPE> > > ig_set;
@@ -127,17 +140,46 @@ namespace octomap
     RayCastSettings ray_cast_settings;
     ray_cast_settings.max_ray_depth = config_.ray_caster_config.max_ray_depth_m;//command.config.max_ray_depth;
     
-    for(unsigned int i=0;i<ray_set->size();++i)
+    // for several poses, each voxel counts with its largest contribution from a single pose
+    bool is_path = command.path.size()>1;
+    VoxelContributions path_contributions;
+    
+    BOOST_FOREACH( movements::Pose& pose, command.path )
     {
-      RayCaster::Ray& ray = (*ray_set)[i];
-      //std::cout<<"\norigin:\n"<<ray.origin<<"\ndirection:\n"<<ray.direction<<"\n";
-      BOOST_FOREACH( typename InformationGain<TREE_TYPE>::Ptr& ig, ig_set )
+      boost::shared_ptr<RayCaster::RaySet> ray_set = ray_caster_.getRaySet(pose);
+      VoxelContributions pose_contributions;
+      
+      for(unsigned int i=0;i<ray_set->size();++i)
       {
-	ig->makeReadyForNewRay();
+	RayCaster::Ray& ray = (*ray_set)[i];
+	//std::cout<<"\norigin:\n"<<ray.origin<<"\ndirection:\n"<<ray.direction<<"\n";
+	BOOST_FOREACH( typename InformationGain<TREE_TYPE>::Ptr& ig, ig_set )
+	{
+	  ig->makeReadyForNewRay();
+	}
+	/*if(i%100==0)
+	  std::cout<<"\nCalculating ray "<<i<<"/"<<ray_set->size();*/
+	calculateIgsOnRay(ray,ig_set, ray_cast_settings, is_path?&pose_contributions:NULL);
+      }
+      
+      BOOST_FOREACH( typename VoxelContributions::value_type& voxel, pose_contributions )
+      {
+	std::vector<double>& best = path_contributions[voxel.first];
+	best.resize( ig_set.size(), 0 );
+	for( size_t m=0; m<ig_set.size(); ++m )
+	{
+	  best[m] = std::max( best[m], voxel.second[m] );
+	}
+      }
+    }
+    
+    std::vector<double> path_igs( ig_set.size(), 0 );
+    BOOST_FOREACH( typename VoxelContributions::value_type& voxel, path_contributions )
+    {
+      for( size_t m=0; m<ig_set.size(); ++m )
+      {
+	path_igs[m] += voxel.second[m];
       }
-      /*if(i%100==0)
-	std::cout<<"\nCalculating ray "<<i<<"/"<<ray_set->size();*/
-      calculateIgsOnRay(ray,ig_set, ray_cast_settings);
     }
     
     // retrieve information gains and build output
@@ -146,7 +188,7 @@ namespace octomap
     {
       if( res.status == ResultInformation::SUCCEEDED )
       {
-	res.predicted_gain = (*ig_it)->getInformation();
+	res.predicted_gain = is_path? path_igs[ig_it-ig_set.begin()] : (*ig_it)->getInformation();
 	std::cout<<"\nPredicted gain is: "<<res.predicted_gain;
 	++ig_it;
       }
@@ -155,10 +197,53 @@ namespace octomap
     return ResultInformation::SUCCEEDED;
   }
   
+  TEMPT
+  typename CSCOPE::ResultInformation CSCOPE::computeViewspaceIg(ViewspaceIgRetrievalCommand& command, ViewspaceIgResult& output_ig)
+  {
+    output_ig.clear();
+    output_ig.resize( command.poses.size() );
+    
+    thread_pool_->parallelFor( command.poses.size(), boost::bind( &CSCOPE::computePoseIg, this, &command, &output_ig, _1 ) );
+    
+    return ResultInformation::SUCCEEDED;
+  }
+  
+  TEMPT
+  void CSCOPE::computePoseIg( ViewspaceIgRetrievalCommand* command, ViewspaceIgResult* output_ig, size_t index )
+  {
+    IgRetrievalCommand view_command;
+    view_command.path.push_back( command->poses[index] );
+    view_command.metric_names = command->metric_names;
+    view_command.metric_ids = command->metric_ids;
+    view_command.config = command->config;
+    
+    computeViewIg( view_command, (*output_ig)[index] );
+  }
+  
   TEMPT
   typename CSCOPE::ResultInformation CSCOPE::computeMapMetric(MapMetricRetrievalCommand& command, MapMetricRetrievalResultSet& output)
   {
+    output.clear();
     
+    BOOST_FOREACH( std::string& name, command.metric_names )
+    {
+      MapMetricRetrievalResult res;
+      res.value = 0;
+      
+      typename MmFactory::TypePtr map_metric = this->mm_factory_.get(name);
+      if( map_metric==NULL )
+      {
+	res.status = ResultInformation::UNKNOWN_METRIC;
+      }
+      else
+      {
+	res.status = ResultInformation::SUCCEEDED;
+	res.value = map_metric->calculateOn(this->link_);
+      }
+      output.push_back(res);
+    }
+    
+    return ResultInformation::SUCCEEDED;
   }
   
   TEMPT
@@ -195,7 +280,7 @@ namespace octomap
   }
   
   TEMPT
-  void CSCOPE::calculateIgsOnRay( RayCaster::Ray& ray, std::vector< boost::shared_ptr< InformationGain<TREE_TYPE> > >& ig_set, RayCastSettings& setting )
+  void CSCOPE::calculateIgsOnRay( RayCaster::Ray& ray, std::vector< boost::shared_ptr< InformationGain<TREE_TYPE> > >& ig_set, RayCastSettings& setting, VoxelContributions* contributions )
   {
     using ::octomap::point3d;
     using ::octomap::KeyRay;
@@ -221,23 +306,13 @@ namespace octomap
       this->link_.octree->computeRayKeys( origin, end_point, ray );
       for( KeyRay::iterator it = ray.begin() ; it!=ray.end(); ++it )
       {
-	point3d coord = this->link_.octree->keyToCoord(*it);
-	typename TREE_TYPE::NodeType* traversedVoxel = this->link_.octree->search(*it);
-	BOOST_FOREACH( typename InformationGain<TREE_TYPE>::Ptr& ig, ig_set )
-	{
-	  ig->includeRayMeasurement( traversedVoxel );
-	}
+	includeVoxel( *it, false, ig_set, contributions );
       }
       
       OcTreeKey end_key;
       if( this->link_.octree->coordToKeyChecked(end_point, end_key) )
       {
-	typename TREE_TYPE::NodeType* traversedVoxel = this->link_.octree->search(end_key);
-	
-	BOOST_FOREACH( typename InformationGain<TREE_TYPE>::Ptr& ig, ig_set )
-	{
-	  ig->includeEndPointMeasurement( traversedVoxel );
-	}
+	includeVoxel( end_key, true, ig_set, contributions );
       }
     }
     else
@@ -249,6 +324,33 @@ namespace octomap
     }
   }
   
+  TEMPT
+  void CSCOPE::includeVoxel( const ::octomap::OcTreeKey& key, bool end_point, std::vector< boost::shared_ptr< InformationGain<TREE_TYPE> > >& ig_set, VoxelContributions* contributions )
+  {
+    typename TREE_TYPE::NodeType* traversedVoxel = this->link_.octree->search(key);
+    
+    std::vector<double>* voxel_contributions = NULL;
+    if( contributions!=NULL )
+    {
+      voxel_contributions = &(*contributions)[key];
+      voxel_contributions->resize( ig_set.size(), 0 );
+    }
+    
+    for( size_t m=0; m<ig_set.size(); ++m )
+    {
+      // the contribution of the voxel is the change it causes, metrics don't expose it otherwise
+      double ig_before = (voxel_contributions!=NULL)? ig_set[m]->getInformation() : 0;
+      
+      if( end_point )
+	ig_set[m]->includeEndPointMeasurement( traversedVoxel );
+      else
+	ig_set[m]->includeRayMeasurement( traversedVoxel );
+      
+      if( voxel_contributions!=NULL )
+	(*voxel_contributions)[m] += ig_set[m]->getInformation() - ig_before;
+    }
+  }
+  
 }
 
 }
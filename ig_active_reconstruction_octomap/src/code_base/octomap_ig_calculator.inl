@@ -63,6 +63,26 @@ namespace octomap
     return boost::shared_ptr< InformationGain<TREE_TYPE> >( new IG_METRIC_TYPE<TREE_TYPE>(utils) );
   }
   
+  TEMPT
+  template<template<typename> class MAP_METRIC_TYPE>
+  unsigned int CSCOPE::registerMapMetric( typename MAP_METRIC_TYPE<TREE_TYPE>::Config config )
+  {
+    MAP_METRIC_TYPE<TREE_TYPE> prototype(config);
+    std::string name = prototype.type();
+    
+    boost::function< boost::shared_ptr< MapMetric<TREE_TYPE> >() > creator;
+    creator = boost::bind(&IgCalculator<TREE_TYPE>::makeSharedMapMetric<MAP_METRIC_TYPE>, this, config);
+    
+    return mm_factory_.add(name,creator);
+  }
+  
+  TEMPT
+  template<template<typename> class MAP_METRIC_TYPE>
+  boost::shared_ptr< MapMetric<TREE_TYPE> > CSCOPE::makeSharedMapMetric(typename MAP_METRIC_TYPE<TREE_TYPE>::Config config)
+  {
+    return boost::shared_ptr< MapMetric<TREE_TYPE> >( new MAP_METRIC_TYPE<TREE_TYPE>(config) );
+  }
+  
 }
 
 }
@@ -47,6 +47,10 @@ namespace octomap
     for (unsigned int k=0; k<8; k++) {
       createChild(k);
       children[k]->setValue(value);
+      // children represent the same voxels as their pruned parent
+      getChild(k)->occ_dist_ = occ_dist_;
+      getChild(k)->max_dist_ = max_dist_;
+      getChild(k)->has_no_measurement_ = has_no_measurement_;
     }
   }
   
@@ -58,6 +62,9 @@ namespace octomap
 
     // set value to children's values (all assumed equal)
     setValue(getChild(0)->getValue());
+    occ_dist_ = getChild(0)->occ_dist_;
+    max_dist_ = getChild(0)->max_dist_;
+    has_no_measurement_ = getChild(0)->has_no_measurement_;
 
     // delete children
     for (unsigned int i=0;i<8;i++) {
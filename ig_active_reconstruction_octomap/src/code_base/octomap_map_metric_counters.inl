@@ -0,0 +1,149 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+#define TEMPT template<class TREE_TYPE>
+#define CSCOPE MapMetricCounters<TREE_TYPE>
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+  
+namespace octomap
+{  
+  TEMPT
+  CSCOPE::VoxelState::VoxelState()
+  : exists(false)
+  , has_measurement(false)
+  , p_occupancy(0)
+  , occluded(false)
+  {
+    
+  }
+  
+  TEMPT
+  CSCOPE::Values::Values()
+  : total_entropy(0)
+  , total_voxels(0)
+  , known_voxels(0)
+  , unknown_voxels(0)
+  , occupied_voxels(0)
+  , free_voxels(0)
+  , occluded_voxels(0)
+  {
+    
+  }
+  
+  TEMPT
+  CSCOPE::MapMetricCounters( boost::shared_ptr<TREE_TYPE> octree, Config config )
+  : octree_(octree)
+  , utils_(config)
+  {
+    
+  }
+  
+  TEMPT
+  void CSCOPE::setConfig( Config config )
+  {
+    {
+      boost::mutex::scoped_lock lock(mutex_);
+      utils_.config = config;
+    }
+    rebuild();
+  }
+  
+  TEMPT
+  typename CSCOPE::VoxelState CSCOPE::stateOf( typename TREE_TYPE::NodeType* voxel )
+  {
+    VoxelState state;
+    if( voxel==NULL )
+      return state;
+    
+    state.exists = true;
+    state.has_measurement = voxel->hasMeasurement();
+    state.p_occupancy = utils_.pOccupancy(voxel);
+    state.occluded = !state.has_measurement && voxel->occDist()!=-1;
+    return state;
+  }
+  
+  TEMPT
+  void CSCOPE::update( const VoxelState& before, const VoxelState& after )
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    add( before, -1, values_ );
+    add( after, 1, values_ );
+  }
+  
+  TEMPT
+  typename CSCOPE::Values CSCOPE::values()
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    return values_;
+  }
+  
+  TEMPT
+  void CSCOPE::rebuild()
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    
+    Values values;
+    unsigned int tree_depth = octree_->getTreeDepth();
+    for( typename TREE_TYPE::leaf_iterator it = octree_->begin_leafs(), end = octree_->end_leafs(); it!=end; ++it )
+    {
+      int64_t represented_voxels = int64_t(1)<<( 3*(tree_depth-it.getDepth()) );
+      add( stateOf(&(*it)), represented_voxels, values );
+    }
+    values_ = values;
+  }
+  
+  TEMPT
+  void CSCOPE::add( const VoxelState& state, int64_t number, Values& values )
+  {
+    if( !state.exists )
+      return;
+    
+    values.total_voxels += number;
+    values.total_entropy += number*utils_.entropy(state.p_occupancy);
+    
+    if( utils_.isOccupied(state.p_occupancy) )
+    {
+      values.occupied_voxels += number;
+      values.known_voxels += number;
+    }
+    else if( utils_.isFree(state.p_occupancy) )
+    {
+      values.free_voxels += number;
+      values.known_voxels += number;
+    }
+    else
+    {
+      values.unknown_voxels += number;
+    }
+    
+    if( state.occluded )
+      values.occluded_voxels += number;
+  }
+}
+
+}
+
+}
+
+#undef CSCOPE
+#undef TEMPT
@@ -0,0 +1,184 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+#define TEMPT template<class TREE_TYPE>
+#define CSCOPE ParallelTraversal<TREE_TYPE>
+
+#include <boost/thread/thread.hpp>
+#include <boost/bind.hpp>
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+
+namespace octomap
+{
+  TEMPT
+  CSCOPE::Config::Config()
+  : partition_depth(3)
+  , number_of_threads(0)
+  {
+    
+  }
+  
+  TEMPT
+  CSCOPE::ParallelTraversal( Config config )
+  : config_(config)
+  {
+    
+  }
+  
+  TEMPT
+  template<class ACCUMULATOR, class VISITOR, class REDUCER>
+  ACCUMULATOR CSCOPE::traverseLeafs( VISITOR visit, REDUCER reduce, ACCUMULATOR init )
+  {
+    NodeType* root = this->link_.octree->getRoot();
+    if( root==NULL )
+      return init;
+    
+    unsigned short int center = treeMaxKey();
+    ::octomap::OcTreeKey root_key(center,center,center);
+    
+    std::vector<Subtree> subtrees;
+    partition( root, root_key, 0, subtrees );
+    
+    size_t number_of_threads = config_.number_of_threads;
+    if( number_of_threads==0 )
+      number_of_threads = boost::thread::hardware_concurrency();
+    if( number_of_threads==0 )
+      number_of_threads = 1;
+    if( number_of_threads>subtrees.size() )
+      number_of_threads = subtrees.size();
+    
+    std::vector<ACCUMULATOR> accumulators( number_of_threads, init );
+    size_t next_subtree = 0;
+    boost::mutex mutex;
+    
+    // the calling thread works as well
+    boost::thread_group workers;
+    for( size_t i=1; i<number_of_threads; ++i )
+    {
+      workers.create_thread( boost::bind( &CSCOPE::template work<ACCUMULATOR,VISITOR>, this, &subtrees, &next_subtree, &mutex, visit, &accumulators[i] ) );
+    }
+    work<ACCUMULATOR,VISITOR>( &subtrees, &next_subtree, &mutex, visit, &accumulators[0] );
+    workers.join_all();
+    
+    for( size_t i=0; i<accumulators.size(); ++i )
+    {
+      reduce(init,accumulators[i]);
+    }
+    return init;
+  }
+  
+  TEMPT
+  void CSCOPE::partition( NodeType* node, const ::octomap::OcTreeKey& key, unsigned int depth, std::vector<Subtree>& subtrees )
+  {
+    if( depth>=config_.partition_depth || !node->hasChildren() )
+    {
+      Subtree subtree;
+      subtree.node = node;
+      subtree.key = key;
+      subtree.depth = depth;
+      subtrees.push_back(subtree);
+      return;
+    }
+    
+    unsigned short int offset = childOffset(depth);
+    for( unsigned int i=0; i<8; ++i )
+    {
+      if( node->childExists(i) )
+      {
+	::octomap::OcTreeKey child_key;
+	::octomap::computeChildKey( i, offset, key, child_key );
+	partition( node->getChild(i), child_key, depth+1, subtrees );
+      }
+    }
+  }
+  
+  TEMPT
+  template<class ACCUMULATOR, class VISITOR>
+  void CSCOPE::work( const std::vector<Subtree>* subtrees, size_t* next_subtree, boost::mutex* mutex, VISITOR visit, ACCUMULATOR* accumulator )
+  {
+    for(;;)
+    {
+      size_t index;
+      {
+	boost::mutex::scoped_lock lock(*mutex);
+	if( *next_subtree>=subtrees->size() )
+	  return;
+	index = (*next_subtree)++;
+      }
+      
+      const Subtree& subtree = (*subtrees)[index];
+      visitLeafs( subtree.node, subtree.key, subtree.depth, visit, *accumulator );
+    }
+  }
+  
+  TEMPT
+  template<class ACCUMULATOR, class VISITOR>
+  void CSCOPE::visitLeafs( NodeType* node, const ::octomap::OcTreeKey& key, unsigned int depth, VISITOR& visit, ACCUMULATOR& accumulator )
+  {
+    if( !node->hasChildren() || depth>=this->link_.octree->getTreeDepth() )
+    {
+      Leaf leaf;
+      leaf.node = node;
+      leaf.key = key;
+      leaf.depth = depth;
+      leaf.size = this->link_.octree->getNodeSize(depth);
+      ::octomap::point3d center = this->link_.octree->keyToCoord(key,depth);
+      leaf.x = center.x();
+      leaf.y = center.y();
+      leaf.z = center.z();
+      visit(accumulator,leaf);
+      return;
+    }
+    
+    unsigned short int offset = childOffset(depth);
+    for( unsigned int i=0; i<8; ++i )
+    {
+      if( node->childExists(i) )
+      {
+	::octomap::OcTreeKey child_key;
+	::octomap::computeChildKey( i, offset, key, child_key );
+	visitLeafs( node->getChild(i), child_key, depth+1, visit, accumulator );
+      }
+    }
+  }
+  
+  TEMPT
+  unsigned short int CSCOPE::treeMaxKey() const
+  {
+    return static_cast<unsigned short int>( 1<<(this->link_.octree->getTreeDepth()-1) );
+  }
+  
+  TEMPT
+  unsigned short int CSCOPE::childOffset( unsigned int depth ) const
+  {
+    // same as in the octomap iterators: the root key is at the tree's center and the offset halves with each level
+    return treeMaxKey()>>(depth+1);
+  }
+  
+}
+
+}
+
+}
+
+#undef CSCOPE
+#undef TEMPT
@@ -49,6 +49,9 @@ namespace octomap
     
     double max_nr_of_cells_in_occlusion = 2*occlusion_update_dist_m_/this->link_.octree->getResolution();
     
+    MapMetricCounters<TREE_TYPE>* counters = this->link_.counters.get();
+    typename MapMetricCounters<TREE_TYPE>::VoxelState state_before;
+    
     for( size_t i = 0; i<valid_indices.size(); ++i )
     {
       if( i%1000==0)
@@ -70,6 +73,8 @@ namespace octomap
 	    for( unsigned int dist=1; occ!=end; ++dist, ++occ )
 	    {
 	      typename TREE_TYPE::NodeType* voxel = this->link_.octree->search(*occ);
+	      if( counters!=NULL )
+		state_before = counters->stateOf(voxel);
 			      
 	      if( voxel!=NULL )
 	      {
@@ -87,6 +92,9 @@ namespace octomap
 		  voxel->updateOccDist( dist );
 		  voxel->setMaxDist(max_nr_of_cells_in_occlusion);
 	      }
+	      
+	      if( counters!=NULL )
+		counters->update( state_before, counters->stateOf( this->link_.octree->search(*occ) ) );
 	    }
 	  }
       }
@@ -21,6 +21,9 @@
 #include <visualization_msgs/MarkerArray.h>
 #include <geometry_msgs/Point.h>
 #include <std_msgs/ColorRGBA.h>
+#include <algorithm>
+#include <boost/bind.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
 
 namespace ig_active_reconstruction
 {
@@ -30,12 +33,42 @@ namespace world_representation
 
 namespace octomap
 {
+  TEMPT
+  CSCOPE::Config::Config()
+  : publishing_rate_hz(2.0)
+  , lod_levels(0)
+  , block_levels(4)
+  {
+    
+  }
+  
   TEMPT
   CSCOPE::RosInterface(Config config)
-  : nh_(config.nh)
+  : traversal_(config.traversal_config)
+  , nh_(config.nh)
   , world_frame_name_(config.world_frame_name)
+  , publishing_rate_hz_(config.publishing_rate_hz)
+  , lod_levels_(config.lod_levels)
+  , block_levels_(config.block_levels)
+  , lod_depth_(0)
+  , next_block_id_(0)
+  , number_of_subscribers_(0)
+  {
+    // incremental updates only publish changed markers, thus the queue must not drop any of them
+    voxel_map_publisher_ = nh_.advertise<visualization_msgs::MarkerArray>("occupied_cells_vis_array", 10);
+  }
+  
+  TEMPT
+  CSCOPE::~RosInterface()
   {
-    voxel_map_publisher_ = nh_.advertise<visualization_msgs::MarkerArray>("occupied_cells_vis_array", 1);
+    stopIncrementalPublishing();
+  }
+  
+  TEMPT
+  void CSCOPE::setLink( Link& link )
+  {
+    WorldRepresentation<TREE_TYPE>::LinkedObject::setLink(link);
+    traversal_.setLink(link);
   }
   
   TEMPT
@@ -54,31 +87,13 @@ namespace octomap
     color.b = 1;
     color.a = 1;
     
-    for( typename TREE_TYPE::iterator it = this->link_.octree->begin(), end = this->link_.octree->end(); it!=end; ++it )
-    {
-      double size = it.getSize();
-      double x = it.getX();
-      double y = it.getY();
-      double z = it.getZ();
-      
-      geometry_msgs::Point cubeCenter;
-      cubeCenter.x = x;
-      cubeCenter.y = y;
-      cubeCenter.z = z;
-      unsigned idx = it.getDepth();
-      
-      if( this->link_.octree->isNodeOccupied(*it) )
-      {
-	double size = it.getSize();
-	assert(idx < occupiedNodesVis.markers.size());
-	
-	occupiedNodesVis.markers[idx].points.push_back(cubeCenter);
-      }
-    }
+    // collect the occupied leaves of independent subtrees in parallel
+    PointsPerDepth occupied_points = traversal_.template traverseLeafs<PointsPerDepth>( OccupiedLeafCollector(this->link_.octree.get()), PointsAppender(), PointsPerDepth(occupiedNodesVis.markers.size()) );
     
     for (unsigned i= 0; i < occupiedNodesVis.markers.size(); ++i)
     {
       double size = this->link_.octree->getNodeSize(i);
+      occupiedNodesVis.markers[i].points.swap(occupied_points[i]);
       
       occupiedNodesVis.markers[i].header.frame_id = world_frame_name_;
       occupiedNodesVis.markers[i].header.stamp = ros::Time::now();
@@ -99,6 +114,199 @@ namespace octomap
     voxel_map_publisher_.publish(occupiedNodesVis);
   }
   
+  TEMPT
+  void CSCOPE::startIncrementalPublishing()
+  {
+    if( publishing_thread_.joinable() || this->link_.changes==NULL )
+      return;
+    
+    unsigned int tree_depth = this->link_.octree->getTreeDepth();
+    lod_depth_ = tree_depth - std::min(lod_levels_,tree_depth);
+    
+    this->link_.changes->setEnabled(true);
+    publishing_thread_ = boost::thread( boost::bind(&CSCOPE::incrementalPublishingLoop,this) );
+  }
+  
+  TEMPT
+  void CSCOPE::stopIncrementalPublishing()
+  {
+    if( !publishing_thread_.joinable() )
+      return;
+    
+    publishing_thread_.interrupt();
+    publishing_thread_.join();
+    this->link_.changes->setEnabled(false);
+  }
+  
+  TEMPT
+  void CSCOPE::incrementalPublishingLoop()
+  {
+    boost::posix_time::time_duration period = boost::posix_time::microseconds( static_cast<int64_t>(1e6/std::max(publishing_rate_hz_,1e-3)) );
+    try
+    {
+      while(true)
+      {
+	boost::this_thread::sleep(period);
+	publishVoxelMapChanges();
+      }
+    }
+    catch( boost::thread_interrupted& )
+    {
+    }
+  }
+  
+  TEMPT
+  void CSCOPE::publishVoxelMapChanges()
+  {
+    // the shown voxels are always kept up to date such that new subscribers can get the complete map
+    this->link_.changes->take(changes_);
+    for( ::octomap::KeyBoolMap::iterator it=changes_.begin(); it!=changes_.end(); ++it )
+    {
+      applyChange(it->first,it->second);
+    }
+    
+    uint32_t number_of_subscribers = voxel_map_publisher_.getNumSubscribers();
+    bool republish_all = number_of_subscribers>number_of_subscribers_;
+    number_of_subscribers_ = number_of_subscribers;
+    if( number_of_subscribers==0 )
+      return;
+    
+    if( republish_all )
+    {
+      for( typename BlockMap::iterator it=blocks_.begin(); it!=blocks_.end(); ++it )
+	changed_blocks_.insert(it->first);
+    }
+    if( changed_blocks_.empty() )
+      return;
+    
+    std_msgs::ColorRGBA color;
+    color.r = 0;
+    color.g = 0;
+    color.b = 1;
+    color.a = 1;
+    double size = this->link_.octree->getNodeSize(lod_depth_);
+    ros::Time now = ros::Time::now();
+    
+    visualization_msgs::MarkerArray changed_markers;
+    changed_markers.markers.reserve( changed_blocks_.size() );
+    for( ::octomap::KeySet::iterator block_key=changed_blocks_.begin(); block_key!=changed_blocks_.end(); ++block_key )
+    {
+      typename BlockMap::iterator block = blocks_.find(*block_key);
+      if( block==blocks_.end() )
+	continue;
+      
+      changed_markers.markers.push_back( visualization_msgs::Marker() );
+      visualization_msgs::Marker& marker = changed_markers.markers.back();
+      marker.header.frame_id = world_frame_name_;
+      marker.header.stamp = now;
+      marker.ns = "map_blocks";
+      marker.id = block->second.id;
+      marker.type = visualization_msgs::Marker::CUBE_LIST;
+      marker.scale.x = size;
+      marker.scale.y = size;
+      marker.scale.z = size;
+      marker.color = color;
+      
+      if( block->second.voxels.empty() )
+      {
+	marker.action = visualization_msgs::Marker::DELETE;
+	blocks_.erase(block);
+	continue;
+      }
+      
+      marker.action = visualization_msgs::Marker::ADD;
+      marker.points.reserve( block->second.voxels.size() );
+      for( ::octomap::KeySet::iterator voxel=block->second.voxels.begin(); voxel!=block->second.voxels.end(); ++voxel )
+      {
+	::octomap::point3d center = this->link_.octree->keyToCoord(*voxel,lod_depth_);
+	geometry_msgs::Point point;
+	point.x = center.x();
+	point.y = center.y();
+	point.z = center.z();
+	marker.points.push_back(point);
+      }
+    }
+    changed_blocks_.clear();
+    
+    voxel_map_publisher_.publish(changed_markers);
+  }
+  
+  TEMPT
+  void CSCOPE::applyChange( const ::octomap::OcTreeKey& key, bool occupied )
+  {
+    // only key arithmetic is used on the octree, which doesn't access any nodes
+    if( occupied )
+    {
+      if( !occupied_voxels_.insert(key).second )
+	return;
+    }
+    else
+    {
+      if( occupied_voxels_.erase(key)==0 )
+	return;
+    }
+    
+    ::octomap::OcTreeKey coarse_key = this->link_.octree->adjustKeyAtDepth(key,lod_depth_);
+    unsigned int shift = lod_levels_+block_levels_;
+    ::octomap::OcTreeKey block_key( coarse_key[0]>>shift, coarse_key[1]>>shift, coarse_key[2]>>shift );
+    
+    if( occupied )
+    {
+      unsigned int& count = occupied_per_coarse_voxel_[coarse_key];
+      if( count++>0 )
+	return;
+      
+      typename BlockMap::iterator block = blocks_.find(block_key);
+      if( block==blocks_.end() )
+      {
+	block = blocks_.insert( std::make_pair(block_key,Block()) ).first;
+	block->second.id = next_block_id_++;
+      }
+      block->second.voxels.insert(coarse_key);
+    }
+    else
+    {
+      typename KeyCountMap::iterator count = occupied_per_coarse_voxel_.find(coarse_key);
+      if( count==occupied_per_coarse_voxel_.end() || --(count->second)>0 )
+	return;
+      
+      occupied_per_coarse_voxel_.erase(count);
+      blocks_[block_key].voxels.erase(coarse_key);
+    }
+    changed_blocks_.insert(block_key);
+  }
+  
+  TEMPT
+  CSCOPE::OccupiedLeafCollector::OccupiedLeafCollector( TREE_TYPE* octree )
+  : octree(octree)
+  {
+    
+  }
+  
+  TEMPT
+  void CSCOPE::OccupiedLeafCollector::operator()( PointsPerDepth& points, const typename ParallelTraversal<TREE_TYPE>::Leaf& leaf )
+  {
+    if( !octree->isNodeOccupied(*leaf.node) )
+      return;
+    
+    geometry_msgs::Point cubeCenter;
+    cubeCenter.x = leaf.x;
+    cubeCenter.y = leaf.y;
+    cubeCenter.z = leaf.z;
+    
+    assert(leaf.depth < points.size());
+    points[leaf.depth].push_back(cubeCenter);
+  }
+  
+  TEMPT
+  void CSCOPE::PointsAppender::operator()( PointsPerDepth& total, const PointsPerDepth& part )
+  {
+    for( size_t i=0; i<part.size(); ++i )
+    {
+      total[i].insert( total[i].end(), part[i].begin(), part[i].end() );
+    }
+  }
+  
 }
 
 }
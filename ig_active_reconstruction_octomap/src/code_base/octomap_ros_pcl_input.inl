@@ -18,6 +18,10 @@
 #define TEMPT template<class TREE_TYPE, class POINTCLOUD_TYPE>
 #define CSCOPE RosPclInput<TREE_TYPE,POINTCLOUD_TYPE>
 
+#include <cstring>
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+
 #include <pcl/point_types.h>
 #include <pcl/conversions.h>
 #include <pcl_conversions/pcl_conversions.h>
@@ -40,6 +44,7 @@ namespace octomap
   {
     pcl_subscriber_ = nh_.subscribe("pcl_input",10,&CSCOPE::insertCloudCallback,this);
     pcl_input_service_ = nh_.advertiseService("pcl_input", &CSCOPE::insertCloudService,this);
+    pcl_shm_input_service_ = nh_.advertiseService("pcl_input_shm", &CSCOPE::insertShmCloudService,this);
   }
   
   TEMPT
@@ -49,30 +54,132 @@ namespace octomap
   }
   
   TEMPT
-  void CSCOPE::insertCloudCallback(const sensor_msgs::PointCloud2::ConstPtr& cloud)
+  bool CSCOPE::insertCloud( const sensor_msgs::PointCloud2& cloud )
   {
     ROS_INFO("Received new pointcloud. Inserting...");
     POINTCLOUD_TYPE pc;
-    pcl::fromROSMsg(*cloud, pc);
+    cloudFromView( ros_tools::PointCloud2View(cloud), pc );
     
-    insertCloud(pc);
+    bool inserted = insertCloud(pc);
     ROS_INFO("Inserted new pointcloud");
+    return inserted;
+  }
+  
+  TEMPT
+  void CSCOPE::insertCloudCallback(const sensor_msgs::PointCloud2::ConstPtr& cloud)
+  {
+    insertCloud(*cloud);
   }
   
   TEMPT
   bool CSCOPE::insertCloudService( ig_active_reconstruction_msgs::PclInput::Request& req, ig_active_reconstruction_msgs::PclInput::Response& res)
   {
-    ROS_INFO("Received new pointcloud. Inserting...");
+    insertCloud(req.pointcloud);
+    
+    res.success = true;
+    return true;
+  }
+  
+  TEMPT
+  bool CSCOPE::insertShmCloudService( ig_active_reconstruction_msgs::PclShmInput::Request& req, ig_active_reconstruction_msgs::PclShmInput::Response& res)
+  {
+    ROS_INFO("Received new pointcloud through shared memory. Inserting...");
+    res.success = false;
+    
     POINTCLOUD_TYPE pc;
-    pcl::fromROSMsg(req.pointcloud, pc);
+    boost::function<void(const ros_tools::PointCloud2View&)> reader = boost::bind(&CSCOPE::cloudFromView, this, _1, boost::ref(pc));
     
-    insertCloud(pc);
+    // (re)open the ring if it wasn't yet or if the cloud can't be read, since the writer might have recreated it
+    for( unsigned int attempt=0; attempt<2; ++attempt )
+    {
+      // reading works on a copy of the pointer, thus a concurrent reopen can't destroy the ring while it's read
+      boost::shared_ptr<ros_tools::PointCloudShmRing> shm_ring;
+      {
+	boost::mutex::scoped_lock lock(shm_ring_mutex_);
+	if( shm_ring_==NULL || shm_ring_->segmentName()!=req.segment_name || attempt>0 )
+	{
+	  try
+	  {
+	    ros_tools::PointCloudShmRing::Config ring_config;
+	    ring_config.segment_name = req.segment_name;
+	    shm_ring_.reset();
+	    shm_ring_ = boost::make_shared<ros_tools::PointCloudShmRing>(ring_config,ros_tools::PointCloudShmRing::Role::READER);
+	  }
+	  catch( boost::interprocess::interprocess_exception& ex )
+	  {
+	    ROS_ERROR_STREAM("RosPclInput<TREE_TYPE,POINTCLOUD_TYPE>::Failed to open shared memory segment '"<<req.segment_name<<"': "<<ex.what());
+	    return true;
+	  }
+	}
+	shm_ring = shm_ring_;
+      }
+      
+      // only the conversion is done while the slot is locked
+      if( shm_ring->read(req.sequence,reader) )
+      {
+	res.success = insertCloud(pc);
+	ROS_INFO("Inserted new pointcloud");
+	return true;
+      }
+    }
     
-    ROS_INFO("Inserted new pointcloud");
-    res.success = true;
+    ROS_ERROR_STREAM("RosPclInput<TREE_TYPE,POINTCLOUD_TYPE>::Pointcloud "<<req.sequence<<" isn't available in shared memory segment '"<<req.segment_name<<"'.");
     return true;
   }
   
+  TEMPT
+  void CSCOPE::cloudFromView( const ros_tools::PointCloud2View& cloud, POINTCLOUD_TYPE& pointcloud )
+  {
+    const sensor_msgs::PointField* x = cloud.field("x");
+    const sensor_msgs::PointField* y = cloud.field("y");
+    const sensor_msgs::PointField* z = cloud.field("z");
+    
+    bool in_place = x!=NULL && y!=NULL && z!=NULL
+		    && x->datatype==sensor_msgs::PointField::FLOAT32 && y->datatype==sensor_msgs::PointField::FLOAT32 && z->datatype==sensor_msgs::PointField::FLOAT32
+		    && !cloud.is_bigendian
+		    && static_cast<size_t>(x->offset)+sizeof(float)<=cloud.point_step
+		    && static_cast<size_t>(y->offset)+sizeof(float)<=cloud.point_step
+		    && static_cast<size_t>(z->offset)+sizeof(float)<=cloud.point_step
+		    && static_cast<size_t>(cloud.width)*cloud.point_step<=cloud.row_step
+		    && static_cast<size_t>(cloud.row_step)*cloud.height<=cloud.data_size; // every point read stays within the data
+    
+    if( !in_place )
+    {
+      sensor_msgs::PointCloud2 msg;
+      msg.header = cloud.header;
+      msg.height = cloud.height;
+      msg.width = cloud.width;
+      msg.fields = cloud.fields;
+      msg.is_bigendian = cloud.is_bigendian;
+      msg.point_step = cloud.point_step;
+      msg.row_step = cloud.row_step;
+      msg.is_dense = cloud.is_dense;
+      if( cloud.data!=NULL )
+	msg.data.assign( cloud.data, cloud.data+cloud.data_size );
+      
+      pcl::fromROSMsg(msg, pointcloud);
+      return;
+    }
+    
+    pcl_conversions::toPCL(cloud.header, pointcloud.header);
+    pointcloud.width = cloud.width;
+    pointcloud.height = cloud.height;
+    pointcloud.is_dense = cloud.is_dense;
+    pointcloud.points.resize( cloud.size() );
+    
+    size_t i = 0;
+    for( uint32_t row=0; row<cloud.height; ++row )
+    {
+      for( uint32_t column=0; column<cloud.width; ++column, ++i )
+      {
+	const uint8_t* point = cloud.point(row,column);
+	std::memcpy( &pointcloud.points[i].x, point+x->offset, sizeof(float) );
+	std::memcpy( &pointcloud.points[i].y, point+y->offset, sizeof(float) );
+	std::memcpy( &pointcloud.points[i].z, point+z->offset, sizeof(float) );
+      }
+    }
+  }
+  
   TEMPT
   void CSCOPE::issueInputDoneSignals()
   {
@@ -83,7 +190,7 @@ namespace octomap
   }
   
   TEMPT
-  void CSCOPE::insertCloud( POINTCLOUD_TYPE& pointcloud )
+  bool CSCOPE::insertCloud( POINTCLOUD_TYPE& pointcloud )
   {
     tf::StampedTransform sensor_to_world_tf;
     try
@@ -93,7 +200,7 @@ namespace octomap
     catch(tf::TransformException& ex)
     {
       ROS_ERROR_STREAM( "RosPclInput<TREE_TYPE,POINTCLOUD_TYPE>::Transform error of sensor data: " << ex.what() << ", quitting callback.");
-      return;
+      return false;
     }
     
     Eigen::Matrix4f sensor_to_world;
@@ -107,6 +214,7 @@ namespace octomap
     
     
     issueInputDoneSignals();
+    return true;
   }
   
 }
@@ -0,0 +1,268 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+#include "ig_active_reconstruction_octomap/octomap_ros_world.hpp"
+
+#include <boost/make_shared.hpp>
+#include <boost/bind.hpp>
+
+#include "ig_active_reconstruction_octomap/octomap_ig_tree_world_representation.hpp"
+#include "ig_active_reconstruction_octomap/octomap_ray_occlusion_calculator.hpp"
+#include "ig_active_reconstruction_octomap/octomap_std_pcl_input_point_xyz.hpp"
+#include "ig_active_reconstruction_octomap/octomap_basic_ray_ig_calculator.hpp"
+#include "ig_active_reconstruction_octomap/ig/occlusion_aware.hpp"
+#include "ig_active_reconstruction_octomap/ig/unobserved_voxel.hpp"
+#include "ig_active_reconstruction_octomap/ig/rear_side_voxel.hpp"
+#include "ig_active_reconstruction_octomap/ig/rear_side_entropy.hpp"
+#include "ig_active_reconstruction_octomap/ig/proximity_count.hpp"
+#include "ig_active_reconstruction_octomap/ig/vasquez_gomez_area_factor.hpp"
+#include "ig_active_reconstruction_octomap/ig/average_entropy.hpp"
+#include "ig_active_reconstruction_octomap/map_metric/omni_calculator.hpp"
+#include "ig_active_reconstruction_octomap/octomap_ros_pcl_input.hpp"
+#include "ig_active_reconstruction_octomap/octomap_ros_interface.hpp"
+#include "ig_active_reconstruction_octomap/octomap_session_log.hpp"
+
+#include "ig_active_reconstruction_ros/param_loader.hpp"
+#include "ig_active_reconstruction_ros/world_representation_ros_server_ci.hpp"
+#include "ig_active_reconstruction_ros/world_representation_ros_ig_action_server.hpp"
+
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+
+namespace octomap
+{
+  
+  class IgTreeRosWorld::Impl
+  {
+  public:
+    typedef IgTreeWorldRepresentation WorldRepresentation;
+    typedef WorldRepresentation::TreeType TreeType;
+    typedef StdPclInputPointXYZ<TreeType>::PclType PclType;
+    
+  public:
+    Impl( ros::NodeHandle nh, ros::NodeHandle param_nh );
+    
+  public:
+    boost::shared_ptr<WorldRepresentation> world_representation;
+    RosInterface<TreeType>::Ptr world_ros_interface;
+    StdPclInputPointXYZ<TreeType>::Ptr std_input;
+    boost::shared_ptr< RosPclInput<TreeType,PclType> > ros_pcl_input;
+    BasicRayIgCalculator<TreeType>::Ptr ig_calculator;
+    boost::shared_ptr< RosServerCI<boost::shared_ptr> > ig_server;
+    boost::shared_ptr<RosIgActionServer> ig_action_server;
+    SessionRecorder::Ptr session_recorder;
+  };
+  
+  IgTreeRosWorld::Impl::Impl( ros::NodeHandle nh, ros::NodeHandle param_nh )
+  {
+    // Load parameters
+    // .............................................................................................
+    // Octree config
+    TreeType::Config octree_config;
+    ros_tools::getParamIfAvailable(octree_config.resolution_m,"resolution_m",param_nh);
+    ros_tools::getParamIfAvailable(octree_config.occupancy_threshold,"occupancy_threshold",param_nh);
+    ros_tools::getParamIfAvailable(octree_config.hit_probability,"hit_probability",param_nh);
+    ros_tools::getParamIfAvailable(octree_config.miss_probability,"miss_probability",param_nh);
+    ros_tools::getParamIfAvailable(octree_config.clamping_threshold_min,"clamping_threshold_min",param_nh);
+    ros_tools::getParamIfAvailable(octree_config.clamping_threshold_max,"clamping_threshold_max",param_nh);
+    
+    // Input config
+    StdPclInputPointXYZ<TreeType>::Type::Config input_config;
+    ros_tools::getParamIfAvailable(input_config.use_bounding_box,"use_bounding_box",param_nh);
+    ros_tools::getParamIfAvailable<float,double>(input_config.bounding_box_min_point_m.x(),"bounding_box_min_point_m/x",param_nh);
+    ros_tools::getParamIfAvailable<float,double>(input_config.bounding_box_min_point_m.y(),"bounding_box_min_point_m/y",param_nh);
+    ros_tools::getParamIfAvailable<float,double>(input_config.bounding_box_min_point_m.z(),"bounding_box_min_point_m/z",param_nh);
+    ros_tools::getParamIfAvailable<float,double>(input_config.bounding_box_max_point_m.x(),"bounding_box_max_point_m/x",param_nh);
+    ros_tools::getParamIfAvailable<float,double>(input_config.bounding_box_max_point_m.y(),"bounding_box_max_point_m/y",param_nh);
+    ros_tools::getParamIfAvailable<float,double>(input_config.bounding_box_max_point_m.z(),"bounding_box_max_point_m/z",param_nh);
+    ros_tools::getParamIfAvailable(input_config.max_sensor_range_m,"max_sensor_range_m",param_nh);
+    
+    std::string world_frame;
+    ros_tools::getExpParam(world_frame,"world_frame_name",param_nh);
+    
+    // Occlusion calculation config
+    RayOcclusionCalculator<TreeType,PclType>::Options occlusion_config(0.3);
+    ros_tools::getParamIfAvailable(occlusion_config.occlusion_update_dist_m,"occlusion_update_dist_m",param_nh);
+    
+    // Raycaster configuration - TODO cam intrinsics can be loaded from ROS topics
+    BasicRayIgCalculator<IgTreeWorldRepresentation::TreeType>::Config ig_calc_config;
+    
+    ros_tools::getParamIfAvailable<unsigned int,int>(ig_calc_config.ray_caster_config.img_width_px,"img_width_px",param_nh);
+    ros_tools::getParamIfAvailable<unsigned int,int>(ig_calc_config.ray_caster_config.img_height_px,"img_height_px",param_nh);
+    ros_tools::getParamIfAvailable(ig_calc_config.ray_caster_config.camera_matrix(0,0),"camera/fx",param_nh);
+    ros_tools::getParamIfAvailable(ig_calc_config.ray_caster_config.camera_matrix(1,1),"camera/fy",param_nh);
+    ros_tools::getParamIfAvailable(ig_calc_config.ray_caster_config.camera_matrix(0,2),"camera/cx",param_nh);
+    ros_tools::getParamIfAvailable(ig_calc_config.ray_caster_config.camera_matrix(1,2),"camera/cy",param_nh);
+    ros_tools::getParamIfAvailable(ig_calc_config.ray_caster_config.max_ray_depth_m,"max_ray_depth_m",param_nh);
+    
+    ros_tools::getParamIfAvailable(ig_calc_config.ray_caster_config.resolution.ray_resolution_x,"raycasting/resolution_x",param_nh);
+    ros_tools::getParamIfAvailable(ig_calc_config.ray_caster_config.resolution.ray_resolution_y,"raycasting/resolution_y",param_nh);
+    ros_tools::getParamIfAvailable(ig_calc_config.ray_caster_config.resolution.min_x_perc,"raycasting/min_x_perc",param_nh);
+    ros_tools::getParamIfAvailable(ig_calc_config.ray_caster_config.resolution.min_y_perc,"raycasting/min_y_perc",param_nh);
+    ros_tools::getParamIfAvailable(ig_calc_config.ray_caster_config.resolution.max_x_perc,"raycasting/max_x_perc",param_nh);
+    ros_tools::getParamIfAvailable(ig_calc_config.ray_caster_config.resolution.max_y_perc,"raycasting/max_y_perc",param_nh);
+    ros_tools::getParamIfAvailable<unsigned int,int>(ig_calc_config.number_of_threads,"ig_calculation/number_of_threads",param_nh);
+    
+    // Asynchronous information gain computation config
+    RosIgActionServer::Config ig_job_config;
+    ros_tools::getParamIfAvailable<unsigned int,int>(ig_job_config.views_per_step,"ig_job/views_per_step",param_nh);
+    ros_tools::getParamIfAvailable(ig_job_config.step_period_s,"ig_job/step_period_s",param_nh);
+    
+    // Information gain config
+    InformationGain<IgTreeWorldRepresentation::TreeType>::Config ig_config;
+    ros_tools::getParamIfAvailable(ig_config.p_unknown_prior,"ig/p_unknown_prior",param_nh);
+    ros_tools::getParamIfAvailable(ig_config.p_unknown_upper_bound,"ig/p_unknown_upper_bound",param_nh);
+    ros_tools::getParamIfAvailable(ig_config.p_unknown_lower_bound,"ig/p_unknown_lower_bound",param_nh);
+    ros_tools::getParamIfAvailable<unsigned int,int>(ig_config.voxels_in_void_ray,"ig/voxels_in_void_ray",param_nh);
+    
+    // Session recording config
+    std::string session_recording_file_path;
+    ros_tools::getParamIfAvailable(session_recording_file_path,"session_recording/file_path",param_nh);
+    
+    
+    
+    // Instantiate main world object
+    // .............................................................................................
+    world_representation = boost::make_shared<WorldRepresentation>(octree_config);
+    // Map metric counters classify voxels the same way the information gains do
+    world_representation->mapMetricCounters()->setConfig(ig_config);
+    // Create ROS interface
+    RosInterface<TreeType>::Config wri_config;
+    wri_config.nh = ros::NodeHandle(nh,"world");
+    wri_config.world_frame_name = world_frame;
+    ros_tools::getParamIfAvailable<unsigned int,int>(wri_config.traversal_config.partition_depth,"map_publishing/partition_depth",param_nh);
+    ros_tools::getParamIfAvailable<unsigned int,int>(wri_config.traversal_config.number_of_threads,"map_publishing/number_of_threads",param_nh);
+    bool incremental_map_publishing = true;
+    ros_tools::getParamIfAvailable(incremental_map_publishing,"map_publishing/incremental",param_nh);
+    ros_tools::getParamIfAvailable(wri_config.publishing_rate_hz,"map_publishing/rate_hz",param_nh);
+    ros_tools::getParamIfAvailable<unsigned int,int>(wri_config.lod_levels,"map_publishing/lod_levels",param_nh);
+    ros_tools::getParamIfAvailable<unsigned int,int>(wri_config.block_levels,"map_publishing/block_levels",param_nh);
+    world_ros_interface = world_representation->getLinkedObj<RosInterface>(wri_config);
+    
+    // Add input
+    // .............................................................................................
+    std_input = world_representation->getLinkedObj<StdPclInputPointXYZ>(input_config);
+    
+    // Calculate occlusion
+    std_input->setOcclusionCalculator<RayOcclusionCalculator>(occlusion_config);
+    
+    // Expose input to ROS
+    ros_pcl_input = boost::make_shared< RosPclInput<TreeType,PclType> >(ros::NodeHandle(nh,"world"), std_input, world_frame);
+    if( incremental_map_publishing )
+    {
+      // Publish changes of the map in the background, off the insertion path
+      world_ros_interface->startIncrementalPublishing();
+    }
+    else
+    {
+      // Publish the complete map after inserting inputs
+      boost::function<void()> publish_map = boost::bind(&RosInterface<TreeType>::publishVoxelMap,world_ros_interface);
+      ros_pcl_input->addInputDoneSignalCall(publish_map);
+    }
+    
+    // Add information gain calculator
+    // .............................................................................................
+    ig_calculator = world_representation->getLinkedObj<BasicRayIgCalculator>(ig_calc_config);
+    
+    // set information gains that shall be used
+    ig_calculator->registerInformationGain<OcclusionAwareIg>(ig_config);
+    ig_calculator->registerInformationGain<UnobservedVoxelIg>(ig_config);
+    ig_calculator->registerInformationGain<RearSideVoxelIg>(ig_config);
+    ig_calculator->registerInformationGain<RearSideEntropyIg>(ig_config);
+    ig_calculator->registerInformationGain<ProximityCountIg>(ig_config);
+    ig_calculator->registerInformationGain<VasquezGomezAreaFactorIg>(ig_config);
+    ig_calculator->registerInformationGain<AverageEntropyIg>(ig_config);
+    
+    // set map metrics that shall be available, all read from the incrementally maintained counters
+    for( unsigned int metric=0; metric<OmniCalculator<TreeType>::NUMBER_OF_METRICS; ++metric )
+    {
+      OmniCalculator<TreeType>::Config mm_config;
+      mm_config.metric = static_cast<OmniCalculator<TreeType>::Metric>(metric);
+      ig_calculator->registerMapMetric<OmniCalculator>(mm_config);
+    }
+    
+    // Expose the information gain calculator to ROS
+    ig_server = boost::make_shared< RosServerCI<boost::shared_ptr> >(nh,ig_calculator);
+    ig_action_server = boost::make_shared<RosIgActionServer>(nh,ig_calculator,ig_job_config);
+    
+    // Record the session's inputs for replays
+    // .............................................................................................
+    if( !session_recording_file_path.empty() )
+    {
+      session_recorder = boost::make_shared<SessionRecorder>();
+      if( session_recorder->open(session_recording_file_path) )
+      {
+	SessionSetup setup;
+	setup.octree = octree_config;
+	setup.camera = ig_calc_config.ray_caster_config;
+	setup.ig = ig_config;
+	setup.use_bounding_box = input_config.use_bounding_box;
+	setup.bounding_box_min_point_m = Eigen::Vector3d( input_config.bounding_box_min_point_m.x(), input_config.bounding_box_min_point_m.y(), input_config.bounding_box_min_point_m.z() );
+	setup.bounding_box_max_point_m = Eigen::Vector3d( input_config.bounding_box_max_point_m.x(), input_config.bounding_box_max_point_m.y(), input_config.bounding_box_max_point_m.z() );
+	setup.max_sensor_range_m = input_config.max_sensor_range_m;
+	setup.occlusion_update_dist_m = occlusion_config.occlusion_update_dist_m;
+	session_recorder->recordSetup(setup);
+	
+	std_input->setRecorder(session_recorder);
+	ig_calculator->setRecorder(session_recorder);
+	ROS_INFO_STREAM("Recording the session to '"<<session_recording_file_path<<"'.");
+      }
+      else
+      {
+	ROS_ERROR_STREAM("Failed to open the session log '"<<session_recording_file_path<<"', the session is not recorded.");
+	session_recorder.reset();
+      }
+    }
+  }
+  
+  IgTreeRosWorld::IgTreeRosWorld( ros::NodeHandle nh, ros::NodeHandle param_nh )
+  : impl_( new Impl(nh,param_nh) )
+  {
+    
+  }
+  
+  boost::shared_ptr<CommunicationInterface> IgTreeRosWorld::igCalculator()
+  {
+    return impl_->ig_calculator;
+  }
+  
+  void IgTreeRosWorld::recordViewSpace( views::ViewSpace& viewspace )
+  {
+    if( impl_->session_recorder )
+      impl_->session_recorder->recordViewSpace(viewspace);
+  }
+  
+  //! Hands a pointcloud over to the ROS pointcloud input of the world.
+  static bool insertPointcloud( boost::shared_ptr< RosPclInput<IgTreeWorldRepresentation::TreeType,StdPclInputPointXYZ<IgTreeWorldRepresentation::TreeType>::PclType> > ros_pcl_input, const sensor_msgs::PointCloud2ConstPtr& cloud )
+  {
+    return ros_pcl_input->insertCloud(*cloud);
+  }
+  
+  boost::function<bool(const sensor_msgs::PointCloud2ConstPtr&)> IgTreeRosWorld::pointcloudSink()
+  {
+    return boost::bind(&insertPointcloud,impl_->ros_pcl_input,_1);
+  }
+  
+}
+
+}
+
+}
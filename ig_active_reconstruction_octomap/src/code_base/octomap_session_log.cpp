@@ -0,0 +1,423 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+#include "ig_active_reconstruction_octomap/octomap_session_log.hpp"
+
+#include <limits>
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+
+namespace octomap
+{
+  
+namespace session_log
+{
+  static const char MAGIC[8] = {'I','A','R','S','L','O','G','\0'}; //! Identifies session logs.
+  static const uint32_t VERSION = 1; //! Log format version.
+  
+  /*! Appends a string, prefixed by its length.
+   */
+  static void appendString( std::vector<char>& payload, const std::string& value )
+  {
+    append( payload, static_cast<uint32_t>(value.size()) );
+    payload.insert( payload.end(), value.begin(), value.end() );
+  }
+  
+  /*! Reads a string written by appendString.
+   */
+  static bool readString( PayloadReader& reader, std::string& value )
+  {
+    uint32_t length;
+    if( !reader.read(length) || reader.bytesLeft()<length )
+      return false;
+    
+    value.resize(length);
+    for( uint32_t i=0; i<length; ++i )
+      reader.read(value[i]);
+    return true;
+  }
+  
+  /*! Appends a pose as position and quaternion (x,y,z,w).
+   */
+  static void appendPose( std::vector<char>& payload, const movements::Pose& pose )
+  {
+    append( payload, pose.position.x() );
+    append( payload, pose.position.y() );
+    append( payload, pose.position.z() );
+    append( payload, pose.orientation.x() );
+    append( payload, pose.orientation.y() );
+    append( payload, pose.orientation.z() );
+    append( payload, pose.orientation.w() );
+  }
+  
+  /*! Reads a pose written by appendPose.
+   */
+  static bool readPose( PayloadReader& reader, movements::Pose& pose )
+  {
+    double x, y, z, qx, qy, qz, qw;
+    if( !reader.read(x) || !reader.read(y) || !reader.read(z) || !reader.read(qx) || !reader.read(qy) || !reader.read(qz) || !reader.read(qw) )
+      return false;
+    
+    pose.position = Eigen::Vector3d(x,y,z);
+    pose.orientation = Eigen::Quaterniond(qw,qx,qy,qz);
+    return true;
+  }
+  
+  /*! Appends a vector of three doubles.
+   */
+  static void appendVector( std::vector<char>& payload, const Eigen::Vector3d& vector )
+  {
+    append( payload, vector(0) );
+    append( payload, vector(1) );
+    append( payload, vector(2) );
+  }
+  
+  /*! Reads a vector written by appendVector.
+   */
+  static bool readVector( PayloadReader& reader, Eigen::Vector3d& vector )
+  {
+    return reader.read(vector(0)) && reader.read(vector(1)) && reader.read(vector(2));
+  }
+}
+  
+  SessionSetup::SessionSetup()
+  : octree()
+  , camera()
+  , ig()
+  , use_bounding_box(false)
+  , bounding_box_min_point_m( -std::numeric_limits<double>::max(), -std::numeric_limits<double>::max(), -std::numeric_limits<double>::max() )
+  , bounding_box_max_point_m( std::numeric_limits<double>::max(), std::numeric_limits<double>::max(), std::numeric_limits<double>::max() )
+  , max_sensor_range_m(-1)
+  , occlusion_update_dist_m(-1)
+  {
+    
+  }
+  
+  SessionRecorder::SessionRecorder()
+  {
+    
+  }
+  
+  bool SessionRecorder::open( std::string path )
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    
+    if( file_.is_open() )
+      file_.close();
+    
+    file_.open( path.c_str(), std::ofstream::binary | std::ofstream::trunc );
+    if( !file_.is_open() )
+      return false;
+    
+    file_.write( session_log::MAGIC, sizeof(session_log::MAGIC) );
+    file_.write( reinterpret_cast<const char*>(&session_log::VERSION), sizeof(session_log::VERSION) );
+    return file_.good();
+  }
+  
+  void SessionRecorder::close()
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    if( file_.is_open() )
+      file_.close();
+  }
+  
+  bool SessionRecorder::isOpen()
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    return file_.is_open();
+  }
+  
+  void SessionRecorder::recordSetup( const SessionSetup& setup )
+  {
+    if( !isOpen() )
+      return;
+    
+    std::vector<char> payload;
+    session_log::append( payload, setup.octree.resolution_m );
+    session_log::append( payload, setup.octree.occupancy_threshold );
+    session_log::append( payload, setup.octree.hit_probability );
+    session_log::append( payload, setup.octree.miss_probability );
+    session_log::append( payload, setup.octree.clamping_threshold_min );
+    session_log::append( payload, setup.octree.clamping_threshold_max );
+    
+    session_log::append( payload, setup.camera.resolution.ray_resolution_x );
+    session_log::append( payload, setup.camera.resolution.ray_resolution_y );
+    session_log::append( payload, setup.camera.resolution.min_x_perc );
+    session_log::append( payload, setup.camera.resolution.min_y_perc );
+    session_log::append( payload, setup.camera.resolution.max_x_perc );
+    session_log::append( payload, setup.camera.resolution.max_y_perc );
+    session_log::append( payload, setup.camera.max_ray_depth_m );
+    session_log::append( payload, static_cast<uint32_t>(setup.camera.img_width_px) );
+    session_log::append( payload, static_cast<uint32_t>(setup.camera.img_height_px) );
+    for( unsigned int i=0; i<9; ++i )
+      session_log::append( payload, setup.camera.camera_matrix.data()[i] );
+    
+    session_log::append( payload, setup.ig.p_unknown_prior );
+    session_log::append( payload, setup.ig.p_unknown_upper_bound );
+    session_log::append( payload, setup.ig.p_unknown_lower_bound );
+    session_log::append( payload, static_cast<uint32_t>(setup.ig.voxels_in_void_ray) );
+    
+    session_log::append( payload, static_cast<uint8_t>(setup.use_bounding_box) );
+    session_log::appendVector( payload, setup.bounding_box_min_point_m );
+    session_log::appendVector( payload, setup.bounding_box_max_point_m );
+    session_log::append( payload, setup.max_sensor_range_m );
+    session_log::append( payload, setup.occlusion_update_dist_m );
+    
+    write(SessionRecordType::SETUP,payload);
+  }
+  
+  void SessionRecorder::recordIgCommand( const CommunicationInterface::IgRetrievalCommand& command )
+  {
+    if( !isOpen() )
+      return;
+    
+    std::vector<char> payload;
+    session_log::append( payload, static_cast<uint32_t>(command.path.size()) );
+    for( size_t i=0; i<command.path.size(); ++i )
+      session_log::appendPose( payload, command.path[i] );
+    
+    session_log::append( payload, static_cast<uint32_t>(command.metric_names.size()) );
+    for( size_t i=0; i<command.metric_names.size(); ++i )
+      session_log::appendString( payload, command.metric_names[i] );
+    
+    session_log::append( payload, static_cast<uint32_t>(command.metric_ids.size()) );
+    for( size_t i=0; i<command.metric_ids.size(); ++i )
+      session_log::append( payload, static_cast<uint32_t>(command.metric_ids[i]) );
+    
+    session_log::append( payload, command.config.ray_resolution_x );
+    session_log::append( payload, command.config.ray_resolution_y );
+    session_log::append( payload, command.config.ray_window.min_x_perc );
+    session_log::append( payload, command.config.ray_window.max_x_perc );
+    session_log::append( payload, command.config.ray_window.min_y_perc );
+    session_log::append( payload, command.config.ray_window.max_y_perc );
+    session_log::append( payload, command.config.max_ray_depth );
+    
+    write(SessionRecordType::IG_COMMAND,payload);
+  }
+  
+  void SessionRecorder::recordViewSpace( views::ViewSpace& viewspace )
+  {
+    if( !isOpen() )
+      return;
+    
+    std::vector<char> payload;
+    session_log::append( payload, static_cast<uint32_t>(viewspace.size()) );
+    for( views::ViewSpace::Iterator it=viewspace.begin(); it!=viewspace.end(); ++it )
+      session_log::appendPose( payload, it->pose() );
+    
+    write(SessionRecordType::VIEWSPACE,payload);
+  }
+  
+  void SessionRecorder::write( SessionRecordType::Enum type, const std::vector<char>& payload )
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    if( !file_.is_open() )
+      return;
+    
+    uint8_t record_type = static_cast<uint8_t>(type);
+    uint64_t payload_size = payload.size();
+    file_.write( reinterpret_cast<const char*>(&record_type), sizeof(record_type) );
+    file_.write( reinterpret_cast<const char*>(&payload_size), sizeof(payload_size) );
+    if( !payload.empty() )
+      file_.write( &payload[0], payload.size() );
+    file_.flush(); // a log of an aborted session is still usable
+  }
+  
+  
+  SessionLogReader::SessionLogReader()
+  : file_size_(0)
+  , type_(SessionRecordType::NONE)
+  {
+    
+  }
+  
+  bool SessionLogReader::open( std::string path )
+  {
+    if( file_.is_open() )
+      file_.close();
+    type_ = SessionRecordType::NONE;
+    
+    file_.open( path.c_str(), std::ifstream::binary );
+    if( !file_.is_open() )
+      return false;
+    
+    file_.seekg( 0, std::ifstream::end );
+    file_size_ = file_.tellg();
+    file_.seekg( 0, std::ifstream::beg );
+    
+    char magic[sizeof(session_log::MAGIC)];
+    uint32_t version;
+    file_.read( magic, sizeof(magic) );
+    file_.read( reinterpret_cast<char*>(&version), sizeof(version) );
+    
+    return file_.good() && std::memcmp(magic,session_log::MAGIC,sizeof(magic))==0 && version==session_log::VERSION;
+  }
+  
+  SessionRecordType::Enum SessionLogReader::next()
+  {
+    type_ = SessionRecordType::NONE;
+    payload_.clear();
+    
+    uint8_t record_type;
+    uint64_t payload_size;
+    file_.read( reinterpret_cast<char*>(&record_type), sizeof(record_type) );
+    file_.read( reinterpret_cast<char*>(&payload_size), sizeof(payload_size) );
+    if( !file_.good() )
+      return SessionRecordType::NONE;
+    
+    if( payload_size>static_cast<uint64_t>( file_size_-static_cast<std::streamoff>(file_.tellg()) ) ) // corrupt size or incomplete record, nothing follows
+    {
+      file_.seekg( 0, std::ifstream::end );
+      type_ = static_cast<SessionRecordType::Enum>(record_type);
+      return type_;
+    }
+    
+    payload_.resize(payload_size);
+    if( payload_size>0 )
+      file_.read( &payload_[0], payload_size );
+    if( !file_.good() ) // incomplete record of an aborted session
+      return SessionRecordType::NONE;
+    
+    type_ = static_cast<SessionRecordType::Enum>(record_type);
+    return type_;
+  }
+  
+  bool SessionLogReader::get( SessionSetup& setup ) const
+  {
+    if( type_!=SessionRecordType::SETUP )
+      return false;
+    
+    session_log::PayloadReader reader(payload_);
+    bool success = reader.read(setup.octree.resolution_m)
+		&& reader.read(setup.octree.occupancy_threshold)
+		&& reader.read(setup.octree.hit_probability)
+		&& reader.read(setup.octree.miss_probability)
+		&& reader.read(setup.octree.clamping_threshold_min)
+		&& reader.read(setup.octree.clamping_threshold_max);
+    
+    uint32_t width, height;
+    success = success
+	      && reader.read(setup.camera.resolution.ray_resolution_x)
+	      && reader.read(setup.camera.resolution.ray_resolution_y)
+	      && reader.read(setup.camera.resolution.min_x_perc)
+	      && reader.read(setup.camera.resolution.min_y_perc)
+	      && reader.read(setup.camera.resolution.max_x_perc)
+	      && reader.read(setup.camera.resolution.max_y_perc)
+	      && reader.read(setup.camera.max_ray_depth_m)
+	      && reader.read(width)
+	      && reader.read(height);
+    setup.camera.img_width_px = width;
+    setup.camera.img_height_px = height;
+    for( unsigned int i=0; i<9 && success; ++i )
+      success = reader.read(setup.camera.camera_matrix.data()[i]);
+    
+    uint32_t voxels_in_void_ray;
+    success = success
+	      && reader.read(setup.ig.p_unknown_prior)
+	      && reader.read(setup.ig.p_unknown_upper_bound)
+	      && reader.read(setup.ig.p_unknown_lower_bound)
+	      && reader.read(voxels_in_void_ray);
+    setup.ig.voxels_in_void_ray = voxels_in_void_ray;
+    
+    uint8_t use_bounding_box;
+    success = success
+	      && reader.read(use_bounding_box)
+	      && session_log::readVector(reader,setup.bounding_box_min_point_m)
+	      && session_log::readVector(reader,setup.bounding_box_max_point_m)
+	      && reader.read(setup.max_sensor_range_m)
+	      && reader.read(setup.occlusion_update_dist_m);
+    setup.use_bounding_box = use_bounding_box!=0;
+    
+    return success;
+  }
+  
+  bool SessionLogReader::get( CommunicationInterface::IgRetrievalCommand& command ) const
+  {
+    if( type_!=SessionRecordType::IG_COMMAND )
+      return false;
+    
+    session_log::PayloadReader reader(payload_);
+    uint32_t count;
+    
+    if( !reader.read(count) || count>reader.bytesLeft()/(7*sizeof(double)) )
+      return false;
+    command.path.resize(count);
+    for( uint32_t i=0; i<count; ++i )
+    {
+      if( !session_log::readPose(reader,command.path[i]) )
+	return false;
+    }
+    
+    if( !reader.read(count) || count>reader.bytesLeft()/sizeof(uint32_t) ) // each name is at least its length
+      return false;
+    command.metric_names.resize(count);
+    for( uint32_t i=0; i<count; ++i )
+    {
+      if( !session_log::readString(reader,command.metric_names[i]) )
+	return false;
+    }
+    
+    if( !reader.read(count) || count>reader.bytesLeft()/sizeof(uint32_t) )
+      return false;
+    command.metric_ids.resize(count);
+    for( uint32_t i=0; i<count; ++i )
+    {
+      uint32_t id;
+      if( !reader.read(id) )
+	return false;
+      command.metric_ids[i] = id;
+    }
+    
+    return reader.read(command.config.ray_resolution_x)
+	&& reader.read(command.config.ray_resolution_y)
+	&& reader.read(command.config.ray_window.min_x_perc)
+	&& reader.read(command.config.ray_window.max_x_perc)
+	&& reader.read(command.config.ray_window.min_y_perc)
+	&& reader.read(command.config.ray_window.max_y_perc)
+	&& reader.read(command.config.max_ray_depth);
+  }
+  
+  bool SessionLogReader::get( views::ViewSpace& viewspace ) const
+  {
+    if( type_!=SessionRecordType::VIEWSPACE )
+      return false;
+    
+    session_log::PayloadReader reader(payload_);
+    uint32_t count;
+    if( !reader.read(count) )
+      return false;
+    
+    for( uint32_t i=0; i<count; ++i )
+    {
+      views::View view;
+      if( !session_log::readPose(reader,view.pose()) )
+	return false;
+      viewspace.push_back(view);
+    }
+    return true;
+  }
+  
+}
+
+}
+
+}
@@ -0,0 +1,149 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include <cstring>
+#include <stdint.h>
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+
+namespace octomap
+{
+  
+namespace session_log
+{
+  /*! Appends the bytes of a value to a payload.
+   */
+  template<class T>
+  void append( std::vector<char>& payload, const T& value )
+  {
+    const char* bytes = reinterpret_cast<const char*>(&value);
+    payload.insert( payload.end(), bytes, bytes+sizeof(T) );
+  }
+  
+  /*! Appends a transform to a payload, as 16 doubles in column-major order.
+   */
+  inline void appendTransform( std::vector<char>& payload, const Eigen::Transform<double,3,Eigen::Affine>& transform )
+  {
+    const double* data = transform.matrix().data();
+    for( unsigned int i=0; i<16; ++i )
+      append(payload,data[i]);
+  }
+  
+  /*! Reads values from a payload, sequentially.
+   */
+  class PayloadReader
+  {
+  public:
+    PayloadReader( const std::vector<char>& payload )
+    : payload_(payload)
+    , position_(0)
+    {}
+    
+    /*! Reads the next value, returns false if the payload is too short.
+     */
+    template<class T>
+    bool read( T& value )
+    {
+      if( position_+sizeof(T) > payload_.size() )
+	return false;
+      std::memcpy( &value, &payload_[position_], sizeof(T) );
+      position_ += sizeof(T);
+      return true;
+    }
+    
+    /*! Reads a transform written by appendTransform, returns false if the payload is too short.
+     */
+    bool readTransform( Eigen::Transform<double,3,Eigen::Affine>& transform )
+    {
+      double* data = transform.matrix().data();
+      for( unsigned int i=0; i<16; ++i )
+      {
+	if( !read(data[i]) )
+	  return false;
+      }
+      return true;
+    }
+    
+    /*! Returns the number of bytes that weren't read yet.
+     */
+    size_t bytesLeft() const
+    {
+      return payload_.size()-position_;
+    }
+    
+  private:
+    const std::vector<char>& payload_;
+    size_t position_;
+  };
+}
+  
+  template<class POINTCLOUD_TYPE>
+  void SessionRecorder::recordPointcloud( const Eigen::Transform<double,3,Eigen::Affine>& sensor_to_world, const POINTCLOUD_TYPE& pc )
+  {
+    if( !isOpen() )
+      return;
+    
+    std::vector<char> payload;
+    payload.reserve( 16*sizeof(double) + sizeof(uint32_t) + 3*sizeof(float)*pc.points.size() );
+    
+    session_log::appendTransform(payload,sensor_to_world);
+    session_log::append( payload, static_cast<uint32_t>(pc.points.size()) );
+    for( size_t i=0; i<pc.points.size(); ++i )
+    {
+      session_log::append( payload, static_cast<float>(pc.points[i].x) );
+      session_log::append( payload, static_cast<float>(pc.points[i].y) );
+      session_log::append( payload, static_cast<float>(pc.points[i].z) );
+    }
+    
+    write(SessionRecordType::POINTCLOUD,payload);
+  }
+  
+  template<class POINTCLOUD_TYPE>
+  bool SessionLogReader::getPointcloud( Eigen::Transform<double,3,Eigen::Affine>& sensor_to_world, POINTCLOUD_TYPE& pc ) const
+  {
+    if( type_!=SessionRecordType::POINTCLOUD )
+      return false;
+    
+    session_log::PayloadReader reader(payload_);
+    uint32_t number_of_points;
+    if( !reader.readTransform(sensor_to_world) || !reader.read(number_of_points) || reader.bytesLeft()<3*sizeof(float)*number_of_points )
+      return false;
+    
+    pc.clear();
+    pc.reserve(number_of_points);
+    typename POINTCLOUD_TYPE::PointType point;
+    for( uint32_t i=0; i<number_of_points; ++i )
+    {
+      reader.read(point.x);
+      reader.read(point.y);
+      reader.read(point.z);
+      pc.push_back(point);
+    }
+    return true;
+  }
+  
+}
+
+}
+
+}
@@ -0,0 +1,112 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#define TEMPT template<class TREE_TYPE, class POINTCLOUD_TYPE>
+#define CSCOPE SimulatedRobot<TREE_TYPE, POINTCLOUD_TYPE>
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+
+namespace octomap
+{
+  TEMPT
+  CSCOPE::SimulatedRobot( typename Sensor::Ptr sensor, boost::shared_ptr<Input> input, View initial_view )
+  : sensor_(sensor)
+  , input_(input)
+  , current_view_(initial_view)
+  , number_of_measurements_(0)
+  , travelled_distance_m_(0)
+  {
+    current_view_.nonViewSpace() = true;
+  }
+  
+  TEMPT
+  typename CSCOPE::View CSCOPE::getCurrentView()
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    return current_view_;
+  }
+  
+  TEMPT
+  typename CSCOPE::ReceptionInfo CSCOPE::retrieveData()
+  {
+    movements::Pose sensor_pose;
+    {
+      boost::mutex::scoped_lock lock(mutex_);
+      sensor_pose = current_view_.pose();
+      ++number_of_measurements_;
+    }
+    
+    POINTCLOUD_TYPE pc;
+    sensor_->capture(sensor_pose,pc);
+    input_->push( Sensor::sensorToWorld(sensor_pose), pc );
+    
+    return ReceptionInfo::SUCCEEDED;
+  }
+  
+  TEMPT
+  typename CSCOPE::MovementCost CSCOPE::movementCost( View& target_view )
+  {
+    View current_view = getCurrentView();
+    return movementCost(current_view,target_view,false);
+  }
+  
+  TEMPT
+  typename CSCOPE::MovementCost CSCOPE::movementCost( View& start_view, View& target_view, bool fill_additional_information )
+  {
+    MovementCost cost;
+    cost.cost = (start_view.pose().position - target_view.pose().position).norm();
+    return cost;
+  }
+  
+  TEMPT
+  bool CSCOPE::moveTo( View& target_view )
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    travelled_distance_m_ += (current_view_.pose().position - target_view.pose().position).norm();
+    current_view_ = target_view;
+    current_view_.nonViewSpace() = true;
+    return true;
+  }
+  
+  TEMPT
+  unsigned int CSCOPE::numberOfMeasurements()
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    return number_of_measurements_;
+  }
+  
+  TEMPT
+  double CSCOPE::travelledDistance()
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    return travelled_distance_m_;
+  }
+  
+}
+
+}
+
+}
+
+#undef CSCOPE
+#undef TEMPT
@@ -0,0 +1,162 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#define TEMPT template<class TREE_TYPE, class POINTCLOUD_TYPE>
+#define CSCOPE SimulatedSensor<TREE_TYPE, POINTCLOUD_TYPE>
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+
+namespace octomap
+{
+  TEMPT
+  CSCOPE::Config::Config()
+  : camera()
+  {
+    camera.img_width_px = 640;
+    camera.img_height_px = 480;
+    camera.camera_matrix << 525, 0, 319.5,
+			    0, 525, 239.5,
+			    0, 0, 1;
+    camera.max_ray_depth_m = 10.0;
+  }
+  
+  TEMPT
+  CSCOPE::SimulatedSensor( boost::shared_ptr<TREE_TYPE> ground_truth, Config config )
+  : ground_truth_(ground_truth)
+  , ray_caster_(config.camera)
+  , max_ray_depth_m_(config.camera.max_ray_depth_m)
+  {
+    
+  }
+  
+  TEMPT
+  boost::shared_ptr<TREE_TYPE> CSCOPE::groundTruth()
+  {
+    return ground_truth_;
+  }
+  
+  TEMPT
+  void CSCOPE::capture( movements::Pose sensor_pose, POINTCLOUD_TYPE& pc )
+  {
+    using ::octomap::point3d;
+    
+    pc.clear();
+    
+    Eigen::Transform<double,3,Eigen::Affine> world_to_sensor = sensorToWorld(sensor_pose).inverse();
+    boost::shared_ptr<RayCaster::RaySet> ray_set = ray_caster_.getRaySet(sensor_pose);
+    pc.reserve( ray_set->size() );
+    
+    for( size_t i=0; i<ray_set->size(); ++i )
+    {
+      RayCaster::Ray& ray = (*ray_set)[i];
+      point3d origin( ray.origin(0), ray.origin(1), ray.origin(2) );
+      point3d direction( ray.direction(0), ray.direction(1), ray.direction(2) );
+      point3d end_point;
+      
+      // only rays that hit an occupied voxel yield a measurement, like a real depth sensor
+      if( !ground_truth_->castRay( origin, direction, end_point, true, max_ray_depth_m_ ) )
+	continue;
+      
+      Eigen::Vector3d point_in_sensor = world_to_sensor*Eigen::Vector3d( end_point.x(), end_point.y(), end_point.z() );
+      typename POINTCLOUD_TYPE::PointType point;
+      point.x = point_in_sensor(0);
+      point.y = point_in_sensor(1);
+      point.z = point_in_sensor(2);
+      pc.push_back(point);
+    }
+    pc.is_dense = true;
+  }
+  
+  TEMPT
+  Eigen::Transform<double,3,Eigen::Affine> CSCOPE::sensorToWorld( const movements::Pose& sensor_pose )
+  {
+    Eigen::Transform<double,3,Eigen::Affine> sensor_to_world = Eigen::Translation3d(sensor_pose.position)*sensor_pose.orientation;
+    return sensor_to_world;
+  }
+  
+  TEMPT
+  bool CSCOPE::loadGroundTruth( std::string path, TREE_TYPE& tree )
+  {
+    return tree.readBinary(path);
+  }
+  
+  TEMPT
+  void CSCOPE::addBox( TREE_TYPE& tree, Eigen::Vector3d min_m, Eigen::Vector3d max_m )
+  {
+    ::octomap::OcTreeKey min_key, max_key;
+    if( !tree.coordToKeyChecked( ::octomap::point3d(min_m(0),min_m(1),min_m(2)), min_key ) || !tree.coordToKeyChecked( ::octomap::point3d(max_m(0),max_m(1),max_m(2)), max_key ) )
+      return;
+    
+    ::octomap::OcTreeKey key;
+    for( unsigned int x=min_key[0]; x<=max_key[0]; ++x )
+    {
+      key[0] = x;
+      for( unsigned int y=min_key[1]; y<=max_key[1]; ++y )
+      {
+	key[1] = y;
+	for( unsigned int z=min_key[2]; z<=max_key[2]; ++z )
+	{
+	  key[2] = z;
+	  tree.updateNode( key, tree.getClampingThresMaxLog() );
+	}
+      }
+    }
+  }
+  
+  TEMPT
+  void CSCOPE::addSphere( TREE_TYPE& tree, Eigen::Vector3d center_m, double radius_m )
+  {
+    Eigen::Vector3d extent(radius_m,radius_m,radius_m);
+    Eigen::Vector3d min_m = center_m - extent;
+    Eigen::Vector3d max_m = center_m + extent;
+    
+    ::octomap::OcTreeKey min_key, max_key;
+    if( !tree.coordToKeyChecked( ::octomap::point3d(min_m(0),min_m(1),min_m(2)), min_key ) || !tree.coordToKeyChecked( ::octomap::point3d(max_m(0),max_m(1),max_m(2)), max_key ) )
+      return;
+    
+    ::octomap::OcTreeKey key;
+    for( unsigned int x=min_key[0]; x<=max_key[0]; ++x )
+    {
+      key[0] = x;
+      for( unsigned int y=min_key[1]; y<=max_key[1]; ++y )
+      {
+	key[1] = y;
+	for( unsigned int z=min_key[2]; z<=max_key[2]; ++z )
+	{
+	  key[2] = z;
+	  ::octomap::point3d center = tree.keyToCoord(key);
+	  if( (Eigen::Vector3d(center.x(),center.y(),center.z())-center_m).norm()<=radius_m )
+	    tree.updateNode( key, tree.getClampingThresMaxLog() );
+	}
+      }
+    }
+  }
+  
+}
+
+}
+
+}
+
+#undef CSCOPE
+#undef TEMPT
@@ -42,6 +42,22 @@ namespace octomap
     
   }
   
+  TEMPT
+  CSCOPE::InsertionStatistics::InsertionStatistics()
+  : number_of_points(0)
+  , number_of_valid_points(0)
+  , number_of_free_voxels(0)
+  , number_of_occupied_voxels(0)
+  , node_count_delta(0)
+  , filter_s(0)
+  , key_computation_s(0)
+  , free_update_s(0)
+  , occupied_update_s(0)
+  , occlusion_s(0)
+  {
+    
+  }
+  
   TEMPT
   CSCOPE::StdPclInput( Config config )
   : config_(config)
@@ -52,6 +68,14 @@ namespace octomap
   TEMPT
   void CSCOPE::push( const Eigen::Transform<double,3,Eigen::Affine>& sensor_to_world, POINTCLOUD_TYPE& pc )
   {
+    if( recorder_ )
+      recorder_->recordPointcloud(sensor_to_world,pc);
+    
+    InsertionStatistics statistics;
+    statistics.number_of_points = pc.points.size();
+    size_t initial_tree_size = this->link_.octree->size();
+    boost::posix_time::ptime phase_start = boost::posix_time::microsec_clock::universal_time();
+    
     pcl::transformPointCloud(pc, pc, sensor_to_world);
     
     typename POINTCLOUD_TYPE::Ptr pc_cpy = pc.makeShared();
@@ -83,6 +107,10 @@ namespace octomap
     
     pcl::removeNaNFromPointCloud(*pc_cpy,valid_indices);
     
+    statistics.number_of_valid_points = valid_indices.size();
+    statistics.filter_s = secondsSince(phase_start);
+    phase_start = boost::posix_time::microsec_clock::universal_time();
+    
     std::cout<<"Inserting "<<pc_cpy->points.size()<<" valid points.";
     
     
@@ -110,9 +138,6 @@ namespace octomap
       // maxrange check
       point3d curr_ray = point - sensor_origin;
       
-      if(i%100==0)
-	std::cout<<"\nBuilding iterator set: "<<i<<"/"<<valid_indices.size();
-      
       if ((config_.max_sensor_range_m< 0.0) || (curr_ray.norm() <= (config_.max_sensor_range_m+0.000001)) )
       {
 	// free cells
@@ -138,18 +163,25 @@ namespace octomap
       }
     }
     
-    // update occupancy likelihoods
+    statistics.number_of_free_voxels = free_cells.size();
+    statistics.number_of_occupied_voxels = occupied_cells.size();
+    statistics.key_computation_s = secondsSince(phase_start);
+    phase_start = boost::posix_time::microsec_clock::universal_time();
+    
+    // update occupancy likelihoods, keeping the map metric counters and the change log up to date
+    MapMetricCounters<TREE_TYPE>* counters = this->link_.counters.get();
+    typename MapMetricCounters<TREE_TYPE>::VoxelState state_before;
+    bool log_changes = this->link_.changes!=NULL && this->link_.changes->isEnabled();
+    ::octomap::KeyBoolMap changed_voxels;
     
     // mark free cells only if not seen occupied in this cloud - attention: voxels may already exist even though no actual measurement has yet been received at their position (e.g. if their occlusion distance was calculated) - need to check hasMeasurement()!
-    size_t count = 0;
     for(KeySet::iterator it = free_cells.begin(), end=free_cells.end(); it!= end; ++it)
     {
-      if( count++%1000==0)
-	std::cout<<"\nInserting free: "<<count<<"/"<<free_cells.size();
-      
       if( occupied_cells.find(*it) == occupied_cells.end() )
       {
 	typename TREE_TYPE::NodeType* voxel = this->link_.octree->search(*it);
+	if( counters!=NULL )
+	  state_before = counters->stateOf(voxel);
 	
 	if( voxel==NULL )
 	{
@@ -169,17 +201,23 @@ namespace octomap
 	    this->link_.octree->updateNode(*it, false);
 	  }
 	}
+	
+	if( counters!=NULL )
+	  counters->update( state_before, counters->stateOf( this->link_.octree->search(*it) ) );
+	if( log_changes )
+	  changed_voxels[*it] = this->link_.octree->isNodeOccupied( this->link_.octree->search(*it) );
       }
     }
     
-    count = 0;
+    statistics.free_update_s = secondsSince(phase_start);
+    phase_start = boost::posix_time::microsec_clock::universal_time();
+    
     // now mark all occupied cells:
-    for (KeySet::iterator it = occupied_cells.begin(), end=free_cells.end(); it!= end; ++it)
+    for (KeySet::iterator it = occupied_cells.begin(), end=occupied_cells.end(); it!= end; ++it)
     {
-      if( count++%100==0)
-	std::cout<<"\nInserting occupied: "<<count<<"/"<<occupied_cells.size();
-      
       typename TREE_TYPE::NodeType* voxel = this->link_.octree->search(*it);
+      if( counters!=NULL )
+	state_before = counters->stateOf(voxel);
       
       if( voxel==NULL )
       {
@@ -199,16 +237,53 @@ namespace octomap
 	  this->link_.octree->updateNode(*it, true);
 	}
       }
+      
+      if( counters!=NULL )
+	counters->update( state_before, counters->stateOf( this->link_.octree->search(*it) ) );
+      if( log_changes )
+	changed_voxels[*it] = this->link_.octree->isNodeOccupied( this->link_.octree->search(*it) );
     }
+    if( log_changes )
+      this->link_.changes->record(changed_voxels);
+    
+    statistics.occupied_update_s = secondsSince(phase_start);
+    phase_start = boost::posix_time::microsec_clock::universal_time();
+    
     if( this->occlusion_calculator_!=NULL )
     {
       std::cout<<"\nCalling occlusion calculator";
       this->occlusion_calculator_->insert(sensor_position,*pc_cpy,valid_indices);
+      statistics.occlusion_s = secondsSince(phase_start);
+    }
+    
+    statistics.node_count_delta = static_cast<long>(this->link_.octree->size()) - static_cast<long>(initial_tree_size); // negative if the updates pruned the tree
+    {
+      boost::mutex::scoped_lock lock(statistics_mutex_);
+      last_statistics_ = statistics;
     }
     
     std::cout<<"\nFinsihed calculations";
   }
   
+  TEMPT
+  void CSCOPE::setRecorder( boost::shared_ptr<SessionRecorder> recorder )
+  {
+    recorder_ = recorder;
+  }
+  
+  TEMPT
+  typename CSCOPE::InsertionStatistics CSCOPE::lastInsertionStatistics()
+  {
+    boost::mutex::scoped_lock lock(statistics_mutex_);
+    return last_statistics_;
+  }
+  
+  TEMPT
+  double CSCOPE::secondsSince( boost::posix_time::ptime start )
+  {
+    return (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds()*1e-6;
+  }
+  
   
 }
 
@@ -0,0 +1,79 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "ig_active_reconstruction_octomap/octomap_voxel_change_log.hpp"
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+
+namespace octomap
+{
+  
+  VoxelChangeLog::VoxelChangeLog()
+  : enabled_(false)
+  {
+    
+  }
+  
+  void VoxelChangeLog::setEnabled( bool enabled )
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    enabled_ = enabled;
+    if( !enabled_ )
+      changes_.clear();
+  }
+  
+  bool VoxelChangeLog::isEnabled()
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    return enabled_;
+  }
+  
+  void VoxelChangeLog::record( const ::octomap::KeyBoolMap& changes )
+  {
+    boost::mutex::scoped_lock lock(mutex_);
+    if( !enabled_ )
+      return;
+    
+    if( changes_.empty() )
+    {
+      changes_ = changes;
+      return;
+    }
+    for( ::octomap::KeyBoolMap::const_iterator it=changes.begin(); it!=changes.end(); ++it )
+    {
+      changes_[it->first] = it->second;
+    }
+  }
+  
+  void VoxelChangeLog::take( ::octomap::KeyBoolMap& changes )
+  {
+    changes.clear();
+    boost::mutex::scoped_lock lock(mutex_);
+    changes.swap(changes_);
+  }
+  
+}
+
+}
+
+}
@@ -30,6 +30,8 @@ namespace octomap
   TEMPT
   CSCOPE::WorldRepresentation( typename TREE_TYPE::Config config )
   : octree_( boost::make_shared<TREE_TYPE>(config) )
+  , counters_( boost::make_shared< MapMetricCounters<TREE_TYPE> >(octree_) )
+  , changes_( boost::make_shared<VoxelChangeLog>() )
   {
     
   }
@@ -40,6 +42,18 @@ namespace octomap
     
   }
   
+  TEMPT
+  boost::shared_ptr< MapMetricCounters<TREE_TYPE> > CSCOPE::mapMetricCounters()
+  {
+    return counters_;
+  }
+  
+  TEMPT
+  VoxelChangeLog::Ptr CSCOPE::voxelChangeLog()
+  {
+    return changes_;
+  }
+  
   /*TEMPT // cpp11 version
   template< template<typename, typename ...> class INPUT_OBJ_TYPE, class ... TEMPLATE_ARGS, class ... CONSTRUCTOR_ARGS >
   boost::shared_ptr< INPUT_OBJ_TYPE<TREE_TYPE,TEMPLATE_ARGS ...> > CSCOPE::getLinkedObj( CONSTRUCTOR_ARGS ... args )
@@ -74,6 +88,8 @@ namespace octomap
     
     Link new_link;
     new_link.octree = octree_;
+    new_link.counters = counters_;
+    new_link.changes = changes_;
     ptr->setLink(new_link);
     
     return ptr;
@@ -87,6 +103,8 @@ namespace octomap
     
     Link new_link;
     new_link.octree = octree_;
+    new_link.counters = counters_;
+    new_link.changes = changes_;
     ptr->setLink(new_link);
     
     return ptr;
@@ -0,0 +1,207 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include <iostream>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <chrono>
+
+#include <boost/make_shared.hpp>
+
+#include <ig_active_reconstruction/views_simple_view_space_module.hpp>
+#include <ig_active_reconstruction/basic_view_planner.hpp>
+#include <ig_active_reconstruction/weighted_linear_utility.hpp>
+#include <ig_active_reconstruction/max_calls_termination_criteria.hpp>
+
+#include "ig_active_reconstruction_octomap/octomap_ig_tree_world_representation.hpp"
+#include "ig_active_reconstruction_octomap/octomap_ray_occlusion_calculator.hpp"
+#include "ig_active_reconstruction_octomap/octomap_std_pcl_input_point_xyz.hpp"
+#include "ig_active_reconstruction_octomap/octomap_basic_ray_ig_calculator.hpp"
+#include "ig_active_reconstruction_octomap/octomap_simulated_robot.hpp"
+#include "ig_active_reconstruction_octomap/ig/occlusion_aware.hpp"
+#include "ig_active_reconstruction_octomap/ig/unobserved_voxel.hpp"
+#include "ig_active_reconstruction_octomap/ig/rear_side_voxel.hpp"
+#include "ig_active_reconstruction_octomap/ig/rear_side_entropy.hpp"
+#include "ig_active_reconstruction_octomap/ig/proximity_count.hpp"
+#include "ig_active_reconstruction_octomap/ig/vasquez_gomez_area_factor.hpp"
+#include "ig_active_reconstruction_octomap/ig/average_entropy.hpp"
+#include "ig_active_reconstruction_octomap/map_metric/omni_calculator.hpp"
+
+
+/*! Runs the complete reconstruction procedure headless, without ROS or Gazebo: The robot is replaced by a simulated depth
+ * sensor that ray casts on a ground truth octree and moves instantaneously. Given the same inputs, every run takes the same
+ * decisions, which makes it suitable for reproducible end-to-end performance measurements.
+ * 
+ * Usage: simulated_reconstruction <viewspace_file> [max_calls=20] [ground_truth.bt]
+ * If no ground truth file is given, a box with a sphere on top, centered at the origin, is used. The sensor and camera
+ * configuration corresponds to the flying gazebo stereo camera example, whose viewspace files can be used as well.
+ */
+int main(int argc, char **argv)
+{
+  namespace iar = ig_active_reconstruction;
+  namespace oct = ig_active_reconstruction::world_representation::octomap;
+  
+  typedef oct::IgTreeWorldRepresentation WorldRepresentation;
+  typedef WorldRepresentation::TreeType TreeType;
+  typedef oct::StdPclInputPointXYZ<TreeType>::PclType PclType;
+  typedef oct::SimulatedSensor<TreeType,PclType> Sensor;
+  typedef oct::SimulatedRobot<TreeType,PclType> Robot;
+  
+  if( argc<2 )
+  {
+    std::cout<<"Usage: "<<argv[0]<<" <viewspace_file> [max_calls=20] [ground_truth.bt]\n";
+    return 1;
+  }
+  std::string viewspace_file = argv[1];
+  unsigned int max_calls = (argc>2)? std::atoi(argv[2]) : 20;
+  std::string ground_truth_file = (argc>3)? argv[3] : "";
+  
+  // Configuration
+  // .............................................................................................
+  TreeType::Config octree_config;
+  octree_config.resolution_m = 0.01;
+  
+  oct::StdPclInputPointXYZ<TreeType>::Type::Config input_config;
+  input_config.max_sensor_range_m = 1.5;
+  
+  oct::BasicRayIgCalculator<TreeType>::Config ig_calc_config;
+  ig_calc_config.ray_caster_config.img_width_px = 480;
+  ig_calc_config.ray_caster_config.img_height_px = 480;
+  ig_calc_config.ray_caster_config.camera_matrix << 448.1008985853343, 0, 240.5,
+						    0, 448.1008985853343, 240.5,
+						    0, 0, 1;
+  ig_calc_config.ray_caster_config.max_ray_depth_m = 1.5;
+  ig_calc_config.ray_caster_config.resolution.ray_resolution_x = 0.1;
+  ig_calc_config.ray_caster_config.resolution.ray_resolution_y = 0.1;
+  
+  oct::InformationGain<TreeType>::Config ig_config;
+  
+  // The sensor uses the same camera as the information gain calculator, but casts a ray for every pixel
+  Sensor::Config sensor_config;
+  sensor_config.camera = ig_calc_config.ray_caster_config;
+  sensor_config.camera.resolution = iar::world_representation::PinholeCamRayCaster::ResolutionSettings();
+  
+  // Ground truth
+  // .............................................................................................
+  boost::shared_ptr<TreeType> ground_truth = boost::make_shared<TreeType>(octree_config);
+  if( !ground_truth_file.empty() )
+  {
+    if( !Sensor::loadGroundTruth(ground_truth_file,*ground_truth) )
+    {
+      std::cout<<"Failed to load the ground truth from '"<<ground_truth_file<<"'.\n";
+      return 1;
+    }
+  }
+  else
+  {
+    Sensor::addBox( *ground_truth, Eigen::Vector3d(-0.15,-0.15,0), Eigen::Vector3d(0.15,0.15,0.15) );
+    Sensor::addSphere( *ground_truth, Eigen::Vector3d(0,0,0.23), 0.08 );
+  }
+  Sensor::Ptr sensor = boost::make_shared<Sensor>(ground_truth,sensor_config);
+  
+  // World representation
+  // .............................................................................................
+  boost::shared_ptr<WorldRepresentation> world_representation = boost::make_shared<WorldRepresentation>(octree_config);
+  world_representation->mapMetricCounters()->setConfig(ig_config);
+  
+  oct::StdPclInputPointXYZ<TreeType>::Ptr input = world_representation->getLinkedObj<oct::StdPclInputPointXYZ>(input_config);
+  input->setOcclusionCalculator<oct::RayOcclusionCalculator>( oct::RayOcclusionCalculator<TreeType,PclType>::Options(0.3) );
+  
+  oct::BasicRayIgCalculator<TreeType>::Ptr ig_calculator = world_representation->getLinkedObj<oct::BasicRayIgCalculator>(ig_calc_config);
+  ig_calculator->registerInformationGain<oct::OcclusionAwareIg>(ig_config);
+  ig_calculator->registerInformationGain<oct::UnobservedVoxelIg>(ig_config);
+  ig_calculator->registerInformationGain<oct::RearSideVoxelIg>(ig_config);
+  ig_calculator->registerInformationGain<oct::RearSideEntropyIg>(ig_config);
+  ig_calculator->registerInformationGain<oct::ProximityCountIg>(ig_config);
+  ig_calculator->registerInformationGain<oct::VasquezGomezAreaFactorIg>(ig_config);
+  ig_calculator->registerInformationGain<oct::AverageEntropyIg>(ig_config);
+  
+  for( unsigned int metric=0; metric<oct::OmniCalculator<TreeType>::NUMBER_OF_METRICS; ++metric )
+  {
+    oct::OmniCalculator<TreeType>::Config mm_config;
+    mm_config.metric = static_cast<oct::OmniCalculator<TreeType>::Metric>(metric);
+    ig_calculator->registerMapMetric<oct::OmniCalculator>(mm_config);
+  }
+  boost::shared_ptr<iar::world_representation::CommunicationInterface> world_comm = ig_calculator;
+  
+  // Viewspace module
+  // .............................................................................................
+  boost::shared_ptr<iar::views::SimpleViewSpaceModule> views_comm = boost::make_shared<iar::views::SimpleViewSpaceModule>(viewspace_file);
+  iar::views::ViewSpace viewspace = views_comm->getViewSpace();
+  iar::views::ViewSpace::IdSet view_ids;
+  viewspace.getGoodViewSpace(view_ids,false);
+  if( view_ids.empty() )
+  {
+    std::cout<<"The viewspace file '"<<viewspace_file<<"' contains no views.\n";
+    return 1;
+  }
+  
+  // Simulated robot, starting at the first view
+  // .............................................................................................
+  Robot::Ptr robot = boost::make_shared<Robot>(sensor,input,viewspace.getView(view_ids.front()));
+  
+  // View planner
+  // .............................................................................................
+  boost::shared_ptr<iar::WeightedLinearUtility> utility_calculator = boost::make_shared<iar::WeightedLinearUtility>(1.0);
+  utility_calculator->setRobotCommUnit(robot);
+  utility_calculator->setWorldCommUnit(world_comm);
+  utility_calculator->useInformationGain("ProximityCountIg",1.0);
+  
+  iar::BasicViewPlanner view_planner;
+  view_planner.setRobotCommUnit(robot);
+  view_planner.setViewsCommUnit(views_comm);
+  view_planner.setWorldCommUnit(world_comm);
+  view_planner.setUtility(utility_calculator);
+  view_planner.setGoalEvaluationModule( boost::make_shared<iar::MaxCallsTerminationCriteria>(max_calls) );
+  
+  // Run until the termination criteria is fulfilled
+  // .............................................................................................
+  std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+  if( !view_planner.run() )
+  {
+    std::cout<<"The view planner could not be started.\n";
+    return 1;
+  }
+  view_planner.wait();
+  double duration_s = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+  
+  // Report
+  // .............................................................................................
+  std::vector<iar::world_representation::CommunicationInterface::MetricInfo> available_metrics;
+  world_comm->availableMapMetrics(available_metrics);
+  
+  iar::world_representation::CommunicationInterface::MapMetricRetrievalCommand metric_command;
+  for( size_t i=0; i<available_metrics.size(); ++i )
+    metric_command.metric_names.push_back(available_metrics[i].name);
+  iar::world_representation::CommunicationInterface::MapMetricRetrievalResultSet metric_results;
+  world_comm->computeMapMetric(metric_command,metric_results);
+  
+  std::cout<<"\nSimulated reconstruction finished after "<<duration_s<<" s.";
+  std::cout<<"\nMeasurements: "<<robot->numberOfMeasurements();
+  std::cout<<"\nTravelled distance: "<<robot->travelledDistance()<<" m";
+  for( size_t i=0; i<metric_results.size() && i<metric_command.metric_names.size(); ++i )
+  {
+    if( metric_results[i].status==iar::world_representation::CommunicationInterface::ResultInformation::SUCCEEDED )
+      std::cout<<"\n"<<metric_command.metric_names[i]<<": "<<metric_results[i].value;
+  }
+  std::cout<<"\n";
+  
+  return 0;
+}
@@ -0,0 +1,252 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/make_shared.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include "ig_active_reconstruction_octomap/octomap_session_log.hpp"
+#include "ig_active_reconstruction_octomap/octomap_ig_tree_world_representation.hpp"
+#include "ig_active_reconstruction_octomap/octomap_ray_occlusion_calculator.hpp"
+#include "ig_active_reconstruction_octomap/octomap_std_pcl_input_point_xyz.hpp"
+#include "ig_active_reconstruction_octomap/octomap_basic_ray_ig_calculator.hpp"
+#include "ig_active_reconstruction_octomap/ig/occlusion_aware.hpp"
+#include "ig_active_reconstruction_octomap/ig/unobserved_voxel.hpp"
+#include "ig_active_reconstruction_octomap/ig/rear_side_voxel.hpp"
+#include "ig_active_reconstruction_octomap/ig/rear_side_entropy.hpp"
+#include "ig_active_reconstruction_octomap/ig/proximity_count.hpp"
+#include "ig_active_reconstruction_octomap/ig/vasquez_gomez_area_factor.hpp"
+#include "ig_active_reconstruction_octomap/ig/average_entropy.hpp"
+#include "ig_active_reconstruction_octomap/map_metric/omni_calculator.hpp"
+
+namespace iar = ig_active_reconstruction;
+namespace oct = ig_active_reconstruction::world_representation::octomap;
+
+typedef oct::IgTreeWorldRepresentation WorldRepresentation;
+typedef WorldRepresentation::TreeType TreeType;
+typedef oct::StdPclInputPointXYZ<TreeType>::PclType PclType;
+typedef iar::world_representation::CommunicationInterface WorldComm;
+typedef Eigen::Transform<double,3,Eigen::Affine> Transform;
+
+//! Returns the seconds that passed since start.
+static double secondsSince( boost::posix_time::ptime start )
+{
+  return (boost::posix_time::microsec_clock::universal_time() - start).total_microseconds()*1e-6;
+}
+
+//! Prints the throughput of a stage.
+static void printStage( std::string name, double duration_s, size_t count, std::string unit )
+{
+  std::cout<<"\n"<<name<<": "<<count<<" "<<unit<<" in "<<duration_s<<" s";
+  if( duration_s>0 )
+    std::cout<<" ("<<count/duration_s<<" "<<unit<<"/s)";
+}
+
+/*! Replays a session log written by a SessionRecorder (see the session_recording/file_path parameter of the octomap world
+ * representation) at full speed, without ROS: A world representation is set up with the recorded configuration, then the
+ * recorded pointclouds and information gain commands are fed into it in their original order. If a viewspace was recorded,
+ * the information gains of all its views are finally computed in one batched call on the resulting map.
+ * 
+ * All records are loaded before the replay starts, such that reading the log doesn't distort the measurements. The
+ * throughput of each stage is reported, which allows to compare builds on identical workloads.
+ * 
+ * Usage: replay_session <session_log>
+ */
+int main(int argc, char **argv)
+{
+  if( argc<2 )
+  {
+    std::cout<<"Usage: "<<argv[0]<<" <session_log>\n";
+    return 1;
+  }
+  
+  // Load the log
+  // .............................................................................................
+  oct::SessionLogReader reader;
+  if( !reader.open(argv[1]) )
+  {
+    std::cout<<"Failed to open the session log '"<<argv[1]<<"'.\n";
+    return 1;
+  }
+  
+  oct::SessionSetup setup;
+  std::vector<oct::SessionRecordType::Enum> steps; // replay order, each pointcloud and command step takes the next element of its kind
+  std::vector<PclType::Ptr> clouds;
+  std::vector<Transform, Eigen::aligned_allocator<Transform> > sensor_to_world;
+  std::vector<WorldComm::IgRetrievalCommand> commands;
+  iar::views::ViewSpace viewspace;
+  size_t number_of_points = 0;
+  
+  for( oct::SessionRecordType::Enum type=reader.next(); type!=oct::SessionRecordType::NONE; type=reader.next() )
+  {
+    bool success = false;
+    switch(type)
+    {
+      case oct::SessionRecordType::SETUP:
+	success = reader.get(setup);
+	break;
+      case oct::SessionRecordType::POINTCLOUD:
+      {
+	Transform transform;
+	PclType::Ptr cloud = boost::make_shared<PclType>();
+	success = reader.getPointcloud(transform,*cloud);
+	if( success )
+	{
+	  clouds.push_back(cloud);
+	  sensor_to_world.push_back(transform);
+	  steps.push_back(type);
+	  number_of_points += cloud->points.size();
+	}
+	break;
+      }
+      case oct::SessionRecordType::IG_COMMAND:
+      {
+	WorldComm::IgRetrievalCommand command;
+	success = reader.get(command);
+	if( success )
+	{
+	  commands.push_back(command);
+	  steps.push_back(type);
+	}
+	break;
+      }
+      case oct::SessionRecordType::VIEWSPACE:
+	success = reader.get(viewspace);
+	break;
+      default:
+	success = true; // unknown record types of newer logs are skipped
+	break;
+    }
+    if( !success )
+    {
+      std::cout<<"Record "<<steps.size()<<" of the session log is corrupt, the replay stops before it.\n";
+      break;
+    }
+  }
+  std::cout<<"Loaded "<<clouds.size()<<" pointclouds with "<<number_of_points<<" points, "<<commands.size()<<" information gain commands and "<<viewspace.size()<<" views.\n";
+  
+  // Set up the world as it was during the session
+  // .............................................................................................
+  boost::shared_ptr<WorldRepresentation> world_representation = boost::make_shared<WorldRepresentation>(setup.octree);
+  world_representation->mapMetricCounters()->setConfig(setup.ig);
+  
+  oct::StdPclInputPointXYZ<TreeType>::Type::Config input_config;
+  input_config.use_bounding_box = setup.use_bounding_box;
+  input_config.bounding_box_min_point_m = ::octomap::point3d( setup.bounding_box_min_point_m(0), setup.bounding_box_min_point_m(1), setup.bounding_box_min_point_m(2) );
+  input_config.bounding_box_max_point_m = ::octomap::point3d( setup.bounding_box_max_point_m(0), setup.bounding_box_max_point_m(1), setup.bounding_box_max_point_m(2) );
+  input_config.max_sensor_range_m = setup.max_sensor_range_m;
+  oct::StdPclInputPointXYZ<TreeType>::Ptr input = world_representation->getLinkedObj<oct::StdPclInputPointXYZ>(input_config);
+  if( setup.occlusion_update_dist_m>=0 )
+    input->setOcclusionCalculator<oct::RayOcclusionCalculator>( oct::RayOcclusionCalculator<TreeType,PclType>::Options(setup.occlusion_update_dist_m) );
+  
+  oct::BasicRayIgCalculator<TreeType>::Config ig_calc_config;
+  ig_calc_config.ray_caster_config = setup.camera;
+  oct::BasicRayIgCalculator<TreeType>::Ptr ig_calculator = world_representation->getLinkedObj<oct::BasicRayIgCalculator>(ig_calc_config);
+  
+  // same registration order as in the octomap world representation node, such that recorded metric ids are valid
+  ig_calculator->registerInformationGain<oct::OcclusionAwareIg>(setup.ig);
+  ig_calculator->registerInformationGain<oct::UnobservedVoxelIg>(setup.ig);
+  ig_calculator->registerInformationGain<oct::RearSideVoxelIg>(setup.ig);
+  ig_calculator->registerInformationGain<oct::RearSideEntropyIg>(setup.ig);
+  ig_calculator->registerInformationGain<oct::ProximityCountIg>(setup.ig);
+  ig_calculator->registerInformationGain<oct::VasquezGomezAreaFactorIg>(setup.ig);
+  ig_calculator->registerInformationGain<oct::AverageEntropyIg>(setup.ig);
+  
+  for( unsigned int metric=0; metric<oct::OmniCalculator<TreeType>::NUMBER_OF_METRICS; ++metric )
+  {
+    oct::OmniCalculator<TreeType>::Config mm_config;
+    mm_config.metric = static_cast<oct::OmniCalculator<TreeType>::Metric>(metric);
+    ig_calculator->registerMapMetric<oct::OmniCalculator>(mm_config);
+  }
+  
+  // Replay
+  // .............................................................................................
+  double insertion_time_s = 0;
+  double ig_time_s = 0;
+  size_t number_of_ig_poses = 0;
+  size_t next_cloud = 0, next_command = 0;
+  PclType cloud;
+  
+  boost::posix_time::ptime replay_start = boost::posix_time::microsec_clock::universal_time();
+  for( size_t i=0; i<steps.size(); ++i )
+  {
+    if( steps[i]==oct::SessionRecordType::POINTCLOUD )
+    {
+      cloud = *clouds[next_cloud]; // push() operates on the cloud, keep the recorded one
+      boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+      input->push( sensor_to_world[next_cloud], cloud );
+      insertion_time_s += secondsSince(start);
+      ++next_cloud;
+    }
+    else
+    {
+      WorldComm::ViewIgResult result;
+      boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+      ig_calculator->computeViewIg( commands[next_command], result );
+      ig_time_s += secondsSince(start);
+      number_of_ig_poses += commands[next_command].path.size();
+      ++next_command;
+    }
+  }
+  double replay_time_s = secondsSince(replay_start);
+  
+  // Viewspace information gains on the final map
+  // .............................................................................................
+  double viewspace_time_s = 0;
+  size_t number_of_views = 0;
+  if( viewspace.size()!=0 )
+  {
+    WorldComm::ViewspaceIgRetrievalCommand viewspace_command;
+    for( iar::views::ViewSpace::Iterator it=viewspace.begin(); it!=viewspace.end(); ++it )
+      viewspace_command.poses.push_back( it->pose() );
+    if( !commands.empty() )
+    {
+      viewspace_command.metric_names = commands.back().metric_names;
+      viewspace_command.metric_ids = commands.back().metric_ids;
+      viewspace_command.config = commands.back().config;
+    }
+    else
+    {
+      std::vector<WorldComm::MetricInfo> metrics;
+      ig_calculator->availableIgMetrics(metrics);
+      for( size_t i=0; i<metrics.size(); ++i )
+	viewspace_command.metric_ids.push_back(metrics[i].id);
+    }
+    
+    WorldComm::ViewspaceIgResult result;
+    boost::posix_time::ptime start = boost::posix_time::microsec_clock::universal_time();
+    ig_calculator->computeViewspaceIg( viewspace_command, result );
+    viewspace_time_s = secondsSince(start);
+    number_of_views = viewspace_command.poses.size();
+  }
+  
+  // Report
+  // .............................................................................................
+  std::cout<<"\n\nReplay of '"<<argv[1]<<"':";
+  printStage( "Pointcloud insertion", insertion_time_s, number_of_points, "points" );
+  printStage( "Pointcloud insertion", insertion_time_s, clouds.size(), "clouds" );
+  printStage( "Information gain commands", ig_time_s, number_of_ig_poses, "poses" );
+  printStage( "Viewspace information gain", viewspace_time_s, number_of_views, "views" );
+  std::cout<<"\nTotal replay time: "<<replay_time_s<<" s\n";
+  
+  return 0;
+}
@@ -0,0 +1,167 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include <algorithm>
+#include <limits>
+#include <gtest/gtest.h>
+#include <boost/make_shared.hpp>
+
+#include "ig_active_reconstruction_octomap/octomap_ig_tree_world_representation.hpp"
+#include "ig_active_reconstruction_octomap/octomap_std_pcl_input_point_xyz.hpp"
+#include "ig_active_reconstruction_octomap/octomap_map_metric_counters.hpp"
+
+namespace oct = ig_active_reconstruction::world_representation::octomap;
+
+namespace
+{
+  typedef oct::IgTreeWorldRepresentation WorldRepresentation;
+  typedef WorldRepresentation::TreeType TreeType;
+  typedef oct::StdPclInputPointXYZ<TreeType>::PclType PclType;
+  typedef oct::StdPclInputPointXYZ<TreeType>::Type Input;
+  typedef oct::MapMetricCounters<TreeType> Counters;
+  
+  /*! Linked object that only exposes its link, gives the tests access to the octree of a world representation.
+   */
+  template<class TREE_TYPE>
+  class LinkProbe: public oct::WorldRepresentation<TREE_TYPE>::LinkedObject
+  {
+  public:
+    struct Config{};
+    
+    LinkProbe( Config config = Config() ){}
+    
+    typename oct::WorldRepresentation<TREE_TYPE>::Link& link()
+    {
+      return this->link_;
+    }
+  };
+  
+  /*! Creates a side x side grid of points on a plane at distance range_m in front of the sensor (z axis).
+   */
+  PclType planeCloud( unsigned int side, double range_m, double half_width_m )
+  {
+    PclType pc;
+    for( unsigned int row=0; row<side; ++row )
+    {
+      for( unsigned int col=0; col<side; ++col )
+      {
+	pcl::PointXYZ point;
+	point.x = -half_width_m + 2*half_width_m*(col+0.5)/side;
+	point.y = -half_width_m + 2*half_width_m*(row+0.5)/side;
+	point.z = range_m;
+	pc.push_back(point);
+      }
+    }
+    return pc;
+  }
+  
+  Eigen::Transform<double,3,Eigen::Affine> sensorPose( double x_m )
+  {
+    Eigen::Transform<double,3,Eigen::Affine> pose;
+    pose = Eigen::Translation3d(x_m,0,0);
+    return pose;
+  }
+  
+  class StdPclInputTest: public ::testing::Test
+  {
+  protected:
+    virtual void SetUp()
+    {
+      TreeType::Config octree_config;
+      octree_config.resolution_m = 0.1;
+      world = boost::make_shared<WorldRepresentation>(octree_config);
+      octree = world->getLinkedObj<LinkProbe>()->link().octree;
+      
+      Input::Config input_config;
+      input_config.max_sensor_range_m = 3;
+      input = world->getLinkedObj<oct::StdPclInputPointXYZ>(input_config);
+    }
+    
+  protected:
+    boost::shared_ptr<WorldRepresentation> world;
+    boost::shared_ptr<TreeType> octree;
+    Input::Ptr input;
+  };
+}
+
+TEST_F( StdPclInputTest, InsertionStatisticsDescribeTheCloud )
+{
+  PclType pc = planeCloud(20,2,0.5);
+  input->push(sensorPose(0),pc);
+  
+  Input::InsertionStatistics statistics = input->lastInsertionStatistics();
+  EXPECT_EQ( 400u, statistics.number_of_points );
+  EXPECT_EQ( 400u, statistics.number_of_valid_points );
+  EXPECT_GT( statistics.number_of_occupied_voxels, 0u );
+  EXPECT_GT( statistics.number_of_free_voxels, statistics.number_of_occupied_voxels );
+  EXPECT_EQ( static_cast<long>(octree->size()), statistics.node_count_delta ); // the tree was empty
+}
+
+TEST_F( StdPclInputTest, InvalidPointsAreDropped )
+{
+  PclType pc = planeCloud(10,2,0.5);
+  pc.points[3].x = std::numeric_limits<float>::quiet_NaN();
+  pc.points[7].z = std::numeric_limits<float>::quiet_NaN();
+  input->push(sensorPose(0),pc);
+  
+  Input::InsertionStatistics statistics = input->lastInsertionStatistics();
+  EXPECT_EQ( 100u, statistics.number_of_points );
+  EXPECT_EQ( 98u, statistics.number_of_valid_points );
+}
+
+TEST_F( StdPclInputTest, PointsBeyondTheSensorRangeOnlyClearSpace )
+{
+  PclType pc = planeCloud(10,5,0.5);
+  input->push(sensorPose(0),pc);
+  
+  EXPECT_EQ( 0u, input->lastInsertionStatistics().number_of_occupied_voxels );
+  EXPECT_GT( input->lastInsertionStatistics().number_of_free_voxels, 0u );
+  EXPECT_EQ( 0, world->mapMetricCounters()->values().occupied_voxels );
+}
+
+TEST_F( StdPclInputTest, CountersMatchAFullRecount )
+{
+  for( int i=0; i<4; ++i )
+  {
+    PclType pc = planeCloud(20,2,0.5);
+    input->push(sensorPose(0.1*i),pc);
+  }
+  
+  Counters::Values incremental = world->mapMetricCounters()->values();
+  
+  Counters recount(octree);
+  recount.rebuild();
+  Counters::Values full = recount.values();
+  
+  EXPECT_GT( incremental.occupied_voxels, 0 );
+  EXPECT_GT( incremental.free_voxels, 0 );
+  EXPECT_EQ( full.total_voxels, incremental.total_voxels );
+  EXPECT_EQ( full.known_voxels, incremental.known_voxels );
+  EXPECT_EQ( full.unknown_voxels, incremental.unknown_voxels );
+  EXPECT_EQ( full.occupied_voxels, incremental.occupied_voxels );
+  EXPECT_EQ( full.free_voxels, incremental.free_voxels );
+  EXPECT_EQ( full.occluded_voxels, incremental.occluded_voxels );
+  EXPECT_NEAR( full.total_entropy, incremental.total_entropy, 1e-6*std::max(1.0,full.total_entropy) );
+}
+
+int main(int argc, char **argv)
+{
+  testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
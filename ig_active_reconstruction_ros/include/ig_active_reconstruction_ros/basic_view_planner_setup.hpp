@@ -0,0 +1,43 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include "ros/ros.h"
+#include "ig_active_reconstruction/basic_view_planner.hpp"
+
+namespace ig_active_reconstruction
+{
+  
+  /*! Creates a BasicViewPlanner together with its utility calculator and termination criteria, configured with the
+   * parameters of the basic_view_planner node (see its launch file). The communication interfaces can be ROS clients, as in
+   * the basic_view_planner node, or modules residing in the same process.
+   * @param robot_comm Interface to the robot, wrapped in a movement cost cache if configured.
+   * @param views_comm Interface to the viewspace module.
+   * @param world_comm Interface to the world representation.
+   * @param nh Node handle from whose namespace the parameters are loaded.
+   * @return The configured view planner.
+   */
+  boost::shared_ptr<BasicViewPlanner> loadBasicViewPlanner( boost::shared_ptr<robot::CommunicationInterface> robot_comm, boost::shared_ptr<views::CommunicationInterface> views_comm, boost::shared_ptr<world_representation::CommunicationInterface> world_comm, ros::NodeHandle nh = ros::NodeHandle("~") );
+  
+  /*! Runs the simple command line user interface of the basic_view_planner node, periodically printing the status of the
+   * view planner, until the user quits.
+   * @param view_planner The controlled view planner.
+   */
+  void runBasicViewPlannerUi( BasicViewPlanner& view_planner );
+  
+}
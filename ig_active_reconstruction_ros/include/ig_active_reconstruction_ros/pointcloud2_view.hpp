@@ -0,0 +1,72 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <vector>
+#include <string>
+
+#include <std_msgs/Header.h>
+#include <sensor_msgs/PointCloud2.h>
+#include <sensor_msgs/PointField.h>
+
+namespace ros_tools
+{
+  
+  /*! Non-owning view on the layout and data of a sensor_msgs::PointCloud2, which may reside in a message or elsewhere
+   * (e.g. in shared memory). Allows reading the point fields in place, without converting the cloud first. The view is
+   * only valid as long as the data it points to.
+   */
+  struct PointCloud2View
+  {
+  public:
+    /*! Constructs an empty view.
+     */
+    PointCloud2View();
+    
+    /*! Constructs a view on the data of a message.
+     * @param cloud The message, must outlive the view.
+     */
+    PointCloud2View( const sensor_msgs::PointCloud2& cloud );
+    
+    /*! Returns the field with the given name, or NULL if the cloud has no such field.
+     */
+    const sensor_msgs::PointField* field( const std::string& name ) const;
+    
+    /*! Returns the number of points.
+     */
+    size_t size() const;
+    
+    /*! Returns a pointer to the beginning of the point with the given row and column.
+     */
+    const uint8_t* point( uint32_t row, uint32_t column ) const;
+    
+  public:
+    std_msgs::Header header;
+    uint32_t height;
+    uint32_t width;
+    std::vector<sensor_msgs::PointField> fields;
+    bool is_bigendian;
+    uint32_t point_step;
+    uint32_t row_step;
+    bool is_dense;
+    
+    const uint8_t* data; //! Start of the point data.
+    size_t data_size; //! Size of the point data [bytes].
+  };
+  
+}
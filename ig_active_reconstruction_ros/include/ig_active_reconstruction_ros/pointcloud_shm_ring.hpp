@@ -0,0 +1,120 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <string>
+
+#include <boost/shared_ptr.hpp>
+#include <boost/function.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/interprocess/mapped_region.hpp>
+
+#include <sensor_msgs/PointCloud2.h>
+
+#include "ig_active_reconstruction_ros/pointcloud2_view.hpp"
+
+namespace ros_tools
+{
+  
+  /*! Ring buffer of pointclouds in a shared memory segment, used to hand pointclouds from one process to another on the
+   * same machine without serializing them: The writer copies a cloud into the next slot of the ring and only sends the
+   * returned sequence number to the reader (e.g. through a service), which then reads the cloud in place.
+   * 
+   * The writer creates the segment (replacing a stale one of the same name) and removes it on destruction, readers open it.
+   * Each slot is locked while it is written or read. A slot is overwritten once the writer went around the ring, reading an
+   * overwritten sequence fails.
+   */
+  class PointCloudShmRing
+  {
+  public:
+    struct Role
+    {
+      enum Enum
+      {
+	WRITER, //! Creates the segment and writes to it.
+	READER //! Opens an existing segment and reads from it.
+      };
+    };
+    
+    struct Config
+    {
+    public:
+      Config();
+      
+    public:
+      std::string segment_name; //! Name of the shared memory segment. Default: "iar_pointcloud_ring".
+      unsigned int number_of_slots; //! Number of slots in the ring (writer only). Default: 4.
+      size_t slot_size_bytes; //! Maximal size of the point data of a cloud (writer only) [bytes]. Default: 32 MB.
+    };
+    
+  public:
+    /*! Constructor, creates or opens the segment.
+     * @param config Configuration, the reader only uses the segment name.
+     * @param role Whether the segment is written or read.
+     * @throws boost::interprocess::interprocess_exception if the segment can't be created or (reader) doesn't exist or is invalid.
+     */
+    PointCloudShmRing( Config config, Role::Enum role );
+    
+    /*! Destructor, the writer removes the segment.
+     */
+    ~PointCloudShmRing();
+    
+    /*! Copies a pointcloud into the next slot of the ring (writer).
+     * @param cloud The pointcloud.
+     * @param sequence (Output) Sequence number under which the cloud can be read.
+     * @return False if the cloud doesn't fit into a slot or too many fields or a too long frame id.
+     */
+    bool write( const sensor_msgs::PointCloud2& cloud, uint64_t& sequence );
+    
+    /*! Reads the pointcloud with the given sequence number in place, the slot being locked while the reader is called.
+     * @param sequence Sequence number of the cloud.
+     * @param reader Called with a view on the cloud, which is only valid during the call.
+     * @return False if the sequence number isn't (or not anymore) in the ring.
+     */
+    bool read( uint64_t sequence, boost::function<void(const PointCloud2View&)> reader );
+    
+    /*! Returns the name of the segment.
+     */
+    const std::string& segmentName() const;
+    
+  private:
+    struct SegmentHeader;
+    struct SlotHeader;
+    
+    /*! Returns the header of the slot with the given index.
+     */
+    SlotHeader* slot( unsigned int index );
+    
+    /*! Returns the start of the point data of the slot with the given index.
+     */
+    uint8_t* slotData( unsigned int index );
+    
+  private:
+    Config config_;
+    Role::Enum role_;
+    
+    boost::interprocess::shared_memory_object segment_;
+    boost::interprocess::mapped_region region_;
+    SegmentHeader* header_; //! Located at the beginning of the mapped region.
+    
+    // noncopyable
+    PointCloudShmRing( const PointCloudShmRing& );
+    PointCloudShmRing& operator=( const PointCloudShmRing& );
+  };
+  
+}
@@ -19,6 +19,13 @@
 
 #include "ros/ros.h"
 #include "ig_active_reconstruction/robot_communication_interface.hpp"
+#include "ig_active_reconstruction_ros/service_client_pool.hpp"
+
+#include "ig_active_reconstruction_msgs/ViewRequest.h"
+#include "ig_active_reconstruction_msgs/RetrieveData.h"
+#include "ig_active_reconstruction_msgs/MovementCostCalculation.h"
+#include "ig_active_reconstruction_msgs/MovementCostsCalculation.h"
+#include "ig_active_reconstruction_msgs/MoveToOrder.h"
 
 namespace ig_active_reconstruction
 {
@@ -28,15 +35,18 @@ namespace robot
   
   /*! Generic remote ROS client robot communication interface implementation.
    * 
-   * Uses the ROS communication interface (topics, services etc.) to forward requests.
+   * Uses the ROS communication interface (topics, services etc.) to forward requests. Services are called through pools of
+   * persistent clients, one per calling thread. Failed data retrieval and movement orders are not repeated, since they
+   * might have been executed nevertheless.
    */
   class RosClientCI: public CommunicationInterface
   {
   public:
     /*! Constructor
      * @param nh_sub ROS node handle defines the namespace in which ROS communication will be carried out for any topic or service subscribers.
+     * @param pool_config Configuration of the service client pools.
      */
-    RosClientCI( ros::NodeHandle nh_sub );
+    RosClientCI( ros::NodeHandle nh_sub, ros_tools::ServiceClientPoolConfig pool_config = ros_tools::ServiceClientPoolConfig() );
   
     /*! returns the current view */
     virtual views::View getCurrentView();
@@ -64,6 +74,14 @@ namespace robot
     */
     virtual MovementCost movementCost( views::View& start_view, views::View& target_view, bool fill_additional_information  );
     
+    /*! Returns the costs to move from start view to each of the target views, using a single service call.
+    * @param start_view the start view
+    * @param target_views the target views
+    * @param costs (output) costs for the movements, in the same order as the target views
+    * @param fill_additional_information if true then the different parts of the cost will be included in the additional fields as well
+    */
+    virtual void movementCosts( views::View& start_view, std::vector<views::View, Eigen::aligned_allocator<views::View> >& target_views, std::vector<MovementCost>& costs, bool fill_additional_information );
+    
     /*! Tells the robot to get the camera to a new view
     * @param _target_view where to move to
     * @return false if the operation failed
@@ -73,10 +91,11 @@ namespace robot
   protected:
     ros::NodeHandle nh_sub_;
     
-    ros::ServiceClient current_view_retriever_;
-    ros::ServiceClient data_retriever_;
-    ros::ServiceClient cost_retriever_;
-    ros::ServiceClient robot_mover_;
+    ros_tools::ServiceClientPool<ig_active_reconstruction_msgs::ViewRequest> current_view_retriever_;
+    ros_tools::ServiceClientPool<ig_active_reconstruction_msgs::RetrieveData> data_retriever_;
+    ros_tools::ServiceClientPool<ig_active_reconstruction_msgs::MovementCostCalculation> cost_retriever_;
+    ros_tools::ServiceClientPool<ig_active_reconstruction_msgs::MovementCostsCalculation> batch_cost_retriever_;
+    ros_tools::ServiceClientPool<ig_active_reconstruction_msgs::MoveToOrder> robot_mover_;
   };
   
 }
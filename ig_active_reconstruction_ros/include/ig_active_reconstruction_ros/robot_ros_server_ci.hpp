@@ -19,10 +19,12 @@
 
 #include "ros/ros.h"
 #include "ig_active_reconstruction/robot_communication_interface.hpp"
+#include "ig_active_reconstruction/thread_pool.hpp"
 
 #include "ig_active_reconstruction_msgs/ViewRequest.h"
 #include "ig_active_reconstruction_msgs/RetrieveData.h"
 #include "ig_active_reconstruction_msgs/MovementCostCalculation.h"
+#include "ig_active_reconstruction_msgs/MovementCostsCalculation.h"
 #include "ig_active_reconstruction_msgs/MoveToOrder.h"
 
 namespace ig_active_reconstruction
@@ -35,6 +37,9 @@ namespace robot
    * 
    * Uses the ROS communication interface (topics, services etc.) to receive requests and feed it into
    * a robot::CommunicationInterface implementation.
+   * 
+   * Batched movement cost requests are evaluated in parallel on a thread pool: The linked interface's
+   * movementCost(start_view,target_view,fill_additional_information) must thus be safe to be called concurrently.
    */
   class RosServerCI: public CommunicationInterface
   {
@@ -49,6 +54,11 @@ namespace robot
      * @param linked_interface Interface pointer.
      */
     void setLinkedInterface( boost::shared_ptr<CommunicationInterface> linked_interface );
+    
+    /*! Sets the thread pool on which batched movement cost requests are evaluated.
+     * @param thread_pool Thread pool pointer.
+     */
+    void setThreadPool( boost::shared_ptr<ThreadPool> thread_pool );
   
     /*! returns the current view */
     virtual views::View getCurrentView();
@@ -76,6 +86,14 @@ namespace robot
     */
     virtual MovementCost movementCost( views::View& start_view, views::View& target_view, bool fill_additional_information  );
     
+    /*! Returns the costs to move from start view to each of the target views.
+    * @param start_view the start view
+    * @param target_views the target views
+    * @param costs (output) costs for the movements, in the same order as the target views
+    * @param fill_additional_information if true then the different parts of the cost will be included in the additional fields as well
+    */
+    virtual void movementCosts( views::View& start_view, std::vector<views::View, Eigen::aligned_allocator<views::View> >& target_views, std::vector<MovementCost>& costs, bool fill_additional_information );
+    
     /*! Tells the robot to get the camera to a new view
     * @param _target_view where to move to
     * @return false if the operation failed
@@ -89,16 +107,20 @@ namespace robot
     
     bool movementCostService( ig_active_reconstruction_msgs::MovementCostCalculation::Request& req, ig_active_reconstruction_msgs::MovementCostCalculation::Response& res );
     
+    bool movementCostsService( ig_active_reconstruction_msgs::MovementCostsCalculation::Request& req, ig_active_reconstruction_msgs::MovementCostsCalculation::Response& res );
+    
     bool moveToService( ig_active_reconstruction_msgs::MoveToOrder::Request& req, ig_active_reconstruction_msgs::MoveToOrder::Response& res );
     
   protected:
     ros::NodeHandle nh_;
     
     boost::shared_ptr<CommunicationInterface> linked_interface_; //! Linked interface.
+    boost::shared_ptr<ThreadPool> thread_pool_; //! Used to evaluate batched cost requests.
     
     ros::ServiceServer current_view_service_;
     ros::ServiceServer data_service_;
     ros::ServiceServer cost_service_;
+    ros::ServiceServer batch_cost_service_;
     ros::ServiceServer robot_moving_service_;
   };
   
@@ -0,0 +1,103 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <thread>
+#include <string>
+
+#include <boost/shared_ptr.hpp>
+
+#include "ros/ros.h"
+
+namespace ros_tools
+{
+  
+  /*! Configuration of a ServiceClientPool.
+   */
+  struct ServiceClientPoolConfig
+  {
+  public:
+    ServiceClientPoolConfig();
+    
+  public:
+    bool persistent; //! Whether persistent connections are used. Default: true.
+    unsigned int max_clients; //! Maximal number of clients held at once, the pool is flushed if exceeded (e.g. because of calls from many short-lived threads). Default: 32.
+    unsigned int max_retries; //! Number of times a failed call is repeated after reconnecting. Default: 1.
+    double reconnect_timeout_s; //! [s] Time to wait for the service to become available when reconnecting. Default: 1.0.
+  };
+  
+  /*! Pool of ROS service clients for a single service, holding one client per calling thread. Clients are persistent by
+   * default, such that the connection is kept open between calls instead of being handshaked anew each time, and calls of
+   * different threads don't serialise on a single connection. Closed connections are reopened before calling, and if a
+   * call fails, the client of the calling thread is reconnected and the call repeated (if configured).
+   */
+  template<class SERVICE>
+  class ServiceClientPool
+  {
+  public:
+    typedef ServiceClientPoolConfig Config;
+    
+  public:
+    /*! Constructor.
+     * @param nh ROS node handle in whose namespace the service is called.
+     * @param service_name Name of the service.
+     * @param config Configuration.
+     */
+    ServiceClientPool( ros::NodeHandle nh, std::string service_name, Config config = Config() );
+    
+    /*! Calls the service with the client of the calling thread, reconnecting and retrying on failure.
+     * @param service Service request and (output) response.
+     * @return True if the call succeeded.
+     */
+    bool call( SERVICE& service );
+    
+    /*! Returns the number of clients currently held.
+     */
+    size_t size();
+    
+    /*! Returns the name of the service.
+     */
+    const std::string& serviceName() const;
+    
+  protected:
+    /*! Returns the client of the calling thread, creating it if it doesn't exist yet.
+     */
+    boost::shared_ptr<ros::ServiceClient> threadClient();
+    
+    /*! Replaces the client of the calling thread with a newly connected one.
+     */
+    boost::shared_ptr<ros::ServiceClient> reconnect();
+    
+    /*! Creates a new client.
+     */
+    boost::shared_ptr<ros::ServiceClient> createClient();
+    
+  private:
+    ros::NodeHandle nh_;
+    std::string service_name_;
+    Config config_;
+    
+    std::mutex clients_mutex_; //! Protects the client map.
+    std::map< std::thread::id, boost::shared_ptr<ros::ServiceClient> > clients_; //! One client per calling thread.
+  };
+  
+}
+
+#include "../src/code_base/service_client_pool.inl"
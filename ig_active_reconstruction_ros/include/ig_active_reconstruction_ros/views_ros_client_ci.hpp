@@ -36,9 +36,10 @@ namespace views
      */
     RosClientCI( ros::NodeHandle nh );
     
-    /*! Returns the view space that is available for planning.
-      * @param _space pointer to the ViewSpace object that should be filled
-      */
+    /*! Returns the view space that is available for planning. The client keeps a copy of the viewspace which is
+     * synchronized using the "views/space_delta" service, such that only views changed since the last call are transferred.
+     * Falls back to retrieving the complete viewspace through "views/space" if the delta service isn't available.
+     */
     virtual const ViewSpace& getViewSpace();
     
     /*! Add a set of new views to the viewspace.
@@ -67,10 +68,13 @@ namespace views
     ros::NodeHandle nh_;
     
     ros::ServiceClient planning_space_receiver_;
+    ros::ServiceClient planning_space_delta_receiver_;
     ros::ServiceClient views_adder_;
     ros::ServiceClient views_deleter_;
     
-    ViewSpace viewspace_;
+    ViewSpace viewspace_; //! Local copy of the viewspace.
+    ViewSpace::VersionType synced_instance_; //! Instance of the server's viewspace the local copy is synchronized with, zero if none.
+    ViewSpace::VersionType synced_version_; //! Version of the server's viewspace the local copy corresponds to.
   };
   
 }
@@ -22,6 +22,7 @@
 
 #include "ig_active_reconstruction_msgs/DeleteViews.h"
 #include "ig_active_reconstruction_msgs/ViewSpaceRequest.h"
+#include "ig_active_reconstruction_msgs/ViewSpaceDelta.h"
 #include "ig_active_reconstruction_msgs/ViewSpaceUpdate.h"
 
 namespace ig_active_reconstruction
@@ -70,6 +71,10 @@ namespace views
   protected:
     bool viewspaceService( ig_active_reconstruction_msgs::ViewSpaceRequest::Request& req, ig_active_reconstruction_msgs::ViewSpaceRequest::Response& res );
     
+    /*! Sends the views changed and removed since the version of the client's copy, or the complete viewspace if the client's copy is unknown.
+     */
+    bool viewspaceDeltaService( ig_active_reconstruction_msgs::ViewSpaceDelta::Request& req, ig_active_reconstruction_msgs::ViewSpaceDelta::Response& res );
+    
     bool viewsAdderService( ig_active_reconstruction_msgs::ViewSpaceUpdate::Request& req, ig_active_reconstruction_msgs::ViewSpaceUpdate::Response& res );
     
     bool viewsDeleterService( ig_active_reconstruction_msgs::DeleteViews::Request& req, ig_active_reconstruction_msgs::DeleteViews::Response& res );
@@ -80,6 +85,7 @@ namespace views
     boost::shared_ptr<CommunicationInterface> linked_interface_; //! Linked interface.
     
     ros::ServiceServer viewspace_service_;
+    ros::ServiceServer viewspace_delta_service_;
     ros::ServiceServer views_adder_service_;
     ros::ServiceServer views_deleter_service_;
   };
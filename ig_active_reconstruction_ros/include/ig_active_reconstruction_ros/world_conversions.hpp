@@ -19,6 +19,8 @@
 
 #include "ig_active_reconstruction_msgs/InformationGainRetrievalCommand.h"
 #include "ig_active_reconstruction_msgs/InformationGain.h"
+#include "ig_active_reconstruction_msgs/ViewspaceInformationGainCalculation.h"
+#include "ig_active_reconstruction_msgs/ViewspaceInformationGainAction.h"
 
 #include "ig_active_reconstruction/world_representation_communication_interface.hpp"
 
@@ -42,6 +44,24 @@ namespace ros_conversions
     world_representation::CommunicationInterface::IgRetrievalResult igRetrievalResultFromMsg(ig_active_reconstruction_msgs::InformationGain& msg);
     
     ig_active_reconstruction_msgs::InformationGain igRetrievalResultToMsg(world_representation::CommunicationInterface::IgRetrievalResult& msg);
+    
+    world_representation::CommunicationInterface::ViewspaceIgRetrievalCommand viewspaceIgRetrievalCommandFromMsg(ig_active_reconstruction_msgs::ViewspaceInformationGainCalculation::Request& request);
+    
+    world_representation::CommunicationInterface::ViewspaceIgRetrievalCommand viewspaceIgRetrievalCommandFromMsg(const ig_active_reconstruction_msgs::ViewspaceInformationGainGoal& goal);
+    
+    ig_active_reconstruction_msgs::ViewspaceInformationGainCalculation::Request viewspaceIgRetrievalCommandToMsg(world_representation::CommunicationInterface::ViewspaceIgRetrievalCommand& command);
+    
+    /*! Converts the flat N x M response into one result vector per view.
+     */
+    world_representation::CommunicationInterface::ViewspaceIgResult viewspaceIgResultFromMsg(ig_active_reconstruction_msgs::ViewspaceInformationGainCalculation::Response& msg);
+    
+    /*! Flattens the results of N views with M metrics each into the N x M response, missing results are reported as failed.
+     */
+    ig_active_reconstruction_msgs::ViewspaceInformationGainCalculation::Response viewspaceIgResultToMsg(world_representation::CommunicationInterface::ViewspaceIgResult& result, unsigned int number_of_metrics);
+    
+    /*! Flattens the (partial) results of an information gain job into the N x M action result, views that weren't computed are reported as failed.
+     */
+    ig_active_reconstruction_msgs::ViewspaceInformationGainResult viewspaceIgJobResultToMsg(world_representation::CommunicationInterface::ViewspaceIgResult& result, const std::vector<bool>& computed, unsigned int number_of_metrics);
 }
 
 }
\ No newline at end of file
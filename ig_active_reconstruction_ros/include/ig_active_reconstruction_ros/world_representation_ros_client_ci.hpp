@@ -18,8 +18,18 @@
 #pragma once
 
 
+#include <map>
+#include <mutex>
+#include <set>
+
 #include "ros/ros.h"
 #include "ig_active_reconstruction/world_representation_communication_interface.hpp"
+#include "ig_active_reconstruction_ros/service_client_pool.hpp"
+
+#include "ig_active_reconstruction_msgs/InformationGainCalculation.h"
+#include "ig_active_reconstruction_msgs/ViewspaceInformationGainCalculation.h"
+#include "ig_active_reconstruction_msgs/MapMetricCalculation.h"
+#include "ig_active_reconstruction_msgs/StringList.h"
 
 namespace ig_active_reconstruction
 {
@@ -28,14 +38,19 @@ namespace world_representation
 {
 
   /*! ROS client implementation of a world_representation::CommunicationInterface. Forwards calls over the ROS network via Server calls.
+   * 
+   * Each service is called through a pool of persistent clients, one per calling thread, such that parallel information gain
+   * requests don't serialise on one connection. Information gain names are resolved to their ids once (through "world/ig_list")
+   * and then sent as ids, sparing the server the string matching.
    */
   class RosClientCI: public CommunicationInterface
   {
   public:
     /*! Constructor
      * @param nh ROS node handle defines the namespace in which ROS communication will be carried out.
+     * @param pool_config Configuration of the service client pools.
      */
-    RosClientCI( ros::NodeHandle nh );
+    RosClientCI( ros::NodeHandle nh, ros_tools::ServiceClientPoolConfig pool_config = ros_tools::ServiceClientPoolConfig() );
     
     virtual ~RosClientCI(){};
     
@@ -45,6 +60,12 @@ namespace world_representation
      */
     virtual ResultInformation computeViewIg(IgRetrievalCommand& command, ViewIgResult& output_ig);
     
+    /*! Calculates a set of information gains for each of several views with a single service call.
+     * @param command Specifies which information gains have to be calculated and for which poses.
+     * @param output_ig (Output) One result vector per pose, in the order of the poses in the command.
+     */
+    virtual ResultInformation computeViewspaceIg(ViewspaceIgRetrievalCommand& command, ViewspaceIgResult& output_ig);
+    
     /*! Calculates a set of evaluation metrics on the complete map.
      * @param command Specifies which metrics shall be calculated.
      */
@@ -60,13 +81,34 @@ namespace world_representation
      */
     virtual void availableMapMetrics( std::vector<MetricInfo>& available_map_metrics );
     
+  protected:
+    /*! Resolves information gain names to their ids, using the cached list of available information gains. The cache is
+     * loaded on first use and reloaded once if a name is unknown. Names that are still unknown then fail immediately
+     * until the cache is invalidated.
+     * @param names Information gain names.
+     * @param ids (Output) Corresponding ids.
+     * @return False if not all names could be resolved.
+     */
+    bool igMetricIds( const std::vector<std::string>& names, std::vector<unsigned int>& ids );
+    
+    /*! Invalidates the cached information gain ids, e.g. after a failed call, since the server might have been restarted.
+     */
+    void invalidateIgMetricIds();
+    
   protected:
     ros::NodeHandle nh_;
     
-    ros::ServiceClient view_ig_computation_;
-    ros::ServiceClient map_metric_computation_;
-    ros::ServiceClient available_ig_receiver_;
-    ros::ServiceClient available_mm_receiver_;
+    ros_tools::ServiceClientPool<ig_active_reconstruction_msgs::InformationGainCalculation> view_ig_computation_;
+    ros_tools::ServiceClientPool<ig_active_reconstruction_msgs::ViewspaceInformationGainCalculation> viewspace_ig_computation_;
+    ros_tools::ServiceClientPool<ig_active_reconstruction_msgs::MapMetricCalculation> map_metric_computation_;
+    ros_tools::ServiceClientPool<ig_active_reconstruction_msgs::StringList> available_ig_receiver_;
+    ros_tools::ServiceClientPool<ig_active_reconstruction_msgs::StringList> available_mm_receiver_;
+    
+  private:
+    std::mutex ig_ids_mutex_; //! Protects the information gain id cache.
+    bool ig_ids_loaded_; //! Whether the id cache is loaded.
+    std::map<std::string,unsigned int> ig_ids_; //! Cached ids of the available information gains.
+    std::set<std::string> unknown_ig_names_; //! Names that couldn't be resolved, even after reloading the cache.
   };
   
   
@@ -0,0 +1,110 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#pragma once
+
+#include <boost/shared_ptr.hpp>
+
+#include "ros/ros.h"
+#include "ros/callback_queue.h"
+#include "actionlib/server/simple_action_server.h"
+#include "ig_active_reconstruction/world_representation_communication_interface.hpp"
+#include "ig_active_reconstruction/world_representation_ig_job.hpp"
+
+#include "ig_active_reconstruction_msgs/ViewspaceInformationGainAction.h"
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+
+  /*! Exposes asynchronous information gain computation for a set of views as ROS action ("world/ig_job"). Results are
+   * streamed as feedback for every computed view, cancelling the goal (or sending a new one) stops the computation and
+   * returns the results computed so far with the preempted result.
+   * 
+   * The job is driven by a ROS timer that computes one chunk of views per call. The timer and the goal and preempt
+   * callbacks of the action server are processed by a dedicated callback queue with a single spinner thread, thus the
+   * active job is never accessed concurrently and a cancellation takes effect after the chunk that is being computed.
+   * The node's own spinner keeps processing other callbacks (services of RosServerCI, pointcloud input) meanwhile, with a
+   * multi-threaded spinner these may call the linked interface concurrently with the job.
+   */
+  class RosIgActionServer
+  {
+  public:
+    typedef actionlib::SimpleActionServer<ig_active_reconstruction_msgs::ViewspaceInformationGainAction> ActionServer;
+    
+    struct Config
+    {
+    public:
+      Config();
+      
+    public:
+      unsigned int views_per_step; //! Number of views computed per timer call, feedback is published and cancellation takes effect at this granularity. Default: 4.
+      double step_period_s; //! Period of the timer that drives the computation [s]. Default: 0.001.
+    };
+    
+  public:
+    /*! Constructor
+     * @param nh ROS node handle defines the namespace in which ROS communication will be carried out.
+     * @param linked_interface Interface that computes the information gains.
+     * @param config Configuration.
+     */
+    RosIgActionServer( ros::NodeHandle nh, boost::shared_ptr<CommunicationInterface> linked_interface, Config config = Config() );
+    
+    virtual ~RosIgActionServer();
+    
+  protected:
+    /*! Accepts a new goal, a running goal is preempted with its partial results first.
+     */
+    void goalCallback();
+    
+    /*! Cancels the running goal and returns its partial results.
+     */
+    void preemptCallback();
+    
+    /*! Computes the next chunk of views of the active goal.
+     */
+    void stepCallback( const ros::TimerEvent& event );
+    
+    /*! Publishes the results of a single view as feedback.
+     */
+    void publishViewFeedback( size_t view_index, const CommunicationInterface::ViewIgResult& result );
+    
+    /*! Sets the final state of the active goal according to the status of the job and resets the job.
+     */
+    void finishGoal();
+    
+  protected:
+    ros::CallbackQueue job_queue_; //! Queue of the action server and timer callbacks.
+    ros::NodeHandle nh_; //! Uses job_queue_.
+    boost::shared_ptr<CommunicationInterface> linked_interface_; //! Linked interface.
+    Config config_;
+    
+    ActionServer action_server_;
+    ros::AsyncSpinner job_spinner_; //! Single thread that processes job_queue_.
+    ros::Timer step_timer_; //! Drives the active job.
+    
+    boost::shared_ptr<IgJob> job_; //! Job of the active goal, NULL if there's none. Only accessed from job_spinner_.
+    unsigned int number_of_metrics_; //! Number of metrics requested by the active goal.
+  };
+  
+}
+
+}
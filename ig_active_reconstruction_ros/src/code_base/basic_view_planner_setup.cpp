@@ -0,0 +1,288 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include <boost/thread/thread.hpp>
+#include <boost/chrono/include.hpp>
+#include <boost/make_shared.hpp>
+
+#include "ig_active_reconstruction_ros/basic_view_planner_setup.hpp"
+#include "ig_active_reconstruction_ros/param_loader.hpp"
+
+#include <ig_active_reconstruction/weighted_linear_utility.hpp>
+#include <ig_active_reconstruction/receding_horizon_utility.hpp>
+#include <ig_active_reconstruction/max_calls_termination_criteria.hpp>
+#include <ig_active_reconstruction/convergence_termination_criteria.hpp>
+#include <ig_active_reconstruction/robot_cost_cache_ci.hpp>
+
+namespace ig_active_reconstruction
+{
+  
+  boost::shared_ptr<BasicViewPlanner> loadBasicViewPlanner( boost::shared_ptr<robot::CommunicationInterface> robot_comm, boost::shared_ptr<views::CommunicationInterface> views_comm, boost::shared_ptr<world_representation::CommunicationInterface> world_comm, ros::NodeHandle nh )
+  {
+    namespace iar = ig_active_reconstruction;
+    
+    // load parameter configuration
+    // ...................................................................................................................
+    
+    // for the view planner:
+    iar::BasicViewPlanner::Config bvp_config;
+    ros_tools::getParam( bvp_config.discard_visited, "discard_visited", false, nh );
+    ros_tools::getParam( bvp_config.max_visits, "max_visits", -1, nh );
+    ros_tools::getParam( bvp_config.pipelined, "pipelined", false, nh );
+    ros_tools::getParam( bvp_config.rescore_radius, "rescore_radius", 1.0, nh );
+    ros_tools::getParam( bvp_config.nbv_time_budget_s, "nbv_time_budget", 0.0, nh ); // [s], <=0: unlimited
+    ros_tools::getParam( bvp_config.min_retry_backoff_s, "min_retry_backoff", 0.01, nh ); // [s]
+    ros_tools::getParam( bvp_config.max_retry_backoff_s, "max_retry_backoff", 1.0, nh ); // [s]
+    ros_tools::getParam( bvp_config.telemetry_trace_file, "telemetry_trace_file", std::string(""), nh ); // empty: no trace, *.json: JSON lines, CSV otherwise
+  
+    // for the utility calculator
+    std::string utility;
+    ros_tools::getParam( utility, "utility", std::string("weighted_linear"), nh ); // "weighted_linear" or "receding_horizon"
+    double cost_weight;
+    ros_tools::getParam( cost_weight, "cost_weight", 1.0, nh );
+    std::vector<std::string> ig_names;
+    std::vector<double> ig_weights;
+    ros_tools::getParamIfAvailableSilent( ig_names, "ig_names", nh );
+    ros_tools::getParamIfAvailableSilent( ig_weights, "ig_weights", nh );
+    unsigned int number_of_threads;
+    ros_tools::getParam<unsigned int, int>( number_of_threads, "number_of_threads", 0, nh ); // 0: use number of hardware threads
+    std::string selection_mode;
+    double ig_reference_scale, ig_upper_bound;
+    ros_tools::getParam( selection_mode, "selection_mode", std::string("exhaustive"), nh ); // "exhaustive" or "cost_bounded"
+    ros_tools::getParam( ig_reference_scale, "ig_reference_scale", 0.0, nh ); // <=0: normalize by total ig
+    ros_tools::getParam( ig_upper_bound, "ig_upper_bound", 0.0, nh );
+    std::string evaluation_order;
+    ros_tools::getParam( evaluation_order, "evaluation_order", std::string("tiered"), nh ); // "tiered", "optimistic_utility", "last_best_neighbourhood" or "random"
+    unsigned int ranking_size, score_reuse_max_staleness;
+    double score_reuse_radius;
+    ros_tools::getParam<unsigned int, int>( ranking_size, "ranking_size", 1, nh );
+    ros_tools::getParam<unsigned int, int>( score_reuse_max_staleness, "score_reuse_max_staleness", 0, nh ); // 0: recompute all information gains in each iteration
+    ros_tools::getParam( score_reuse_radius, "score_reuse_radius", 1.0, nh );
+    unsigned int ig_batch_size;
+    ros_tools::getParam<unsigned int, int>( ig_batch_size, "ig_batch_size", 0, nh ); // 0: one information gain call per view
+    iar::RecedingHorizonUtility::Config rhu_config;
+    ros_tools::getParam<unsigned int, int>( rhu_config.horizon, "horizon", 3, nh );
+    ros_tools::getParam<unsigned int, int>( rhu_config.beam_width, "beam_width", 5, nh );
+    ros_tools::getParam( rhu_config.discount, "horizon_discount", 0.8, nh );
+    ros_tools::getParam( rhu_config.use_path_ig, "use_path_ig", false, nh );
+    rhu_config.cost_weight = cost_weight;
+  
+    // for the movement cost cache
+    bool cache_costs;
+    iar::robot::CostCacheCI::Config cost_cache_config;
+    ros_tools::getParam( cache_costs, "cache_movement_costs", false, nh );
+    ros_tools::getParam( cost_cache_config.symmetric, "cost_cache_symmetric", false, nh );
+    ros_tools::getParam<size_t, int>( cost_cache_config.max_entries, "cost_cache_max_entries", 0, nh );
+  
+    // for the termination critera
+    std::string termination;
+    ros_tools::getParam( termination, "termination", std::string("max_calls"), nh ); // "max_calls" or "convergence"
+    unsigned int max_calls;
+    ros_tools::getParam<unsigned int, int>( max_calls, "max_calls", 20, nh );
+    iar::ConvergenceTerminationCriteria::Config convergence_config;
+    ros_tools::getParam( convergence_config.entropy_metric_name, "convergence/entropy_metric", std::string("TotalEntropy"), nh );
+    ros_tools::getParam( convergence_config.unknown_metric_name, "convergence/unknown_metric", std::string("UnknownVoxelCount"), nh );
+    ros_tools::getParam<unsigned int, int>( convergence_config.window_size, "convergence/window_size", 3, nh );
+    ros_tools::getParam( convergence_config.min_entropy_decrease, "convergence/min_entropy_decrease", 0.01, nh );
+    ros_tools::getParam( convergence_config.min_unknown_decrease, "convergence/min_unknown_decrease", 0.01, nh );
+    ros_tools::getParam( convergence_config.min_best_view_ig, "convergence/min_best_view_ig", 0.05, nh );
+    convergence_config.max_calls = max_calls;
+  
+  
+    // the view planner
+    // ...................................................................................................................
+    boost::shared_ptr<iar::BasicViewPlanner> view_planner = boost::make_shared<iar::BasicViewPlanner>(bvp_config);
+  
+  
+    // the movement cost cache is shared by planner and utility calculator, such that movement costs between views are only requested once
+    // ...................................................................................................................
+    if( cache_costs )
+      robot_comm = boost::make_shared<iar::robot::CostCacheCI>(robot_comm,cost_cache_config);
+  
+    view_planner->setRobotCommUnit(robot_comm);
+    view_planner->setViewsCommUnit(views_comm);
+    view_planner->setWorldCommUnit(world_comm);
+  
+  
+    // either plan tours with the receding horizon utility...
+    // ...................................................................................................................
+    if( utility=="receding_horizon" )
+    {
+      boost::shared_ptr<iar::RecedingHorizonUtility> utility_calculator = boost::make_shared<iar::RecedingHorizonUtility>(rhu_config,number_of_threads);
+      utility_calculator->setRobotCommUnit(robot_comm);
+      utility_calculator->setWorldCommUnit(world_comm);
+      utility_calculator->setRankingSize(ranking_size);
+    
+      for(unsigned int i=0;i<ig_names.size() && i<ig_weights.size(); ++i)
+      {
+	std::cout<<"\nUsing information gain '"<<ig_names[i]<<"' with weight '"<<ig_weights[i]<<"'.";
+	utility_calculator->useInformationGain(ig_names[i],ig_weights[i]);
+      }
+    
+      view_planner->setUtility(utility_calculator);
+    }
+    else
+    {
+      // ...or use the weighted linear utility calculator, which directly interacts with world and robot comms too
+      // ...................................................................................................................
+      boost::shared_ptr<iar::WeightedLinearUtility> utility_calculator = boost::make_shared<iar::WeightedLinearUtility>(cost_weight,number_of_threads);
+      utility_calculator->setRobotCommUnit(robot_comm);
+      utility_calculator->setWorldCommUnit(world_comm);
+      utility_calculator->setIgReferenceScale(ig_reference_scale);
+      utility_calculator->setIgUpperBound(ig_upper_bound);
+      if( selection_mode=="cost_bounded" )
+	utility_calculator->setSelectionMode(iar::WeightedLinearUtility::SelectionMode::COST_BOUNDED);
+      else if( selection_mode!="exhaustive" )
+	ROS_WARN_STREAM("Unknown selection_mode '"<<selection_mode<<"', using 'exhaustive'. Valid values are 'exhaustive' and 'cost_bounded'.");
+      if( evaluation_order=="optimistic_utility" )
+	utility_calculator->setEvaluationOrder(iar::WeightedLinearUtility::EvaluationOrder::OPTIMISTIC_UTILITY);
+      else if( evaluation_order=="last_best_neighbourhood" )
+	utility_calculator->setEvaluationOrder(iar::WeightedLinearUtility::EvaluationOrder::LAST_BEST_NEIGHBOURHOOD);
+      else if( evaluation_order=="random" )
+	utility_calculator->setEvaluationOrder(iar::WeightedLinearUtility::EvaluationOrder::RANDOM);
+      else if( evaluation_order!="tiered" )
+	ROS_WARN_STREAM("Unknown evaluation_order '"<<evaluation_order<<"', using 'tiered'. Valid values are 'tiered', 'optimistic_utility', 'last_best_neighbourhood' and 'random'.");
+      utility_calculator->setRankingSize(ranking_size);
+      utility_calculator->setScoreReuse(score_reuse_max_staleness,score_reuse_radius);
+      utility_calculator->setIgBatchSize(ig_batch_size);
+    
+      for(unsigned int i=0;i<ig_names.size() && i<ig_weights.size(); ++i)
+      {
+	std::cout<<"\nUsing information gain '"<<ig_names[i]<<"' with weight '"<<ig_weights[i]<<"'.";
+	utility_calculator->useInformationGain(ig_names[i],ig_weights[i]);
+      }
+    
+      view_planner->setUtility(utility_calculator);
+    }
+  
+  
+    // either stop once the map metrics and information gains converged, or use a simple max. number of calls termination critera
+    // ...................................................................................................................
+    boost::shared_ptr<iar::GoalEvaluationModule> termination_criteria;
+    if( termination=="convergence" )
+      termination_criteria = boost::make_shared<iar::ConvergenceTerminationCriteria>(world_comm,convergence_config);
+    else
+      termination_criteria = boost::make_shared<iar::MaxCallsTerminationCriteria>(max_calls);
+  
+    view_planner->setGoalEvaluationModule(termination_criteria);
+  
+    return view_planner;
+  }
+  
+  void runBasicViewPlannerUi( BasicViewPlanner& view_planner )
+  {
+    bool keepReading = true;
+    std::function<void()> status_readout = [&view_planner, &keepReading]()
+    {    
+      while(keepReading)
+      {
+	BasicViewPlanner::Status status = view_planner.status();
+      
+	switch(status)
+	{
+	case BasicViewPlanner::Status::UNINITIALIZED:
+	  ROS_INFO_STREAM("BasicViewPlanner::Status::UNINITIALIZED");
+	  break;
+	case BasicViewPlanner::Status::IDLE:
+	  ROS_INFO_STREAM("BasicViewPlanner::Status::IDLE");
+	  break;
+	case BasicViewPlanner::Status::PAUSED:
+	  ROS_INFO_STREAM("BasicViewPlanner::Status::PAUSED");
+	  break;
+	case BasicViewPlanner::Status::DEMANDING_NEW_DATA:
+	  ROS_INFO_STREAM("BasicViewPlanner::Status::DEMANDING_NEW_DATA");
+	  break;
+	case BasicViewPlanner::Status::DEMANDING_VIEWSPACE:
+	  ROS_INFO_STREAM("BasicViewPlanner::Status::DEMANDING_VIEWSPACE");
+	  break;
+	case BasicViewPlanner::Status::NBV_CALCULATIONS:
+	  ROS_INFO_STREAM("BasicViewPlanner::Status::NBV_CALCULATIONS");
+	  break;
+	case BasicViewPlanner::Status::DEMANDING_MOVE:
+	  ROS_INFO_STREAM("BasicViewPlanner::Status::DEMANDING_MOVE");
+	  break;
+	};
+	boost::this_thread::sleep_for( boost::chrono::seconds(2) );
+      }
+    }; 
+  
+    std::thread status_reading_thread(status_readout);
+  
+    std::string gui_info = "\n\n\nBASIC VIEW PLANNER SIMPLE UI\n********************************\nThe following actions are supported ('key toggle'):\n- 'g' (go) Start or unpause view planning.\n- 'p': (pause) Pause procedure.\n- 's' (stop) Stop procedure\n- 'q' (quit) Stop procedure and quit program.\n\n";
+    char user_input;
+  
+    bool quit = false;
+    while(!quit)
+    {
+      std::cout<<gui_info;
+      std::cin>>user_input;
+    
+      switch(user_input)
+      {
+	case 'g':
+	std::cout<<"Starting...";
+	view_planner.run();
+	break;
+	case 'p':
+	std::cout<<"Pausing...";
+	view_planner.pause();
+	break;
+	case 's':
+	while(true)
+	{
+	  std::cout<<"\n\nAre you sure you want to stop the procedure? (y/n)\n";
+	  std::cin>>user_input;
+	  if(user_input=='y')
+	  {
+	    std::cout<<"Stopping...";
+	    view_planner.stop();
+	    break;
+	  }
+	  else if(user_input=='n')
+	    break;
+	};
+	
+	break;
+	case 'q':
+	while(true)
+	{
+	  std::cout<<"\n\nAre you sure you want to quit the program? (y/n)\n";
+	  std::cin>>user_input;
+	  if(user_input=='y')
+	  {
+	    std::cout<<"Quitting...";
+	    view_planner.stop();
+	    quit = true;
+	    break;
+	  }
+	  else if(user_input=='n')
+	    break;
+	};
+	
+	break;
+      };
+    }
+    
+    keepReading = false;
+    status_reading_thread.join();
+  }
+  
+}
@@ -0,0 +1,71 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+#include "ig_active_reconstruction_ros/pointcloud2_view.hpp"
+
+namespace ros_tools
+{
+  
+  PointCloud2View::PointCloud2View()
+  : height(0)
+  , width(0)
+  , is_bigendian(false)
+  , point_step(0)
+  , row_step(0)
+  , is_dense(false)
+  , data(NULL)
+  , data_size(0)
+  {
+    
+  }
+  
+  PointCloud2View::PointCloud2View( const sensor_msgs::PointCloud2& cloud )
+  : header(cloud.header)
+  , height(cloud.height)
+  , width(cloud.width)
+  , fields(cloud.fields)
+  , is_bigendian(cloud.is_bigendian)
+  , point_step(cloud.point_step)
+  , row_step(cloud.row_step)
+  , is_dense(cloud.is_dense)
+  , data( cloud.data.empty()?NULL:&cloud.data[0] )
+  , data_size(cloud.data.size())
+  {
+    
+  }
+  
+  const sensor_msgs::PointField* PointCloud2View::field( const std::string& name ) const
+  {
+    for( size_t i=0; i<fields.size(); ++i )
+    {
+      if( fields[i].name==name )
+	return &fields[i];
+    }
+    return NULL;
+  }
+  
+  size_t PointCloud2View::size() const
+  {
+    return static_cast<size_t>(height)*width;
+  }
+  
+  const uint8_t* PointCloud2View::point( uint32_t row, uint32_t column ) const
+  {
+    return data + static_cast<size_t>(row)*row_step + static_cast<size_t>(column)*point_step;
+  }
+  
+}
@@ -0,0 +1,242 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+#include "ig_active_reconstruction_ros/pointcloud_shm_ring.hpp"
+
+#include <cstring>
+#include <new>
+
+#include <boost/interprocess/sync/interprocess_mutex.hpp>
+#include <boost/interprocess/sync/scoped_lock.hpp>
+
+namespace ros_tools
+{
+  
+  namespace bip = boost::interprocess;
+  
+  //! Layout of the beginning of the segment.
+  struct PointCloudShmRing::SegmentHeader
+  {
+    static const uint32_t MAGIC = 0x50434c52; //! Marks a fully initialized segment.
+    
+    uint32_t magic;
+    uint32_t number_of_slots;
+    uint64_t slot_size_bytes;
+    uint64_t slot_stride_bytes; //! Distance between the starts of two slots, including the slot header.
+    bip::interprocess_mutex mutex; //! Protects next_sequence.
+    uint64_t next_sequence;
+  };
+  
+  //! Layout of the beginning of a slot, followed by the point data.
+  struct PointCloudShmRing::SlotHeader
+  {
+    static const unsigned int MAX_FIELDS = 16;
+    static const unsigned int MAX_NAME_LENGTH = 64;
+    static const unsigned int MAX_FRAME_ID_LENGTH = 256;
+    
+    struct Field
+    {
+      char name[MAX_NAME_LENGTH];
+      uint32_t offset;
+      uint8_t datatype;
+      uint32_t count;
+    };
+    
+    bip::interprocess_mutex mutex; //! Locked while the slot is written or read.
+    uint64_t sequence; //! Sequence number of the cloud held, zero if none.
+    
+    uint32_t seq;
+    uint32_t stamp_sec;
+    uint32_t stamp_nsec;
+    char frame_id[MAX_FRAME_ID_LENGTH];
+    
+    uint32_t height;
+    uint32_t width;
+    uint32_t number_of_fields;
+    Field fields[MAX_FIELDS];
+    uint8_t is_bigendian;
+    uint32_t point_step;
+    uint32_t row_step;
+    uint8_t is_dense;
+    uint64_t data_size;
+  };
+  
+  //! Rounds up to a multiple of the alignment of the slot data.
+  static size_t aligned( size_t size )
+  {
+    const size_t alignment = 64;
+    return (size+alignment-1)/alignment*alignment;
+  }
+  
+  PointCloudShmRing::Config::Config()
+  : segment_name("iar_pointcloud_ring")
+  , number_of_slots(4)
+  , slot_size_bytes(32*1024*1024)
+  {
+    
+  }
+  
+  PointCloudShmRing::PointCloudShmRing( Config config, Role::Enum role )
+  : config_(config)
+  , role_(role)
+  , header_(NULL)
+  {
+    if( role_==Role::WRITER )
+    {
+      bip::shared_memory_object::remove( config_.segment_name.c_str() );
+      segment_ = bip::shared_memory_object( bip::create_only, config_.segment_name.c_str(), bip::read_write );
+      
+      size_t slot_stride = aligned(sizeof(SlotHeader)) + aligned(config_.slot_size_bytes);
+      segment_.truncate( aligned(sizeof(SegmentHeader)) + config_.number_of_slots*slot_stride );
+      region_ = bip::mapped_region( segment_, bip::read_write );
+      
+      header_ = new (region_.get_address()) SegmentHeader;
+      header_->number_of_slots = config_.number_of_slots;
+      header_->slot_size_bytes = config_.slot_size_bytes;
+      header_->slot_stride_bytes = slot_stride;
+      header_->next_sequence = 1;
+      for( unsigned int i=0; i<config_.number_of_slots; ++i )
+      {
+	SlotHeader* new_slot = new (slot(i)) SlotHeader;
+	new_slot->sequence = 0;
+      }
+      header_->magic = SegmentHeader::MAGIC;
+    }
+    else
+    {
+      segment_ = bip::shared_memory_object( bip::open_only, config_.segment_name.c_str(), bip::read_write );
+      region_ = bip::mapped_region( segment_, bip::read_write );
+      
+      header_ = static_cast<SegmentHeader*>( region_.get_address() );
+      if( region_.get_size()<sizeof(SegmentHeader) || header_->magic!=SegmentHeader::MAGIC )
+	throw bip::interprocess_exception( ("PointCloudShmRing: The shared memory segment '"+config_.segment_name+"' isn't initialized.").c_str() );
+      
+      config_.number_of_slots = header_->number_of_slots;
+      config_.slot_size_bytes = header_->slot_size_bytes;
+    }
+  }
+  
+  PointCloudShmRing::~PointCloudShmRing()
+  {
+    if( role_==Role::WRITER )
+      bip::shared_memory_object::remove( config_.segment_name.c_str() );
+  }
+  
+  bool PointCloudShmRing::write( const sensor_msgs::PointCloud2& cloud, uint64_t& sequence )
+  {
+    if( cloud.data.size()>config_.slot_size_bytes || cloud.fields.size()>SlotHeader::MAX_FIELDS || cloud.header.frame_id.size()>=SlotHeader::MAX_FRAME_ID_LENGTH )
+      return false;
+    for( size_t i=0; i<cloud.fields.size(); ++i )
+    {
+      if( cloud.fields[i].name.size()>=SlotHeader::MAX_NAME_LENGTH )
+	return false;
+    }
+    
+    {
+      bip::scoped_lock<bip::interprocess_mutex> lock(header_->mutex);
+      sequence = header_->next_sequence++;
+    }
+    
+    unsigned int index = sequence%config_.number_of_slots;
+    SlotHeader* target = slot(index);
+    
+    bip::scoped_lock<bip::interprocess_mutex> lock(target->mutex);
+    
+    target->seq = cloud.header.seq;
+    target->stamp_sec = cloud.header.stamp.sec;
+    target->stamp_nsec = cloud.header.stamp.nsec;
+    std::strcpy( target->frame_id, cloud.header.frame_id.c_str() );
+    
+    target->height = cloud.height;
+    target->width = cloud.width;
+    target->number_of_fields = cloud.fields.size();
+    for( size_t i=0; i<cloud.fields.size(); ++i )
+    {
+      std::strcpy( target->fields[i].name, cloud.fields[i].name.c_str() );
+      target->fields[i].offset = cloud.fields[i].offset;
+      target->fields[i].datatype = cloud.fields[i].datatype;
+      target->fields[i].count = cloud.fields[i].count;
+    }
+    target->is_bigendian = cloud.is_bigendian;
+    target->point_step = cloud.point_step;
+    target->row_step = cloud.row_step;
+    target->is_dense = cloud.is_dense;
+    target->data_size = cloud.data.size();
+    
+    if( !cloud.data.empty() )
+      std::memcpy( slotData(index), &cloud.data[0], cloud.data.size() );
+    
+    target->sequence = sequence;
+    return true;
+  }
+  
+  bool PointCloudShmRing::read( uint64_t sequence, boost::function<void(const PointCloud2View&)> reader )
+  {
+    if( sequence==0 )
+      return false;
+    
+    unsigned int index = sequence%config_.number_of_slots;
+    SlotHeader* source = slot(index);
+    
+    bip::scoped_lock<bip::interprocess_mutex> lock(source->mutex);
+    if( source->sequence!=sequence )
+      return false;
+    
+    PointCloud2View view;
+    view.header.seq = source->seq;
+    view.header.stamp.sec = source->stamp_sec;
+    view.header.stamp.nsec = source->stamp_nsec;
+    view.header.frame_id = source->frame_id;
+    
+    view.height = source->height;
+    view.width = source->width;
+    view.fields.resize(source->number_of_fields);
+    for( uint32_t i=0; i<source->number_of_fields; ++i )
+    {
+      view.fields[i].name = source->fields[i].name;
+      view.fields[i].offset = source->fields[i].offset;
+      view.fields[i].datatype = source->fields[i].datatype;
+      view.fields[i].count = source->fields[i].count;
+    }
+    view.is_bigendian = source->is_bigendian;
+    view.point_step = source->point_step;
+    view.row_step = source->row_step;
+    view.is_dense = source->is_dense;
+    view.data = slotData(index);
+    view.data_size = source->data_size;
+    
+    reader(view);
+    return true;
+  }
+  
+  const std::string& PointCloudShmRing::segmentName() const
+  {
+    return config_.segment_name;
+  }
+  
+  PointCloudShmRing::SlotHeader* PointCloudShmRing::slot( unsigned int index )
+  {
+    uint8_t* base = static_cast<uint8_t*>( region_.get_address() ) + aligned(sizeof(SegmentHeader));
+    return reinterpret_cast<SlotHeader*>( base + index*header_->slot_stride_bytes );
+  }
+  
+  uint8_t* PointCloudShmRing::slotData( unsigned int index )
+  {
+    return reinterpret_cast<uint8_t*>( slot(index) ) + aligned(sizeof(SlotHeader));
+  }
+  
+}
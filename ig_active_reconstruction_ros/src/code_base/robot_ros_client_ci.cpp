@@ -21,11 +21,6 @@
 #include "ig_active_reconstruction_ros/robot_conversions.hpp"
 #include "ig_active_reconstruction_ros/views_conversions.hpp"
 
-#include "ig_active_reconstruction_msgs/ViewRequest.h"
-#include "ig_active_reconstruction_msgs/RetrieveData.h"
-#include "ig_active_reconstruction_msgs/MovementCostCalculation.h"
-#include "ig_active_reconstruction_msgs/MoveToOrder.h"
-
 
 namespace ig_active_reconstruction
 {
@@ -33,13 +28,22 @@ namespace ig_active_reconstruction
 namespace robot
 {
   
-  RosClientCI::RosClientCI( ros::NodeHandle nh_sub )
+  //! Returns the passed configuration without retries, for calls that mustn't be repeated.
+  static ros_tools::ServiceClientPoolConfig nonRepeating( ros_tools::ServiceClientPoolConfig config )
+  {
+    config.max_retries = 0;
+    return config;
+  }
+  
+  RosClientCI::RosClientCI( ros::NodeHandle nh_sub, ros_tools::ServiceClientPoolConfig pool_config )
   : nh_sub_(nh_sub)
+  , current_view_retriever_(nh_sub,"robot/current_view",pool_config)
+  , data_retriever_(nh_sub,"robot/retrieve_data",nonRepeating(pool_config))
+  , cost_retriever_(nh_sub,"robot/movement_cost",pool_config)
+  , batch_cost_retriever_(nh_sub,"robot/movement_costs",pool_config)
+  , robot_mover_(nh_sub,"robot/move_to",nonRepeating(pool_config))
   {
-    current_view_retriever_ = nh_sub_.serviceClient<ig_active_reconstruction_msgs::ViewRequest>("robot/current_view");
-    data_retriever_ = nh_sub_.serviceClient<ig_active_reconstruction_msgs::RetrieveData>("robot/retrieve_data");
-    cost_retriever_ = nh_sub_.serviceClient<ig_active_reconstruction_msgs::MovementCostCalculation>("robot/movement_cost");
-    robot_mover_ = nh_sub_.serviceClient<ig_active_reconstruction_msgs::MoveToOrder>("robot/move_to");
+    
   }
   
   views::View RosClientCI::getCurrentView()
@@ -111,6 +115,39 @@ namespace robot
     return cost;
   }
   
+  void RosClientCI::movementCosts( views::View& start_view, std::vector<views::View, Eigen::aligned_allocator<views::View> >& target_views, std::vector<MovementCost>& costs, bool fill_additional_information )
+  {
+    ig_active_reconstruction_msgs::MovementCostsCalculation request;
+    
+    request.request.start_view = ros_conversions::viewToMsg(start_view);
+    request.request.target_views.reserve( target_views.size() );
+    for( views::View& target_view: target_views )
+    {
+      request.request.target_views.push_back( ros_conversions::viewToMsg(target_view) );
+    }
+    request.request.additional_information = fill_additional_information;
+    
+    
+    ROS_DEBUG_STREAM("Retrieving movement costs for "<<target_views.size()<<" views");
+    bool response = batch_cost_retriever_.call(request);
+    
+    costs.clear();
+    costs.reserve( target_views.size() );
+    if( response && request.response.movement_costs.size()==target_views.size() )
+    {
+      for( ig_active_reconstruction_msgs::MovementCostMsg& cost_msg: request.response.movement_costs )
+      {
+	costs.push_back( ros_conversions::movementCostFromMsg(cost_msg) );
+      }
+    }
+    else
+    {
+      MovementCost failed;
+      failed.exception = MovementCost::Exception::RECEPTION_FAILED;
+      costs.resize( target_views.size(), failed );
+    }
+  }
+  
   bool RosClientCI::moveTo( views::View& target_view )
   {
     ig_active_reconstruction_msgs::MoveToOrder request;
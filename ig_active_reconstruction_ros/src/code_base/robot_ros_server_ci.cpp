@@ -17,6 +17,8 @@
 
 #include <stdexcept>
 
+#include <boost/smart_ptr.hpp>
+
 #include "ig_active_reconstruction_ros/robot_ros_server_ci.hpp"
 #include "ig_active_reconstruction_ros/robot_conversions.hpp"
 #include "ig_active_reconstruction_ros/views_conversions.hpp"
@@ -32,13 +34,26 @@ namespace robot
   RosServerCI::RosServerCI( ros::NodeHandle nh, boost::shared_ptr<CommunicationInterface> linked_interface )
   : nh_(nh)
   , linked_interface_(linked_interface)
+  , thread_pool_( boost::make_shared<ThreadPool>() )
   {
     current_view_service_ = nh_.advertiseService("robot/current_view", &RosServerCI::currentViewService, this );
     data_service_ = nh_.advertiseService("robot/retrieve_data", &RosServerCI::retrieveDataService, this );
     cost_service_ = nh_.advertiseService("robot/movement_cost", &RosServerCI::movementCostService, this );
+    batch_cost_service_ = nh_.advertiseService("robot/movement_costs", &RosServerCI::movementCostsService, this );
     robot_moving_service_ = nh_.advertiseService("robot/move_to", &RosServerCI::moveToService, this );
   }
   
+  void RosServerCI::setLinkedInterface( boost::shared_ptr<CommunicationInterface> linked_interface )
+  {
+    linked_interface_ = linked_interface;
+  }
+  
+  void RosServerCI::setThreadPool( boost::shared_ptr<ThreadPool> thread_pool )
+  {
+    if( thread_pool!=nullptr )
+      thread_pool_ = thread_pool;
+  }
+  
   views::View RosServerCI::getCurrentView()
   {
     if( linked_interface_ == nullptr )
@@ -71,6 +86,14 @@ namespace robot
     return linked_interface_->movementCost( start_view, target_view, fill_additional_information  );
   }
   
+  void RosServerCI::movementCosts( views::View& start_view, std::vector<views::View, Eigen::aligned_allocator<views::View> >& target_views, std::vector<MovementCost>& costs, bool fill_additional_information )
+  {
+    if( linked_interface_ == nullptr )
+      throw std::runtime_error("robot::RosServerCI::Interface not linked.");
+    
+    linked_interface_->movementCosts( start_view, target_views, costs, fill_additional_information );
+  }
+  
   bool RosServerCI::moveTo( views::View& target_view )
   {
     if( linked_interface_ == nullptr )
@@ -132,6 +155,38 @@ namespace robot
     return true;
   }
   
+  bool RosServerCI::movementCostsService( ig_active_reconstruction_msgs::MovementCostsCalculation::Request& req, ig_active_reconstruction_msgs::MovementCostsCalculation::Response& res )
+  {
+    ROS_DEBUG_STREAM("Received 'movement costs' call for "<<req.target_views.size()<<" views.");
+    std::vector<MovementCost> costs( req.target_views.size() );
+    
+    if( linked_interface_ == nullptr )
+    {
+      for( MovementCost& cost: costs )
+      {
+	cost.exception = MovementCost::Exception::RECEPTION_FAILED;
+      }
+    }
+    else
+    {
+      views::View start_view = ros_conversions::viewFromMsg(req.start_view);
+      bool fill_additional_info = req.additional_information;
+      
+      thread_pool_->parallelFor( req.target_views.size(), [&](size_t i)
+      {
+	views::View target_view = ros_conversions::viewFromMsg(req.target_views[i]);
+	costs[i] = linked_interface_->movementCost( start_view, target_view, fill_additional_info );
+      });
+    }
+    
+    res.movement_costs.reserve( costs.size() );
+    for( MovementCost& cost: costs )
+    {
+      res.movement_costs.push_back( ros_conversions::movementCostToMsg(cost) );
+    }
+    return true;
+  }
+  
   bool RosServerCI::moveToService( ig_active_reconstruction_msgs::MoveToOrder::Request& req, ig_active_reconstruction_msgs::MoveToOrder::Response& res )
   {
     ROS_INFO("Received 'move to position' call.");
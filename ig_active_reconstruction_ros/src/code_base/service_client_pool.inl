@@ -0,0 +1,111 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+#define TEMPT template<class SERVICE>
+#define CSCOPE ServiceClientPool<SERVICE>
+
+#include <boost/make_shared.hpp>
+
+namespace ros_tools
+{
+  TEMPT
+  CSCOPE::ServiceClientPool( ros::NodeHandle nh, std::string service_name, Config config )
+  : nh_(nh)
+  , service_name_(service_name)
+  , config_(config)
+  {
+    
+  }
+  
+  TEMPT
+  bool CSCOPE::call( SERVICE& service )
+  {
+    // the shared pointer keeps the client alive even if the pool is flushed meanwhile
+    boost::shared_ptr<ros::ServiceClient> client = threadClient();
+    
+    // the connection of a persistent client was closed
+    if( !client->isValid() )
+      client = reconnect();
+    
+    if( client->call(service) )
+      return true;
+    
+    for( unsigned int retry=0; retry<config_.max_retries; ++retry )
+    {
+      ROS_WARN_STREAM("Call of service '"<<service_name_<<"' failed, reconnecting.");
+      client = reconnect();
+      if( client->call(service) )
+	return true;
+    }
+    return false;
+  }
+  
+  TEMPT
+  size_t CSCOPE::size()
+  {
+    std::lock_guard<std::mutex> lock(clients_mutex_);
+    return clients_.size();
+  }
+  
+  TEMPT
+  const std::string& CSCOPE::serviceName() const
+  {
+    return service_name_;
+  }
+  
+  TEMPT
+  boost::shared_ptr<ros::ServiceClient> CSCOPE::threadClient()
+  {
+    std::thread::id thread_id = std::this_thread::get_id();
+    {
+      std::lock_guard<std::mutex> lock(clients_mutex_);
+      typename std::map< std::thread::id, boost::shared_ptr<ros::ServiceClient> >::iterator it = clients_.find(thread_id);
+      if( it!=clients_.end() )
+	return it->second;
+    }
+    
+    // connecting might block, hence outside of the lock
+    boost::shared_ptr<ros::ServiceClient> client = createClient();
+    
+    std::lock_guard<std::mutex> lock(clients_mutex_);
+    if( clients_.size()>=config_.max_clients )
+      clients_.clear();
+    clients_[thread_id] = client;
+    return client;
+  }
+  
+  TEMPT
+  boost::shared_ptr<ros::ServiceClient> CSCOPE::reconnect()
+  {
+    boost::shared_ptr<ros::ServiceClient> client = createClient();
+    client->waitForExistence( ros::Duration(config_.reconnect_timeout_s) );
+    
+    std::lock_guard<std::mutex> lock(clients_mutex_);
+    clients_[std::this_thread::get_id()] = client;
+    return client;
+  }
+  
+  TEMPT
+  boost::shared_ptr<ros::ServiceClient> CSCOPE::createClient()
+  {
+    return boost::make_shared<ros::ServiceClient>( nh_.serviceClient<SERVICE>(service_name_,config_.persistent) );
+  }
+  
+}
+
+#undef CSCOPE
+#undef TEMPT
@@ -31,6 +31,7 @@ namespace ros_conversions
     msg.pose = movements::toROS( view.pose() );
     msg.source_frame = view.sourceFrame();
     msg.is_bad = view.bad();
+    msg.non_viewspace = view.nonViewSpace();
     msg.visited = view.timesVisited();
     msg.is_reachable = view.reachable();
     msg.associated_names = view.additionalFieldsNames();
@@ -46,6 +47,7 @@ namespace ros_conversions
     view.sourceFrame() = msg.source_frame;
     view.reachable() = msg.is_reachable;
     view.bad() = msg.is_bad;
+    view.nonViewSpace() = msg.non_viewspace;
     view.timesVisited() = msg.visited;
     view.additionalFieldsNames() = msg.associated_names;
     view.additionalFieldsValues() = msg.associated_values;
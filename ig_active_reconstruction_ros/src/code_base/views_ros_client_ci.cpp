@@ -22,6 +22,7 @@
 
 #include "ig_active_reconstruction_msgs/DeleteViews.h"
 #include "ig_active_reconstruction_msgs/ViewSpaceRequest.h"
+#include "ig_active_reconstruction_msgs/ViewSpaceDelta.h"
 #include "ig_active_reconstruction_msgs/ViewSpaceUpdate.h"
 
 
@@ -33,21 +34,51 @@ namespace views
   
   RosClientCI::RosClientCI( ros::NodeHandle nh )
   : nh_(nh)
+  , synced_instance_(0)
+  , synced_version_(0)
   {
     planning_space_receiver_ = nh.serviceClient<ig_active_reconstruction_msgs::ViewSpaceRequest>("views/space");
+    planning_space_delta_receiver_ = nh.serviceClient<ig_active_reconstruction_msgs::ViewSpaceDelta>("views/space_delta");
     views_adder_ = nh.serviceClient<ig_active_reconstruction_msgs::ViewSpaceUpdate>("views/add");
     views_deleter_ = nh.serviceClient<ig_active_reconstruction_msgs::DeleteViews>("views/delete");
   }
   
   const ViewSpace& RosClientCI::getViewSpace()
   {
+    ig_active_reconstruction_msgs::ViewSpaceDelta delta_call;
+    delta_call.request.instance = synced_instance_;
+    delta_call.request.since_version = synced_version_;
+    
+    ROS_INFO("Demanding viewspace changes.");
+    if( planning_space_delta_receiver_.call(delta_call) )
+    {
+      if( delta_call.response.full )
+	viewspace_ = ViewSpace();
+      
+      for( ig_active_reconstruction_msgs::ViewMsg& view_msg: delta_call.response.changed_views )
+      {
+	viewspace_.push_back( ros_conversions::viewFromMsg(view_msg) );
+      }
+      for( uint64_t& id: delta_call.response.removed_ids )
+      {
+	viewspace_.deleteView(id);
+      }
+      synced_instance_ = delta_call.response.instance;
+      synced_version_ = delta_call.response.version;
+      
+      return viewspace_;
+    }
+    
     ig_active_reconstruction_msgs::ViewSpaceRequest call;
     
     ROS_INFO("Demanding viewspace.");
     bool response = planning_space_receiver_.call(call);
     
     if( response )
+    {
       viewspace_ = ros_conversions::viewSpaceFromMsg(call.response.viewspace);
+      synced_instance_ = 0;
+    }
     
     return viewspace_;
   }
@@ -32,6 +32,7 @@ namespace views
   , linked_interface_(linked_interface)
   {
     viewspace_service_ = nh.advertiseService("views/space", &RosServerCI::viewspaceService, this );
+    viewspace_delta_service_ = nh.advertiseService("views/space_delta", &RosServerCI::viewspaceDeltaService, this );
     views_adder_service_ = nh.advertiseService("views/add", &RosServerCI::viewsAdderService, this );
     views_deleter_service_ = nh.advertiseService("views/delete", &RosServerCI::viewsDeleterService, this );
   }
@@ -96,6 +97,50 @@ namespace views
     return true;
   }
   
+  bool RosServerCI::viewspaceDeltaService( ig_active_reconstruction_msgs::ViewSpaceDelta::Request& req, ig_active_reconstruction_msgs::ViewSpaceDelta::Response& res )
+  {
+    ROS_INFO("Received 'viewspace delta' call.");
+    if( linked_interface_ == nullptr )
+    {
+      ViewSpaceStatus status = ViewSpaceStatus::BAD;
+      res.viewspace_status = ros_conversions::viewSpaceStatusToMsg(status);
+      res.full = true;
+      return true;
+    }
+    
+    const ViewSpace& viewspace = linked_interface_->getViewSpace();
+    
+    res.instance = viewspace.instance();
+    res.version = viewspace.version();
+    // the client's copy stems from another viewspace (or none at all), or from a version the server doesn't know about
+    res.full = req.instance!=viewspace.instance() || req.since_version>viewspace.version();
+    
+    if( res.full )
+    {
+      for( View const & view: viewspace )
+      {
+	res.changed_views.push_back( ros_conversions::viewToMsg(view) );
+      }
+    }
+    else
+    {
+      std::vector<View, Eigen::aligned_allocator<View> > changed_views;
+      ViewSpace::IdSet removed_ids;
+      viewspace.changesSince(req.since_version,changed_views,removed_ids);
+      
+      for( View& view: changed_views )
+      {
+	res.changed_views.push_back( ros_conversions::viewToMsg(view) );
+      }
+      res.removed_ids.assign( removed_ids.begin(), removed_ids.end() );
+    }
+    
+    ViewSpaceStatus status = ViewSpaceStatus::OK;
+    res.viewspace_status = ros_conversions::viewSpaceStatusToMsg(status);
+    
+    return true;
+  }
+  
   bool RosServerCI::viewsAdderService( ig_active_reconstruction_msgs::ViewSpaceUpdate::Request& req, ig_active_reconstruction_msgs::ViewSpaceUpdate::Response& res )
   {
     ROS_INFO("Received 'add view(s)' call.");
@@ -141,6 +141,110 @@ namespace ros_conversions
     
     return msg;
   }
+  
+  world_representation::CommunicationInterface::ViewspaceIgRetrievalCommand viewspaceIgRetrievalCommandFromMsg(ig_active_reconstruction_msgs::ViewspaceInformationGainCalculation::Request& request)
+  {
+    world_representation::CommunicationInterface::ViewspaceIgRetrievalCommand command;
+    
+    command.poses.reserve( request.poses.size() );
+    BOOST_FOREACH( geometry_msgs::Pose& pose, request.poses )
+    {
+      command.poses.push_back( movements::fromROS(pose) );
+    }
+    command.metric_names = request.metric_names;
+    command.metric_ids.assign( request.metric_ids.begin(), request.metric_ids.end() );
+    command.config = igRetrievalConfigFromMsg(request.config);
+    
+    return command;
+  }
+  
+  world_representation::CommunicationInterface::ViewspaceIgRetrievalCommand viewspaceIgRetrievalCommandFromMsg(const ig_active_reconstruction_msgs::ViewspaceInformationGainGoal& goal)
+  {
+    world_representation::CommunicationInterface::ViewspaceIgRetrievalCommand command;
+    
+    command.poses.reserve( goal.poses.size() );
+    BOOST_FOREACH( const geometry_msgs::Pose& pose, goal.poses )
+    {
+      command.poses.push_back( movements::fromROS(pose) );
+    }
+    command.metric_names = goal.metric_names;
+    command.metric_ids.assign( goal.metric_ids.begin(), goal.metric_ids.end() );
+    ig_active_reconstruction_msgs::InformationGainRetrievalConfig config = goal.config;
+    command.config = igRetrievalConfigFromMsg(config);
+    
+    return command;
+  }
+  
+  ig_active_reconstruction_msgs::ViewspaceInformationGainCalculation::Request viewspaceIgRetrievalCommandToMsg(world_representation::CommunicationInterface::ViewspaceIgRetrievalCommand& command)
+  {
+    ig_active_reconstruction_msgs::ViewspaceInformationGainCalculation::Request request;
+    
+    request.poses.reserve( command.poses.size() );
+    BOOST_FOREACH( movements::Pose& pose, command.poses )
+    {
+      request.poses.push_back( movements::toROS(pose) );
+    }
+    request.metric_names = command.metric_names;
+    request.metric_ids.assign( command.metric_ids.begin(), command.metric_ids.end() );
+    request.config = igRetrievalConfigToMsg(command.config);
+    
+    return request;
+  }
+  
+  world_representation::CommunicationInterface::ViewspaceIgResult viewspaceIgResultFromMsg(ig_active_reconstruction_msgs::ViewspaceInformationGainCalculation::Response& msg)
+  {
+    world_representation::CommunicationInterface::ViewspaceIgResult result;
+    
+    size_t number_of_metrics = msg.number_of_metrics;
+    if( number_of_metrics==0 || msg.status.size()!=msg.expected_information.size() )
+      return result;
+    
+    size_t number_of_views = msg.expected_information.size()/number_of_metrics;
+    result.resize(number_of_views);
+    for( size_t n=0; n<number_of_views; ++n )
+    {
+      result[n].resize(number_of_metrics);
+      for( size_t m=0; m<number_of_metrics; ++m )
+      {
+	result[n][m].status = resultInformationFromMsg( msg.status[n*number_of_metrics+m] );
+	result[n][m].predicted_gain = msg.expected_information[n*number_of_metrics+m];
+      }
+    }
+    return result;
+  }
+  
+  ig_active_reconstruction_msgs::ViewspaceInformationGainCalculation::Response viewspaceIgResultToMsg(world_representation::CommunicationInterface::ViewspaceIgResult& result, unsigned int number_of_metrics)
+  {
+    ig_active_reconstruction_msgs::ViewspaceInformationGainCalculation::Response msg;
+    
+    world_representation::CommunicationInterface::ResultInformation failed = world_representation::CommunicationInterface::ResultInformation::FAILED;
+    int failed_status = resultInformationToMsg(failed);
+    
+    msg.number_of_metrics = number_of_metrics;
+    msg.expected_information.assign( result.size()*number_of_metrics, 0 );
+    msg.status.assign( result.size()*number_of_metrics, failed_status );
+    for( size_t n=0; n<result.size(); ++n )
+    {
+      for( size_t m=0; m<number_of_metrics && m<result[n].size(); ++m )
+      {
+	msg.expected_information[n*number_of_metrics+m] = result[n][m].predicted_gain;
+	msg.status[n*number_of_metrics+m] = resultInformationToMsg( result[n][m].status );
+      }
+    }
+    return msg;
+  }
+  
+  ig_active_reconstruction_msgs::ViewspaceInformationGainResult viewspaceIgJobResultToMsg(world_representation::CommunicationInterface::ViewspaceIgResult& result, const std::vector<bool>& computed, unsigned int number_of_metrics)
+  {
+    ig_active_reconstruction_msgs::ViewspaceInformationGainCalculation::Response flat = viewspaceIgResultToMsg(result,number_of_metrics);
+    
+    ig_active_reconstruction_msgs::ViewspaceInformationGainResult msg;
+    msg.number_of_metrics = flat.number_of_metrics;
+    msg.expected_information.swap(flat.expected_information);
+    msg.status.swap(flat.status);
+    msg.computed.assign( computed.begin(), computed.end() );
+    return msg;
+  }
 }
 
 }
\ No newline at end of file
@@ -20,10 +20,6 @@
 #include "ig_active_reconstruction_ros/world_representation_ros_client_ci.hpp"
 #include "ig_active_reconstruction_ros/world_conversions.hpp"
 
-#include "ig_active_reconstruction_msgs/InformationGainCalculation.h"
-#include "ig_active_reconstruction_msgs/MapMetricCalculation.h"
-#include "ig_active_reconstruction_msgs/StringList.h"
-
 
 namespace ig_active_reconstruction
 {
@@ -31,13 +27,16 @@ namespace ig_active_reconstruction
 namespace world_representation
 {
   
-  RosClientCI::RosClientCI( ros::NodeHandle nh )
+  RosClientCI::RosClientCI( ros::NodeHandle nh, ros_tools::ServiceClientPoolConfig pool_config )
   : nh_(nh)
+  , view_ig_computation_(nh,"world/information_gain",pool_config)
+  , viewspace_ig_computation_(nh,"world/viewspace_information_gain",pool_config)
+  , map_metric_computation_(nh,"world/map_metric",pool_config)
+  , available_ig_receiver_(nh,"world/ig_list",pool_config)
+  , available_mm_receiver_(nh,"world/mm_list",pool_config)
+  , ig_ids_loaded_(false)
   {
-    view_ig_computation_ = nh.serviceClient<ig_active_reconstruction_msgs::InformationGainCalculation>("world/information_gain");
-    map_metric_computation_ = nh.serviceClient<ig_active_reconstruction_msgs::MapMetricCalculation>("world/map_metric");
-    available_ig_receiver_ = nh.serviceClient<ig_active_reconstruction_msgs::StringList>("world/ig_list");
-    available_mm_receiver_ = nh.serviceClient<ig_active_reconstruction_msgs::StringList>("world/mm_list");
+    
   }
   
   RosClientCI::ResultInformation RosClientCI::computeViewIg(IgRetrievalCommand& command, ViewIgResult& output_ig)
@@ -45,11 +44,20 @@ namespace world_representation
     ig_active_reconstruction_msgs::InformationGainCalculation call;
     call.request.command = ros_conversions::igRetrievalCommandToMsg(command);
     
+    std::vector<unsigned int> ids;
+    if( command.metric_ids.empty() && igMetricIds(command.metric_names,ids) )
+    {
+      call.request.command.metric_ids.assign(ids.begin(),ids.end());
+      call.request.command.metric_names.clear();
+    }
+    
     ROS_INFO("Demanding information gain.");
     bool response = view_ig_computation_.call(call);
     
     if(!response)
     {
+      invalidateIgMetricIds();
+      
       unsigned int number_of_metrics = (!command.metric_ids.empty())?command.metric_ids.size():command.metric_names.size();
       IgRetrievalResult failed;
       failed.status = ResultInformation::FAILED;
@@ -72,6 +80,39 @@ namespace world_representation
     }
   }
   
+  RosClientCI::ResultInformation RosClientCI::computeViewspaceIg(ViewspaceIgRetrievalCommand& command, ViewspaceIgResult& output_ig)
+  {
+    ig_active_reconstruction_msgs::ViewspaceInformationGainCalculation call;
+    call.request = ros_conversions::viewspaceIgRetrievalCommandToMsg(command);
+    
+    std::vector<unsigned int> ids;
+    if( command.metric_ids.empty() && igMetricIds(command.metric_names,ids) )
+    {
+      call.request.metric_ids.assign(ids.begin(),ids.end());
+      call.request.metric_names.clear();
+    }
+    
+    ROS_INFO_STREAM("Demanding information gains of "<<command.poses.size()<<" views.");
+    bool response = viewspace_ig_computation_.call(call);
+    
+    if(response)
+      output_ig = ros_conversions::viewspaceIgResultFromMsg(call.response);
+    
+    if(!response || output_ig.size()!=command.poses.size())
+    {
+      invalidateIgMetricIds();
+      
+      unsigned int number_of_metrics = (!command.metric_ids.empty())?command.metric_ids.size():command.metric_names.size();
+      IgRetrievalResult failed;
+      failed.status = ResultInformation::FAILED;
+      failed.predicted_gain = 0;
+      
+      output_ig.assign( command.poses.size(), ViewIgResult(number_of_metrics,failed) );
+      return ResultInformation::FAILED;
+    }
+    return ResultInformation::SUCCEEDED;
+  }
+  
   RosClientCI::ResultInformation RosClientCI::computeMapMetric(MapMetricRetrievalCommand& command, MapMetricRetrievalResultSet& output)
   {
     ig_active_reconstruction_msgs::MapMetricCalculation call;
@@ -146,6 +187,68 @@ namespace world_representation
     }
   }
   
+  bool RosClientCI::igMetricIds( const std::vector<std::string>& names, std::vector<unsigned int>& ids )
+  {
+    if( names.empty() )
+      return false;
+    
+    std::lock_guard<std::mutex> lock(ig_ids_mutex_);
+    
+    for( const std::string& name: names ) // known to be unavailable until the cache is invalidated
+    {
+      if( unknown_ig_names_.count(name)!=0 )
+	return false;
+    }
+    
+    bool reloaded = false;
+    for(;;)
+    {
+      if( !ig_ids_loaded_ )
+      {
+	std::vector<MetricInfo> available_ig_metrics;
+	availableIgMetrics(available_ig_metrics);
+	
+	ig_ids_.clear();
+	for( MetricInfo& metric: available_ig_metrics )
+	{
+	  ig_ids_[metric.name] = metric.id;
+	}
+	ig_ids_loaded_ = !ig_ids_.empty();
+	reloaded = true;
+      }
+      
+      ids.clear();
+      for( const std::string& name: names )
+      {
+	std::map<std::string,unsigned int>::iterator it = ig_ids_.find(name);
+	if( it==ig_ids_.end() )
+	  break;
+	ids.push_back(it->second);
+      }
+      if( ids.size()==names.size() )
+	return true;
+      if( reloaded || !ig_ids_loaded_ )
+	break;
+      
+      ig_ids_loaded_ = false; // the server might offer new information gains by now
+    }
+    
+    // such names are sent as they are from now on, without reloading the list on each call
+    for( const std::string& name: names )
+    {
+      if( ig_ids_.count(name)==0 )
+	unknown_ig_names_.insert(name);
+    }
+    return false;
+  }
+  
+  void RosClientCI::invalidateIgMetricIds()
+  {
+    std::lock_guard<std::mutex> lock(ig_ids_mutex_);
+    ig_ids_loaded_ = false;
+    unknown_ig_names_.clear();
+  }
+  
 }
 
 }
\ No newline at end of file
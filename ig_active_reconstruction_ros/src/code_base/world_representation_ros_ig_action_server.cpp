@@ -0,0 +1,167 @@
+/* Copyright (c) 2016, Stefan Isler, islerstefan@bluewin.ch
+ * (ETH Zurich / Robotics and Perception Group, University of Zurich, Switzerland)
+ *
+ * This file is part of ig_active_reconstruction, software for information gain based, active reconstruction.
+ *
+ * ig_active_reconstruction is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Lesser General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+ * ig_active_reconstruction is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the
+ * GNU Lesser General Public License for more details.
+ * Please refer to the GNU Lesser General Public License for details on the license,
+ * on <http://www.gnu.org/licenses/>.
+*/
+
+
+
+#include "ig_active_reconstruction_ros/world_representation_ros_ig_action_server.hpp"
+
+#include <boost/bind.hpp>
+#include <boost/make_shared.hpp>
+
+#include "ig_active_reconstruction_ros/world_conversions.hpp"
+
+
+namespace ig_active_reconstruction
+{
+  
+namespace world_representation
+{
+  
+  namespace
+  {
+    ros::NodeHandle withCallbackQueue( ros::NodeHandle nh, ros::CallbackQueue* queue )
+    {
+      nh.setCallbackQueue(queue);
+      return nh;
+    }
+  }
+  
+  RosIgActionServer::Config::Config()
+  : views_per_step(4)
+  , step_period_s(0.001)
+  {
+    
+  }
+  
+  RosIgActionServer::RosIgActionServer( ros::NodeHandle nh, boost::shared_ptr<CommunicationInterface> linked_interface, Config config )
+  : nh_( withCallbackQueue(nh,&job_queue_) )
+  , linked_interface_(linked_interface)
+  , config_(config)
+  , action_server_(nh_,"world/ig_job",false)
+  , job_spinner_(1,&job_queue_)
+  , number_of_metrics_(0)
+  {
+    action_server_.registerGoalCallback( boost::bind(&RosIgActionServer::goalCallback,this) );
+    action_server_.registerPreemptCallback( boost::bind(&RosIgActionServer::preemptCallback,this) );
+    step_timer_ = nh_.createTimer( ros::Duration(config_.step_period_s), &RosIgActionServer::stepCallback, this, false, false );
+    action_server_.start();
+    job_spinner_.start();
+  }
+  
+  RosIgActionServer::~RosIgActionServer()
+  {
+    job_spinner_.stop();
+    step_timer_.stop();
+    action_server_.shutdown();
+  }
+  
+  void RosIgActionServer::goalCallback()
+  {
+    if( job_ )
+    {
+      job_->cancel();
+      job_->step();
+      finishGoal();
+    }
+    
+    ActionServer::GoalConstPtr goal = action_server_.acceptNewGoal();
+    if( !goal )
+      return;
+    
+    if( action_server_.isPreemptRequested() )
+    {
+      action_server_.setPreempted();
+      return;
+    }
+    
+    ROS_INFO_STREAM("Received 'ig job' goal for "<<goal->poses.size()<<" views.");
+    number_of_metrics_ = (!goal->metric_ids.empty())?goal->metric_ids.size():goal->metric_names.size();
+    
+    job_ = boost::make_shared<IgJob>( linked_interface_, ros_conversions::viewspaceIgRetrievalCommandFromMsg(*goal), config_.views_per_step );
+    job_->setViewCallback( boost::bind(&RosIgActionServer::publishViewFeedback,this,_1,_2) );
+    step_timer_.start();
+  }
+  
+  void RosIgActionServer::preemptCallback()
+  {
+    if( !job_ )
+      return;
+    
+    ROS_INFO_STREAM("'ig job' goal cancelled after "<<job_->numberOfComputedViews()<<" of "<<job_->numberOfViews()<<" views.");
+    job_->cancel();
+    job_->step();
+    finishGoal();
+  }
+  
+  void RosIgActionServer::stepCallback( const ros::TimerEvent& event )
+  {
+    if( !job_ )
+    {
+      step_timer_.stop();
+      return;
+    }
+    
+    if( !job_->step() )
+      finishGoal();
+  }
+  
+  void RosIgActionServer::publishViewFeedback( size_t view_index, const CommunicationInterface::ViewIgResult& result )
+  {
+    ig_active_reconstruction_msgs::ViewspaceInformationGainFeedback feedback;
+    feedback.view_index = view_index;
+    feedback.number_of_computed_views = job_->numberOfComputedViews();
+    
+    CommunicationInterface::ResultInformation failed = CommunicationInterface::ResultInformation::FAILED;
+    feedback.expected_information.assign( number_of_metrics_, 0 );
+    feedback.status.assign( number_of_metrics_, ros_conversions::resultInformationToMsg(failed) );
+    for( size_t m=0; m<number_of_metrics_ && m<result.size(); ++m )
+    {
+      CommunicationInterface::ResultInformation status = result[m].status;
+      feedback.expected_information[m] = result[m].predicted_gain;
+      feedback.status[m] = ros_conversions::resultInformationToMsg(status);
+    }
+    action_server_.publishFeedback(feedback);
+  }
+  
+  void RosIgActionServer::finishGoal()
+  {
+    step_timer_.stop();
+    job_->wait();
+    
+    CommunicationInterface::ViewspaceIgResult output_ig;
+    std::vector<bool> computed;
+    job_->results(output_ig,computed);
+    ig_active_reconstruction_msgs::ViewspaceInformationGainResult result = ros_conversions::viewspaceIgJobResultToMsg(output_ig,computed,number_of_metrics_);
+    
+    switch( job_->status() )
+    {
+      case IgJob::Status::SUCCEEDED:
+	action_server_.setSucceeded(result);
+	break;
+      case IgJob::Status::CANCELLED:
+	action_server_.setPreempted(result);
+	break;
+      default:
+	action_server_.setAborted(result,"The world representation failed to compute the information gains.");
+	break;
+    }
+    job_.reset();
+  }
+  
+}
+
+}
@@ -36,6 +36,7 @@ namespace world_representation
   , linked_interface_(linked_interface)
   {
     view_ig_computation_ = nh.advertiseService("world/information_gain", &CSCOPE::igComputationService, this );
+    viewspace_ig_computation_ = nh.advertiseService("world/viewspace_information_gain", &CSCOPE::viewspaceIgComputationService, this );
     map_metric_computation_ = nh.advertiseService("world/map_metric", &CSCOPE::mmComputationService, this );
     available_ig_receiver_ = nh.advertiseService("world/ig_list", &CSCOPE::availableIgService, this );
     available_mm_receiver_ = nh.advertiseService("world/mm_list", &CSCOPE::availableMmService, this );
@@ -50,6 +51,15 @@ namespace world_representation
     return linked_interface_->computeViewIg(command, output_ig);
   }
   
+  TEMPT
+  typename CSCOPE::ResultInformation CSCOPE::computeViewspaceIg(ViewspaceIgRetrievalCommand& command, ViewspaceIgResult& output_ig)
+  {
+    if( linked_interface_ == NULL )
+      throw std::runtime_error("world_representation::CSCOPE::Interface not linked.");
+    
+    return linked_interface_->computeViewspaceIg(command, output_ig);
+  }
+  
   TEMPT
   typename CSCOPE::ResultInformation CSCOPE::computeMapMetric(MapMetricRetrievalCommand& command, MapMetricRetrievalResultSet& output)
   {
@@ -106,6 +116,24 @@ namespace world_representation
     return true;
   }
   
+  TEMPT
+  bool CSCOPE::viewspaceIgComputationService( ig_active_reconstruction_msgs::ViewspaceInformationGainCalculation::Request& req, ig_active_reconstruction_msgs::ViewspaceInformationGainCalculation::Response& res )
+  {
+    ROS_INFO_STREAM("Received 'viewspace ig computation' call for "<<req.poses.size()<<" views.");
+    unsigned int number_of_metrics = (!req.metric_ids.empty())?req.metric_ids.size():req.metric_names.size();
+    
+    ViewspaceIgResult result;
+    if( linked_interface_ != NULL )
+    {
+      ViewspaceIgRetrievalCommand command = ros_conversions::viewspaceIgRetrievalCommandFromMsg(req);
+      linked_interface_->computeViewspaceIg(command,result);
+    }
+    result.resize( req.poses.size() ); // views without result are reported as failed
+    
+    res = ros_conversions::viewspaceIgResultToMsg(result,number_of_metrics);
+    return true;
+  }
+  
   TEMPT
   bool CSCOPE::mmComputationService( ig_active_reconstruction_msgs::MapMetricCalculation::Request& req, ig_active_reconstruction_msgs::MapMetricCalculation::Response& res )
   {